@@ -0,0 +1,759 @@
+#include "SyntheticData.hpp"
+#include "crud-wrapper/ColumnKernels.hpp"
+#include "crud-wrapper/CrudWrapperPool.hpp"
+#include "crud-wrapper/ShardedCrud.hpp"
+#include "crud-wrapper/WriteQueue.hpp"
+
+#include "benchmark/benchmark.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+/// @brief namespace for CrudWrapper benchmarks
+namespace sql_with_cpp_benchmark {
+/// @brief a city of the world database, read through its RowMapping
+struct City {
+  std::int64_t id{0};
+  std::string name;
+  std::string countryCode;
+  std::string district;
+  std::int64_t population{0};
+};
+} // namespace sql_with_cpp_benchmark
+
+/// @brief mapping of cities to the City table
+template <> struct sql_with_cpp::RowMapping<sql_with_cpp_benchmark::City> {
+  using City = sql_with_cpp_benchmark::City;
+  static constexpr std::string_view kTable{"City"};
+  static constexpr std::tuple kFields{
+      Field<City, std::int64_t>{"ID", &City::id},
+      Field<City, std::string>{"Name", &City::name},
+      Field<City, std::string>{"CountryCode", &City::countryCode},
+      Field<City, std::string>{"District", &City::district},
+      Field<City, std::int64_t>{"Population", &City::population}};
+};
+
+/// @brief namespace for CrudWrapper benchmarks
+namespace sql_with_cpp_benchmark {
+using namespace ::sql_with_cpp;
+
+/// @brief anonymous namespace for needed constants in thus TU
+namespace {
+/// @brief path to the world database
+const std::string kworldDbPath{kprojectRootPath + "/db/world.db"};
+
+/// @brief a typed row of the City table
+using CityRow = std::tuple<std::int64_t, std::string, std::string,
+                           std::string, std::int64_t>;
+
+/// @brief function to mark the processed rows and bytes of a benchmark
+/// @param state the benchmark state
+/// @param rowsPerIteration number of rows processed per iteration
+void setRowsProcessed(benchmark::State &state, std::size_t rowsPerIteration) {
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(rowsPerIteration));
+}
+
+} // namespace
+
+/// @brief cost of opening a database connection
+void BM_OpenDatabase(benchmark::State &state) {
+  for (auto _ : state) {
+    CrudWrapper const db{kworldDbPath};
+    benchmark::DoNotOptimize(&db);
+  }
+}
+BENCHMARK(BM_OpenDatabase);
+
+/// @brief cost of preparing a statement, where the argument enables (1) or
+///        disables (0) the statement cache
+void BM_PrepareStatement(benchmark::State &state) {
+  CrudWrapper db{kworldDbPath};
+  db.setStatementCacheCapacity(state.range(0) == 0 ? 0U : 64U);
+
+  for (auto _ : state) {
+    auto const statement{db.prepareStatement(
+        "SELECT Name, Population FROM City WHERE CountryCode = ? AND "
+        "Population > ? ORDER BY Population DESC")};
+    benchmark::DoNotOptimize(statement.get().get());
+  }
+
+  state.SetLabel(state.range(0) == 0 ? "uncached" : "cached");
+}
+BENCHMARK(BM_PrepareStatement)->Arg(0)->Arg(1);
+
+/// @brief point lookups of cities by their primary key
+void BM_PointLookupById(benchmark::State &state) {
+  CrudWrapper const db{kworldDbPath};
+  std::int64_t id{0};
+
+  for (auto _ : state) {
+    auto statement{
+        db.prepareStatement("SELECT Name, Population FROM City WHERE ID = ?")};
+    statement.bind(id % 4079 + 1, 1U);
+    auto const rows{db.getRowsAs<std::tuple<std::string, std::int64_t>>(
+        statement)};
+    benchmark::DoNotOptimize(rows.data());
+    ++id;
+  }
+}
+BENCHMARK(BM_PointLookupById);
+
+/// @brief point lookups of cities by their primary key, where the argument
+///        attaches (1) or doesn't attach (0) a statement profiler
+void BM_ProfiledPointLookupById(benchmark::State &state) {
+  CrudWrapper db{kworldDbPath};
+  if (state.range(0) != 0) {
+    db.setProfiler(std::make_shared<StatementProfiler>());
+  }
+  std::int64_t id{0};
+
+  for (auto _ : state) {
+    auto statement{
+        db.prepareStatement("SELECT Name, Population FROM City WHERE ID = ?")};
+    statement.bind(id % 4079 + 1, 1U);
+    auto const rows{db.getRowsAs<std::tuple<std::string, std::int64_t>>(
+        statement)};
+    benchmark::DoNotOptimize(rows.data());
+    ++id;
+  }
+
+  state.SetLabel(state.range(0) == 0 ? "unprofiled" : "profiled");
+}
+BENCHMARK(BM_ProfiledPointLookupById)->Arg(0)->Arg(1);
+
+/// @brief full scan of world.db's City table materialized as strings
+void BM_FullScanGetRows(benchmark::State &state) {
+  CrudWrapper const db{kworldDbPath};
+  std::size_t rowsCount{0U};
+
+  for (auto _ : state) {
+    auto const rows{db.getRows("City")};
+    rowsCount = rows.size() - 1U;
+    benchmark::DoNotOptimize(rows.data());
+  }
+
+  setRowsProcessed(state, rowsCount);
+}
+BENCHMARK(BM_FullScanGetRows);
+
+/// @brief full scan of world.db's City table materialized as typed rows
+void BM_FullScanGetRowsAs(benchmark::State &state) {
+  CrudWrapper const db{kworldDbPath};
+  std::size_t rowsCount{0U};
+
+  for (auto _ : state) {
+    auto const rows{db.getRowsAs<CityRow>("City")};
+    rowsCount = rows.size();
+    benchmark::DoNotOptimize(rows.data());
+  }
+
+  setRowsProcessed(state, rowsCount);
+}
+BENCHMARK(BM_FullScanGetRowsAs);
+
+/// @brief full scan of world.db's City table materialized into an arena
+///        backed result set
+void BM_FullScanGetResultSet(benchmark::State &state) {
+  CrudWrapper const db{kworldDbPath};
+  std::size_t rowsCount{0U};
+
+  for (auto _ : state) {
+    auto const resultSet{db.getResultSet("City")};
+    rowsCount = resultSet.rowsCount();
+    benchmark::DoNotOptimize(resultSet.row(0U).data());
+  }
+
+  setRowsProcessed(state, rowsCount);
+}
+BENCHMARK(BM_FullScanGetResultSet);
+
+/// @brief full scan of world.db's City table streamed without materializing
+void BM_FullScanQuery(benchmark::State &state) {
+  CrudWrapper const db{kworldDbPath};
+  std::size_t rowsCount{0U};
+
+  for (auto _ : state) {
+    std::int64_t totalPopulation{0};
+    rowsCount = 0U;
+    for (auto const row : db.query("SELECT * FROM City")) {
+      totalPopulation += row.get<std::int64_t>(4U);
+      ++rowsCount;
+    }
+    benchmark::DoNotOptimize(totalPopulation);
+  }
+
+  setRowsProcessed(state, rowsCount);
+}
+BENCHMARK(BM_FullScanQuery);
+
+/// @brief full scans of synthetic City tables scaled to the argument rows,
+///        materialized as strings
+void BM_SyntheticScanGetRows(benchmark::State &state) {
+  auto const rowsCount{static_cast<std::size_t>(state.range(0))};
+  CrudWrapper const db{syntheticCityDatabase(rowsCount)};
+
+  for (auto _ : state) {
+    auto const rows{db.getRows("City")};
+    benchmark::DoNotOptimize(rows.data());
+  }
+
+  setRowsProcessed(state, rowsCount);
+}
+BENCHMARK(BM_SyntheticScanGetRows)
+    ->Arg(100'000)
+    ->Arg(1'000'000)
+    ->Unit(benchmark::kMillisecond);
+
+/// @brief full scans of synthetic City tables scaled to the argument rows,
+///        streamed without materializing
+void BM_SyntheticScanQuery(benchmark::State &state) {
+  auto const rowsCount{static_cast<std::size_t>(state.range(0))};
+  CrudWrapper const db{syntheticCityDatabase(rowsCount)};
+
+  for (auto _ : state) {
+    std::int64_t totalPopulation{0};
+    for (auto const row : db.query("SELECT Population FROM City")) {
+      totalPopulation += row.get<std::int64_t>(0U);
+    }
+    benchmark::DoNotOptimize(totalPopulation);
+  }
+
+  setRowsProcessed(state, rowsCount);
+}
+BENCHMARK(BM_SyntheticScanQuery)
+    ->Arg(100'000)
+    ->Arg(1'000'000)
+    ->Unit(benchmark::kMillisecond);
+
+/// @brief full scans of synthetic City tables scaled to the argument rows,
+///        materialized into arena backed result sets
+void BM_SyntheticScanGetResultSet(benchmark::State &state) {
+  auto const rowsCount{static_cast<std::size_t>(state.range(0))};
+  CrudWrapper const db{syntheticCityDatabase(rowsCount)};
+
+  for (auto _ : state) {
+    auto const resultSet{db.getResultSet("City")};
+    benchmark::DoNotOptimize(resultSet.row(0U).data());
+  }
+
+  setRowsProcessed(state, rowsCount);
+}
+BENCHMARK(BM_SyntheticScanGetResultSet)
+    ->Arg(100'000)
+    ->Arg(1'000'000)
+    ->Unit(benchmark::kMillisecond);
+
+/// @brief bulk inserts of the argument number of synthetic rows into an empty
+///        table, committed in batches of 1000 rows
+void BM_BulkInsert(benchmark::State &state) {
+  auto const rowsCount{static_cast<std::size_t>(state.range(0))};
+
+  std::vector<CityRow> rows;
+  rows.reserve(rowsCount);
+  for (std::size_t i{0U}; i < rowsCount; ++i) {
+    rows.emplace_back(static_cast<std::int64_t>(i + 1U), "Synthetic City",
+                      "SYN", "Synthetic District",
+                      static_cast<std::int64_t>(i % 1000U));
+  }
+
+  CrudWrapper db{makeEmptyDatabase("crud-wrapper-benchmark-insert.db")};
+  db.executeStatements(
+      "CREATE TABLE City (ID INTEGER PRIMARY KEY, Name TEXT, "
+      "CountryCode TEXT, District TEXT, Population INTEGER);");
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    db.executeStatements("DELETE FROM City;");
+    state.ResumeTiming();
+
+    if (!db.bulkInsert("City", {}, rows)) {
+      state.SkipWithError("bulk insert failed");
+      break;
+    }
+  }
+
+  setRowsProcessed(state, rowsCount);
+}
+BENCHMARK(BM_BulkInsert)->Arg(1'000)->Arg(100'000)->Unit(
+    benchmark::kMillisecond);
+
+/// @brief materialization of an already stepped result, comparing string
+///        rows (0) with typed rows (1) for the same numeric-heavy query
+void BM_MaterializeNumericColumns(benchmark::State &state) {
+  CrudWrapper const db{kworldDbPath};
+  auto const statement{std::string{
+      "SELECT Population, SurfaceArea, LifeExpectancy, GNP FROM Country "
+      "WHERE LifeExpectancy IS NOT NULL"}};
+
+  for (auto _ : state) {
+    if (state.range(0) == 0) {
+      auto const rows{db.getRows(db.prepareStatement(statement))};
+      benchmark::DoNotOptimize(rows.data());
+    } else {
+      auto const rows{db.getRowsAs<
+          std::tuple<std::int64_t, double, double, double>>(
+          db.prepareStatement(statement))};
+      benchmark::DoNotOptimize(rows.data());
+    }
+  }
+
+  state.SetLabel(state.range(0) == 0 ? "strings" : "typed");
+}
+BENCHMARK(BM_MaterializeNumericColumns)->Arg(0)->Arg(1);
+
+/// @brief column-wise aggregation of a synthetic City table, comparing
+///        string rows (0) with a columnar batch (1)
+void BM_SumPopulationColumn(benchmark::State &state) {
+  constexpr std::size_t rowsCount{100'000U};
+  CrudWrapper const db{syntheticCityDatabase(rowsCount)};
+
+  for (auto _ : state) {
+    std::int64_t totalPopulation{0};
+    if (state.range(0) == 0) {
+      auto const rows{db.getRows("City")};
+      for (std::size_t i{1U}; i < rows.size(); ++i) {
+        totalPopulation += std::stoll(rows[i][4]);
+      }
+    } else {
+      auto const batch{db.getColumns("City", {"Population"})};
+      for (auto const population : batch.column(0U).integers()) {
+        totalPopulation += population;
+      }
+    }
+    benchmark::DoNotOptimize(totalPopulation);
+  }
+
+  setRowsProcessed(state, rowsCount);
+  state.SetLabel(state.range(0) == 0 ? "strings" : "columnar");
+}
+BENCHMARK(BM_SumPopulationColumn)
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMillisecond);
+
+/// @brief aggregation kernel over a fetched Integer column, comparing the
+///        scalar (0) and AVX2 (1) instruction sets
+void BM_AggregateColumnKernel(benchmark::State &state) {
+  constexpr std::size_t rowsCount{100'000U};
+  CrudWrapper const db{syntheticCityDatabase(rowsCount)};
+  auto const batch{db.getColumns("City", {"Population"})};
+  auto const isa{state.range(0) == 0 ? KernelIsa::Scalar : KernelIsa::Avx2};
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(aggregate<std::int64_t>(batch.column(0U), isa));
+  }
+
+  setRowsProcessed(state, rowsCount);
+  state.SetLabel(state.range(0) == 0 ? "scalar" : "avx2");
+}
+BENCHMARK(BM_AggregateColumnKernel)->Arg(0)->Arg(1);
+
+/// @brief filter kernel over a fetched Integer column, comparing the scalar
+///        (0) and AVX2 (1) instruction sets
+void BM_FilterColumnKernel(benchmark::State &state) {
+  constexpr std::size_t rowsCount{100'000U};
+  CrudWrapper const db{syntheticCityDatabase(rowsCount)};
+  auto const batch{db.getColumns("City", {"Population"})};
+  auto const isa{state.range(0) == 0 ? KernelIsa::Scalar : KernelIsa::Avx2};
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(filter<std::int64_t>(
+        batch.column(0U), Comparison::Greater, 1'000'000, isa));
+  }
+
+  setRowsProcessed(state, rowsCount);
+  state.SetLabel(state.range(0) == 0 ? "scalar" : "avx2");
+}
+BENCHMARK(BM_FilterColumnKernel)->Arg(0)->Arg(1);
+
+/// @brief repeated reads of a rarely changing reference table, comparing no
+///        result cache (0), copies out of the result cache (1), and rows
+///        shared by the result cache (2)
+void BM_CachedReferenceRead(benchmark::State &state) {
+  CrudWrapper db{kworldDbPath};
+  if (state.range(0) != 0) {
+    db.setResultCacheBudget(16U * 1024U * 1024U);
+  }
+
+  for (auto _ : state) {
+    if (state.range(0) == 2) {
+      benchmark::DoNotOptimize(db.getCachedRows("CountryLanguage"));
+    } else {
+      benchmark::DoNotOptimize(db.getRows("CountryLanguage"));
+    }
+  }
+
+  state.SetLabel(state.range(0) == 0   ? "uncached"
+                 : state.range(0) == 1 ? "cached copy"
+                                       : "cached shared");
+}
+BENCHMARK(BM_CachedReferenceRead)->Arg(0)->Arg(1)->Arg(2);
+
+/// @brief repeated columns introspection, comparing names served by the
+///        schema catalog (0) with names peeked through a SELECT statement (1)
+void BM_PeekColumnsNames(benchmark::State &state) {
+  CrudWrapper const db{kworldDbPath};
+  std::string const tableName{state.range(0) == 0 ? "Country" : "main.Country"};
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(db.peekColumnsNames(tableName));
+  }
+
+  state.SetLabel(state.range(0) == 0 ? "catalog" : "select");
+}
+BENCHMARK(BM_PeekColumnsNames)->Arg(0)->Arg(1);
+
+/// @brief loading the world seed script into a database, comparing its text
+///        run through executeStatements (0) with executeScript (1)
+void BM_LoadWorldScript(benchmark::State &state) {
+  auto const scriptPath{kprojectRootPath + "/sql/world-sqlite3.sql"};
+  // the script drops its tables before creating them, so it can be loaded
+  // over and over into the same database
+  CrudWrapper db{makeEmptyDatabase("crud-wrapper-benchmark-script.db")};
+
+  for (auto _ : state) {
+    if (state.range(0) == 0) {
+      std::stringstream script;
+      script << std::ifstream{scriptPath}.rdbuf();
+      benchmark::DoNotOptimize(db.executeStatements(script.str()));
+    } else {
+      benchmark::DoNotOptimize(db.executeScript(scriptPath));
+    }
+  }
+
+  setRowsProcessed(state, 4079U + 239U + 984U);
+  state.SetLabel(state.range(0) == 0 ? "executeStatements" : "executeScript");
+}
+BENCHMARK(BM_LoadWorldScript)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+/// @brief reading a page of 100 rows 90'000 rows deep into a table, comparing
+///        LIMIT / OFFSET (0) with keyset pagination (1)
+void BM_ReadDeepPage(benchmark::State &state) {
+  constexpr std::size_t rowsCount{100'000U};
+  constexpr std::size_t pageSize{100U};
+  constexpr std::size_t depth{90'000U};
+  CrudWrapper const db{syntheticCityDatabase(rowsCount)};
+  auto const token{db.getPage("City", depth).continuationToken};
+
+  for (auto _ : state) {
+    if (state.range(0) == 0) {
+      auto statement{db.prepareStatement(
+          "SELECT * FROM City ORDER BY rowid LIMIT ? OFFSET ?")};
+      statement.bindAll(pageSize, depth);
+      benchmark::DoNotOptimize(db.getResultSet(statement));
+    } else {
+      benchmark::DoNotOptimize(db.getPage("City", pageSize, token));
+    }
+  }
+
+  setRowsProcessed(state, pageSize);
+  state.SetLabel(state.range(0) == 0 ? "offset" : "keyset");
+}
+BENCHMARK(BM_ReadDeepPage)->Arg(0)->Arg(1);
+
+/// @brief cost of inserting 100'000 rows into one database file versus four
+///        shards, which insert their rows in parallel
+void BM_ShardedBulkInsert(benchmark::State &state) {
+  constexpr std::size_t rowsCount{100'000U};
+  auto const shardsCount{static_cast<std::size_t>(state.range(0))};
+
+  std::vector<CityRow> rows;
+  rows.reserve(rowsCount);
+  for (std::size_t i{0U}; i < rowsCount; ++i) {
+    rows.emplace_back(static_cast<std::int64_t>(i + 1U), "Synthetic City",
+                      "SYN", "Synthetic District",
+                      static_cast<std::int64_t>(i % 1000U));
+  }
+
+  std::vector<std::filesystem::path> paths;
+  for (std::size_t i{0U}; i < shardsCount; ++i) {
+    paths.push_back(makeEmptyDatabase(
+        "crud-wrapper-benchmark-shard-" + std::to_string(i) + ".db"));
+  }
+  ShardedCrud db{paths, ShardRouter::byHash(shardsCount)};
+  db.executeStatements(
+      "CREATE TABLE City (ID INTEGER PRIMARY KEY, Name TEXT, "
+      "CountryCode TEXT, District TEXT, Population INTEGER);");
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    db.executeStatements("DELETE FROM City;");
+    state.ResumeTiming();
+
+    if (!db.bulkInsert("City", {}, rows, [](CityRow const &row) {
+          return ShardKey_type{std::get<0>(row)};
+        })) {
+      state.SkipWithError("bulk insert failed");
+      break;
+    }
+  }
+
+  setRowsProcessed(state, rowsCount);
+  state.SetLabel(std::to_string(shardsCount) + " shard(s)");
+}
+BENCHMARK(BM_ShardedBulkInsert)
+    ->Arg(1)
+    ->Arg(4)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+/// @brief cost of reading a 1'000'000 rows table on a single connection
+///        versus scanning it in parallel by rowid ranges, on a reader
+///        connection per hardware thread
+void BM_ParallelScan(benchmark::State &state) {
+  constexpr std::size_t rowsCount{1'000'000U};
+
+  // the pool switches its database to WAL journal mode, so it gets a copy
+  auto const path{makeEmptyDatabase("crud-wrapper-benchmark-scan.db")};
+  std::filesystem::copy_file(syntheticCityDatabase(rowsCount), path,
+                             std::filesystem::copy_options::overwrite_existing);
+  CrudWrapperPool pool{path};
+
+  for (auto _ : state) {
+    if (state.range(0) == 0) {
+      benchmark::DoNotOptimize(
+          pool.acquireReader()->getRowsAs<CityRow>("City"));
+    } else {
+      benchmark::DoNotOptimize(pool.parallelScan<CityRow>("City"));
+    }
+  }
+
+  setRowsProcessed(state, rowsCount);
+  state.SetLabel(state.range(0) == 0
+                     ? "single connection"
+                     : std::to_string(pool.stats().readersCount) +
+                           " readers");
+}
+BENCHMARK(BM_ParallelScan)
+    ->Arg(0)
+    ->Arg(1)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+/// @brief point lookups of cities by their primary key on the database file
+///        versus its in-memory mirror, where the argument selects the mirror,
+///        and the label reports the time the mirror took to load
+void BM_MirroredPointLookupById(benchmark::State &state) {
+  auto options{CrudWrapperOptions::forProfile(TuningProfile::Default)};
+  if (state.range(0) == 1) {
+    options.mirror = MirrorOptions{};
+  }
+  CrudWrapper const db{kworldDbPath, options};
+  std::int64_t id{0};
+
+  for (auto _ : state) {
+    auto statement{
+        db.prepareStatement("SELECT Name, Population FROM City WHERE ID = ?")};
+    statement.bind(id % 4079 + 1, 1U);
+    auto const rows{db.getRowsAs<std::tuple<std::string, std::int64_t>>(
+        statement)};
+    benchmark::DoNotOptimize(rows.data());
+    ++id;
+  }
+
+  auto const stats{db.mirrorStats()};
+  state.SetLabel(stats.has_value()
+                     ? "mirror loaded in " +
+                           std::to_string(stats->loadTime.count() / 1000) +
+                           " us"
+                     : "file");
+}
+BENCHMARK(BM_MirroredPointLookupById)->Arg(0)->Arg(1);
+
+/// @brief cost of 1000 single-row inserts each committed on its own versus
+///        grouped into one transaction, where the argument selects grouping
+void BM_GroupedInserts(benchmark::State &state) {
+  constexpr std::int64_t rowsCount{1000};
+  CrudWrapper db{makeEmptyDatabase("crud-wrapper-benchmark-grouped.db")};
+  db.executeStatements(
+      "CREATE TABLE City (ID INTEGER PRIMARY KEY, Name TEXT, "
+      "CountryCode TEXT, District TEXT, Population INTEGER);");
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    db.executeStatements("DELETE FROM City;");
+    state.ResumeTiming();
+
+    std::optional<CrudWrapper::Transaction> transaction;
+    if (state.range(0) == 1) {
+      transaction.emplace(db.beginTransaction(TransactionMode::Immediate));
+    }
+    for (std::int64_t id{1}; id <= rowsCount; ++id) {
+      auto statement{db.prepareStatement(
+          "INSERT INTO City VALUES (?, 'Grouped City', 'GRP', "
+          "'Grouped District', ?)")};
+      statement.bindAll(id, id % 1000);
+      benchmark::DoNotOptimize(sqlite3_step(statement.get().get()));
+    }
+    if (transaction.has_value() && !transaction->commit()) {
+      state.SkipWithError("commit failed");
+      break;
+    }
+  }
+
+  setRowsProcessed(state, rowsCount);
+  state.SetLabel(state.range(0) == 0 ? "autocommit" : "one transaction");
+}
+BENCHMARK(BM_GroupedInserts)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+/// @brief cost of 4 threads inserting 100 rows each, one row per operation,
+///        either committing each row on a shared connection, or submitting
+///        them to a write queue committing them in batches
+void BM_ConcurrentWriters(benchmark::State &state) {
+  constexpr int threadsCount{4};
+  constexpr int rowsPerThread{100};
+  auto const path{makeEmptyDatabase("crud-wrapper-benchmark-writers.db")};
+  CrudWrapper{path}.executeStatements(
+      "CREATE TABLE Event (ID INTEGER PRIMARY KEY, Source INTEGER);");
+
+  CrudWrapper db{path};
+  std::mutex dbMutex;
+  WriteQueue queue{path};
+  auto const insertRows{[&](int source) {
+    auto const statement{"INSERT INTO Event (Source) VALUES (" +
+                         std::to_string(source) + ");"};
+    for (int i{0}; i < rowsPerThread; ++i) {
+      if (state.range(0) == 0) {
+        std::scoped_lock const lock{dbMutex};
+        db.executeStatements(statement);
+      } else {
+        queue.submit(statement).wait();
+      }
+    }
+  }};
+
+  for (auto _ : state) {
+    std::vector<std::jthread> threads;
+    for (int source{0}; source < threadsCount; ++source) {
+      threads.emplace_back(insertRows, source);
+    }
+  }
+
+  setRowsProcessed(state, threadsCount * rowsPerThread);
+  state.SetLabel(state.range(0) == 0
+                     ? "commit per row"
+                     : std::to_string(queue.stats().batchesCount) +
+                           " batches");
+}
+BENCHMARK(BM_ConcurrentWriters)
+    ->Arg(0)
+    ->Arg(1)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+/// @brief reads of a database whose exclusive lock is taken every other
+///        millisecond by another connection, failing with SQLITE_BUSY at once
+///        (0) or waiting with the busy policy (1)
+void BM_ContendedReads(benchmark::State &state) {
+  using namespace std::chrono_literals;
+  auto const path{makeEmptyDatabase("crud-wrapper-benchmark-contended.db")};
+  CrudWrapper{path}.executeStatements(
+      "CREATE TABLE Event (ID INTEGER PRIMARY KEY, Source INTEGER);"
+      "INSERT INTO Event (Source) VALUES (1);");
+
+  auto options{CrudWrapperOptions{}};
+  if (state.range(0) == 1) {
+    options.busyPolicy = BusyPolicy{};
+  }
+  CrudWrapper db{path, options};
+  auto statement{db.prepareStatement("SELECT COUNT(*) FROM Event")};
+
+  std::jthread writer{[&path](std::stop_token const &stopToken) {
+    CrudWrapper lockHolder{path};
+    while (!stopToken.stop_requested()) {
+      lockHolder.executeStatements("BEGIN EXCLUSIVE;");
+      std::this_thread::sleep_for(1ms);
+      lockHolder.executeStatements("COMMIT;");
+      std::this_thread::sleep_for(1ms);
+    }
+  }};
+
+  std::size_t failedCount{0U};
+  std::chrono::steady_clock::duration slowest{0};
+  for (auto _ : state) {
+    auto const startTime{std::chrono::steady_clock::now()};
+    if (db.getRowsAs<std::int64_t>(statement).empty()) {
+      ++failedCount;
+    }
+    slowest = std::max(slowest, std::chrono::steady_clock::now() - startTime);
+  }
+
+  setRowsProcessed(state, 1U);
+  state.SetLabel(
+      std::to_string(failedCount) + " failed, slowest " +
+      std::to_string(
+          std::chrono::duration_cast<std::chrono::microseconds>(slowest)
+              .count()) +
+      "us");
+}
+BENCHMARK(BM_ContendedReads)->Arg(0)->Arg(1)->UseRealTime();
+
+/// @brief point lookups of cities by their primary key, through a statement
+///        prepared from a runtime string (0) or a compile-time Query (1)
+void BM_TypedPointLookupById(benchmark::State &state) {
+  constexpr Query<"SELECT Name, Population FROM City WHERE ID = ?",
+                  Result<std::string, std::int64_t>, Params<std::int64_t>>
+      cityById;
+  CrudWrapper const db{kworldDbPath};
+  std::int64_t id{0};
+
+  for (auto _ : state) {
+    if (state.range(0) == 0) {
+      auto statement{db.prepareStatement(
+          "SELECT Name, Population FROM City WHERE ID = ?")};
+      statement.bind(id % 4079 + 1, 1U);
+      auto const rows{db.getRowsAs<std::tuple<std::string, std::int64_t>>(
+          statement)};
+      benchmark::DoNotOptimize(rows.data());
+    } else {
+      auto const rows{db.run(cityById, id % 4079 + 1)};
+      benchmark::DoNotOptimize(rows.data());
+    }
+    ++id;
+  }
+
+  state.SetLabel(state.range(0) == 0 ? "runtime string" : "typed query");
+}
+BENCHMARK(BM_TypedPointLookupById)->Arg(0)->Arg(1);
+
+/// @brief full scans of the City table into structs, parsed out of text rows
+///        (0) or read straight from the columns through a RowMapping (1)
+void BM_MappedFullScan(benchmark::State &state) {
+  CrudWrapper const db{kworldDbPath};
+
+  for (auto _ : state) {
+    std::vector<City> cities;
+    if (state.range(0) == 0) {
+      auto const rows{db.getRows("City")};
+      cities.reserve(rows.size() - 1U);
+      for (std::size_t i{1U}; i < rows.size(); ++i) {
+        cities.push_back({.id = std::stoll(rows[i][0]),
+                          .name = rows[i][1],
+                          .countryCode = rows[i][2],
+                          .district = rows[i][3],
+                          .population = std::stoll(rows[i][4])});
+      }
+    } else {
+      cities = db.getRowsAs<City>();
+    }
+    benchmark::DoNotOptimize(cities.data());
+  }
+
+  setRowsProcessed(state, 4079U);
+  state.SetLabel(state.range(0) == 0 ? "parsed strings" : "row mapping");
+}
+BENCHMARK(BM_MappedFullScan)->Arg(0)->Arg(1);
+
+} // namespace sql_with_cpp_benchmark
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <string>
+
+#include "crud-wrapper/CrudWrapper.hpp"
+
+/// @brief namespace for CrudWrapper benchmarks
+namespace sql_with_cpp_benchmark {
+
+/// @brief path to the root of this project
+inline const std::string kprojectRootPath{PROJECT_ROOT_PATH};
+
+/// @brief function to create an empty database file in the temporary
+///        directory, removing any previous one with the same name
+/// @param fileName the name of the database file
+/// @return path to the created database
+inline auto makeEmptyDatabase(std::string const &fileName)
+    -> std::filesystem::path {
+  auto const path{std::filesystem::temp_directory_path() / fileName};
+  for (auto const *suffix : {"", "-wal", "-shm", "-journal"}) {
+    std::filesystem::remove(path.string() + suffix);
+  }
+
+  // CrudWrapper opens existing databases only
+  std::ofstream const file{path};
+  return path;
+}
+
+/// @brief function to return a database whose City table is world.db's City
+///        table scaled to the requested number of rows, by repeating its rows
+///        with new IDs and slightly varied populations
+/// @param rowsCount the number of rows of the generated City table
+/// @return path to the generated database
+/// @note generated databases are kept in the temporary directory, and reused
+///       by later runs as long as they hold the requested number of rows
+inline auto syntheticCityDatabase(std::size_t rowsCount)
+    -> std::filesystem::path {
+  auto const fileName{std::format("crud-wrapper-benchmark-city-{}.db",
+                                  rowsCount)};
+  auto const path{std::filesystem::temp_directory_path() / fileName};
+
+  if (std::filesystem::exists(path)) {
+    sql_with_cpp::CrudWrapper const db{path};
+    auto const counts{db.getRowsAs<std::size_t>(
+        db.prepareStatement("SELECT COUNT(*) FROM City"))};
+    if (counts == std::vector<std::size_t>{rowsCount}) {
+      return path;
+    }
+  }
+
+  sql_with_cpp::CrudWrapper db{
+      makeEmptyDatabase(fileName),
+      sql_with_cpp::CrudWrapperOptions::forProfile(
+          sql_with_cpp::TuningProfile::BulkLoad)};
+
+  db.executeStatements(std::format(
+      "CREATE TABLE City ("
+      "ID INTEGER PRIMARY KEY, Name TEXT NOT NULL DEFAULT '', "
+      "CountryCode TEXT NOT NULL DEFAULT '', "
+      "District TEXT NOT NULL DEFAULT '', "
+      "Population INTEGER NOT NULL DEFAULT '0');"
+      "ATTACH DATABASE '{}' AS world;"
+      "BEGIN;"
+      "WITH RECURSIVE seq(n) AS "
+      "(SELECT 1 UNION ALL SELECT n + 1 FROM seq WHERE n < {}) "
+      "INSERT INTO City (ID, Name, CountryCode, District, Population) "
+      "SELECT seq.n, src.Name, src.CountryCode, src.District, "
+      "src.Population + seq.n % 1000 FROM seq "
+      "JOIN world.City AS src "
+      "ON src.ID = (seq.n - 1) % (SELECT COUNT(*) FROM world.City) + 1;"
+      "COMMIT;"
+      "DETACH DATABASE world;",
+      kprojectRootPath + "/db/world.db", rowsCount));
+
+  return path;
+}
+
+} // namespace sql_with_cpp_benchmark
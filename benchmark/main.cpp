@@ -0,0 +1,16 @@
+#include "benchmark/benchmark.h"
+
+/// @brief main entry point for benchmarks
+/// @param argc
+/// @param argv
+/// @return status from executing the benchmarks
+auto main(int argc, char *argv[]) -> int {
+  ::benchmark::Initialize(&argc, argv);
+  if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+
+  ::benchmark::RunSpecifiedBenchmarks();
+  ::benchmark::Shutdown();
+  return 0;
+}
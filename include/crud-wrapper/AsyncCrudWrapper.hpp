@@ -0,0 +1,154 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "AsyncGenerator.hpp"
+#include "CrudWrapperPool.hpp"
+#include "Task.hpp"
+#include "ThreadPool.hpp"
+
+/// @brief namespace for SQL with c++
+namespace sql_with_cpp {
+
+/// @brief class for running CRUD operations as coroutines, whose blocking
+///        parts run on a dedicated pool of threads using a pool of connections,
+///        so that the threads awaiting them (e.g. event loop threads) are not
+///        blocked meanwhile
+/// @note awaiting coroutines are resumed on the worker thread that completed
+///       the operation, so they are expected to move back to their own
+///       executor if they have to
+/// @note this object must outlive all the coroutines returned by it
+class AsyncCrudWrapper {
+public:
+  /// @brief deleted default constructor for allowing only construction when
+  ///        passing a path to the database
+  AsyncCrudWrapper() = delete;
+
+  /// @brief parametrized constructor that opens the pool of connections, and
+  ///        starts a worker thread per connection
+  /// @param path filesystem path to the database
+  /// @param readersCount number of reader connections to open
+  /// @param options options applied to all the connections, check the
+  ///                CrudWrapperPool constructor
+  /// @note throws the same exceptions of the CrudWrapperPool constructor
+  explicit AsyncCrudWrapper(
+      const std::convertible_to<std::filesystem::path> auto &path,
+      std::size_t readersCount = CrudWrapperPool::defaultReadersCount(),
+      CrudWrapperOptions const &options = CrudWrapperOptions::forProfile(
+          TuningProfile::ReadHeavy))
+      : m_pool{path, readersCount, options}, m_executor{readersCount + 1U} {}
+
+  /// @brief deleted copy and move operations, as running coroutines refer to
+  ///        this object
+  AsyncCrudWrapper(AsyncCrudWrapper const &) = delete;
+  AsyncCrudWrapper(AsyncCrudWrapper &&) = delete;
+  auto operator=(AsyncCrudWrapper const &) -> AsyncCrudWrapper & = delete;
+  auto operator=(AsyncCrudWrapper &&) -> AsyncCrudWrapper & = delete;
+  ~AsyncCrudWrapper() noexcept = default;
+
+  /// @brief asynchronous variant of CrudWrapper::getRows
+  /// @param tableName the name of the table to read all of its rows
+  /// @return task whose result is the rows of the table, where the first row
+  ///         represents the columns names
+  auto getRowsAsync(std::string tableName)
+      -> Task<std::vector<std::vector<std::string>>> {
+    co_await m_executor.schedule();
+    co_return m_pool.acquireReader()->getRows(tableName);
+  }
+
+  /// @brief asynchronous variant of CrudWrapper::getRowsAs that runs the
+  ///        given statement after binding the given values to it
+  /// @tparam Row the type of the rows to read, check CrudWrapper::getRowsAs
+  /// @param statement the SQL statement to run
+  /// @param values values to bind to the placeholders of positions 1 to N,
+  ///               which are kept by the task until it is done
+  /// @return task whose result is the typed rows, or an empty vector if the
+  ///         statement could not be prepared or bound
+  template <typename Row, typename... Values>
+  auto getRowsAsAsync(std::string statement, Values... values)
+      -> Task<std::vector<Row>> {
+    co_await m_executor.schedule();
+
+    auto const reader{m_pool.acquireReader()};
+    auto preparedStatement{reader->prepareStatement(statement)};
+    if (!preparedStatement.bindAll(values...)) {
+      co_return std::vector<Row>{};
+    }
+
+    co_return reader->template getRowsAs<Row>(preparedStatement);
+  }
+
+  /// @brief asynchronous variant of CrudWrapper::executeStatements, which
+  ///        runs the statements on the writer connection
+  /// @param statements the SQL statements to be executed
+  /// @return task whose result is true if the statements were executed
+  ///         successfully, false otherwise
+  auto executeAsync(std::string statements) -> Task<bool> {
+    co_await m_executor.schedule();
+    co_return m_pool.acquireWriter()->executeStatements(statements);
+  }
+
+  /// @brief method to stream the rows of a statement in chunks, where each
+  ///        chunk is read on a worker thread once requested, so that large
+  ///        results are neither materialized at once, nor block the thread
+  ///        consuming them
+  /// @tparam Row the type of the rows to read, check CrudWrapper::getRowsAs
+  /// @param statement the SQL statement to run
+  /// @param chunkSize the maximum number of rows per chunk
+  /// @param values values to bind to the placeholders of positions 1 to N,
+  ///               which are kept by the generator until it is done
+  /// @return generator of non-empty chunks of typed rows, which is done once
+  ///         all the rows were produced, or if the statement could not be
+  ///         prepared or bound
+  /// @note a reader connection is leased for the whole lifetime of the
+  ///       generator, so the streams consumed at the same time should not
+  ///       outnumber the reader connections
+  template <typename Row, typename... Values>
+  auto streamAsync(std::string statement, std::size_t chunkSize,
+                   Values... values) -> AsyncGenerator<std::vector<Row>> {
+    co_await m_executor.schedule();
+
+    auto const reader{m_pool.acquireReader()};
+    auto rows{reader->query(statement, values...)};
+    if (rows.failed() || chunkSize == 0U) {
+      co_return;
+    }
+
+    for (auto it{rows.begin()}; it != rows.end();) {
+      std::vector<Row> chunk;
+      chunk.reserve(chunkSize);
+      for (; it != rows.end() && chunk.size() < chunkSize; ++it) {
+        chunk.emplace_back((*it).template as<Row>());
+      }
+
+      co_yield std::move(chunk);
+      co_await m_executor.schedule();
+    }
+  }
+
+  /// @brief method to return the pool of connections used by this object,
+  ///        e.g. for its metrics
+  /// @return reference to the pool of connections
+  [[nodiscard]] auto pool() noexcept -> CrudWrapperPool & { return m_pool; }
+
+  /// @brief method to return the pool of threads used by this object, e.g.
+  ///        for scheduling other blocking work on it
+  /// @return reference to the pool of threads
+  [[nodiscard]] auto executor() noexcept -> ThreadPool & { return m_executor; }
+
+private:
+  /// @brief the pool of connections to the database
+  CrudWrapperPool m_pool;
+
+  /// @brief the pool of threads running the blocking parts of the operations,
+  ///        declared after the pool of connections so that its threads are
+  ///        joined before the connections get closed
+  ThreadPool m_executor;
+};
+
+} // namespace sql_with_cpp
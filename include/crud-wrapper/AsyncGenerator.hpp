@@ -0,0 +1,175 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "Task.hpp"
+
+/// @brief namespace for SQL with c++
+namespace sql_with_cpp {
+
+/// @brief a lazily started coroutine producing a sequence of values, where
+///        each value is requested by awaiting next(), and the producer may
+///        itself await other coroutines (e.g. ThreadPool::schedule) between
+///        values
+/// @tparam T the type of the produced values
+/// @note e.g. while (auto value = co_await generator.next()) { ... }
+template <typename T> class [[nodiscard]] AsyncGenerator {
+public:
+  /// @brief promise type of the coroutine, as required by the language
+  class promise_type {
+  public:
+    /// @brief method to create the generator object returned to the caller
+    /// @return the generator object
+    auto get_return_object() noexcept -> AsyncGenerator {
+      return AsyncGenerator{
+          std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+
+    /// @brief generators are lazy, so they start once the first value is
+    ///        requested
+    /// @return awaitable that always suspends
+    auto initial_suspend() const noexcept -> std::suspend_always { return {}; }
+
+    /// @brief finished generators resume the coroutine requesting a value
+    /// @return awaitable that transfers execution to the requesting coroutine
+    auto final_suspend() const noexcept -> detail::ContinuationAwaiter {
+      return {};
+    }
+
+    /// @brief method to keep the value produced by co_yield, and to resume
+    ///        the coroutine requesting it
+    /// @param value the produced value
+    /// @return awaitable that transfers execution to the requesting coroutine
+    auto yield_value(T value) noexcept(
+        std::is_nothrow_move_constructible_v<T>)
+        -> detail::ContinuationAwaiter {
+      m_value.emplace(std::move(value));
+      return {};
+    }
+
+    /// @brief nothing is kept once the generator is done
+    void return_void() const noexcept {}
+
+    /// @brief method to keep the exception escaping the generator, so that it
+    ///        gets rethrown to the coroutine requesting a value
+    void unhandled_exception() noexcept {
+      m_exception = std::current_exception();
+    }
+
+    /// @brief method to return the coroutine requesting a value
+    /// @return the requesting coroutine
+    [[nodiscard]] auto
+    continuation() const noexcept -> std::coroutine_handle<> {
+      return m_continuation;
+    }
+
+  private:
+    friend AsyncGenerator;
+
+    /// @brief the coroutine requesting a value
+    std::coroutine_handle<> m_continuation;
+
+    /// @brief the last produced value, until it is taken
+    std::optional<T> m_value;
+
+    /// @brief the exception that escaped the generator, if any
+    std::exception_ptr m_exception;
+  };
+
+  /// @brief deleted copy operations, as the coroutine has a unique owner
+  AsyncGenerator(AsyncGenerator const &) = delete;
+  auto operator=(AsyncGenerator const &) -> AsyncGenerator & = delete;
+
+  /// @brief move constructor that takes over the coroutine of other
+  /// @param other the generator to move from
+  AsyncGenerator(AsyncGenerator &&other) noexcept
+      : m_handle{std::exchange(other.m_handle, nullptr)} {}
+
+  /// @brief move assignment operator that destroys the currently owned
+  ///        coroutine before taking over other's
+  /// @param other the generator to move from
+  /// @return reference to this object
+  auto operator=(AsyncGenerator &&other) noexcept -> AsyncGenerator & {
+    if (this != &other) {
+      destroy();
+      m_handle = std::exchange(other.m_handle, nullptr);
+    }
+
+    return *this;
+  }
+
+  /// @brief destructor that destroys the owned coroutine, even if it was not
+  ///        done producing values
+  ~AsyncGenerator() noexcept { destroy(); }
+
+  /// @brief method to request the next value, as in co_await generator.next()
+  /// @return awaitable whose result is the next value, or std::nullopt once
+  ///         the generator is done
+  /// @note requesting a value while the previous request is still pending is
+  ///       not supported
+  auto next() noexcept {
+    /// @brief awaitable of the next value
+    struct Awaiter {
+      /// @brief the generator coroutine
+      std::coroutine_handle<promise_type> handle;
+
+      /// @brief the requesting coroutine is suspended unless the generator is
+      ///        done
+      /// @return true if the generator is done
+      auto await_ready() const noexcept -> bool {
+        return !handle || handle.done();
+      }
+
+      /// @brief method to resume the generator, which resumes the requesting
+      ///        coroutine once it produces a value or gets done
+      /// @param requesting the requesting coroutine
+      /// @return the generator to transfer execution to
+      auto await_suspend(std::coroutine_handle<> requesting) const noexcept
+          -> std::coroutine_handle<> {
+        handle.promise().m_value.reset();
+        handle.promise().m_continuation = requesting;
+        return handle;
+      }
+
+      /// @brief method to take the produced value
+      /// @return the produced value, or std::nullopt if the generator is done
+      auto await_resume() const -> std::optional<T> {
+        if (!handle) {
+          return std::nullopt;
+        }
+
+        auto &promise{handle.promise()};
+        if (promise.m_exception) {
+          std::rethrow_exception(std::exchange(promise.m_exception, nullptr));
+        }
+
+        return std::exchange(promise.m_value, std::nullopt);
+      }
+    };
+
+    return Awaiter{m_handle};
+  }
+
+private:
+  /// @brief handle to the owned coroutine
+  std::coroutine_handle<promise_type> m_handle;
+
+  /// @brief private parametrized constructor used by the promise
+  /// @param handle handle to the coroutine
+  explicit AsyncGenerator(std::coroutine_handle<promise_type> handle) noexcept
+      : m_handle{handle} {}
+
+  /// @brief private method to destroy the owned coroutine
+  void destroy() noexcept {
+    if (m_handle) {
+      m_handle.destroy();
+      m_handle = nullptr;
+    }
+  }
+};
+
+} // namespace sql_with_cpp
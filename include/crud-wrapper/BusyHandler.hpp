@@ -0,0 +1,212 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <sqlite3.h>
+#include <thread>
+
+/// @brief namespace for SQL with c++
+namespace sql_with_cpp {
+
+/// @brief policy for waiting on the locks of a database held by other
+///        connections, instead of failing at once with SQLITE_BUSY, check
+///        CrudWrapperOptions::busyPolicy
+struct BusyPolicy {
+  /// @brief first backoff when none is specified
+  static constexpr std::chrono::microseconds kDefaultInitialBackoff{500};
+
+  /// @brief longest backoff when none is specified
+  static constexpr std::chrono::microseconds kDefaultMaxBackoff{20'000};
+
+  /// @brief longest total wait when none is specified
+  static constexpr std::chrono::milliseconds kDefaultMaxWait{2000};
+
+  /// @brief number of retries of read statements when none is specified
+  static constexpr std::size_t kDefaultReadRetries{3U};
+
+  /// @brief the backoff before the first retry, which doubles with each
+  ///        retry up to maxBackoff
+  std::chrono::microseconds initialBackoff{kDefaultInitialBackoff};
+
+  /// @brief the longest backoff between two retries
+  std::chrono::microseconds maxBackoff{kDefaultMaxBackoff};
+
+  /// @brief the longest total wait for a lock, after which SQLITE_BUSY is
+  ///        returned
+  std::chrono::milliseconds maxWait{kDefaultMaxWait};
+
+  /// @brief how many times a read statement failing with SQLITE_BUSY on its
+  ///        first step gets reset and run again, within the same maxWait
+  std::size_t readRetries{kDefaultReadRetries};
+};
+
+/// @brief metrics describing the contention met by a connection
+struct BusyStats {
+  /// @brief number of times a lock was found busy
+  std::size_t busyCount{0U};
+
+  /// @brief number of times waiting for a lock gave up, returning
+  ///        SQLITE_BUSY
+  std::size_t timeoutsCount{0U};
+
+  /// @brief number of times a read statement was run again after failing
+  ///        with SQLITE_BUSY
+  std::size_t readRetriesCount{0U};
+
+  /// @brief total time spent waiting for locks
+  std::chrono::nanoseconds totalWait{0};
+};
+
+/// @brief busy handler of a database connection, which retries busy locks
+///        with exponential backoff and jitter within a bounded total wait
+/// @note jitter spreads the retries of connections that found a lock busy at
+///       the same time, so that they don't wake up together again
+/// @note this class is not thread safe, just like the connection it serves
+class BusyHandler {
+  /// @brief clock used for measuring waits
+  using Clock_type = std::chrono::steady_clock;
+
+public:
+  /// @brief deleted default constructor for allowing only construction with
+  ///        a policy
+  BusyHandler() = delete;
+
+  /// @brief parametrized constructor for the busy handler
+  /// @param policy the policy of the handler
+  explicit BusyHandler(BusyPolicy const &policy)
+      : m_policy{policy}, m_random{std::random_device{}()} {}
+
+  /// @brief method to install this object as the busy handler of a database
+  ///        connection
+  /// @param db the database connection
+  /// @note this object has to outlive the connection, or be uninstalled
+  ///       before being destroyed
+  void install(sqlite3 *db) noexcept {
+    sqlite3_busy_handler(db, &BusyHandler::onBusy, this);
+  }
+
+  /// @brief method to bound the waits of the next steps of a statement by a
+  ///        single deadline, instead of a deadline per busy lock, so that
+  ///        retrying the statement waits no longer than maxWait in total
+  void armDeadline() noexcept {
+    m_deadline = Clock_type::now() + m_policy.maxWait;
+    m_armed = true;
+  }
+
+  /// @brief method to go back to a deadline per busy lock
+  void disarmDeadline() noexcept { m_armed = false; }
+
+  /// @brief method to wait before retrying a read statement that failed with
+  ///        SQLITE_BUSY
+  /// @param retry the number of retries so far
+  /// @return true if the statement can be retried, false if it ran out of
+  ///         retries or of time
+  auto backOffRead(std::size_t retry) noexcept -> bool {
+    if (retry >= m_policy.readRetries || !sleepFor(retry)) {
+      return false;
+    }
+
+    ++m_stats.readRetriesCount;
+    return true;
+  }
+
+  /// @brief method to step a statement to its next row, which runs a read
+  ///        statement again if its first step failed with SQLITE_BUSY, as
+  ///        allowed by the policy
+  /// @param stmt the statement to step, on the connection this object is
+  ///             installed on
+  /// @return the result code of the last step
+  /// @note the waits of all the runs of the statement are bounded together by
+  ///       BusyPolicy::maxWait, so a statement whose waits timed out is not
+  ///       retried, while one that failed without waiting (e.g. while another
+  ///       connection recovers a WAL file) is
+  auto step(sqlite3_stmt *stmt) noexcept -> int {
+    // only statements that read no rows yet can be run again from scratch
+    if (sqlite3_stmt_busy(stmt) != 0 || sqlite3_stmt_readonly(stmt) == 0) {
+      return sqlite3_step(stmt);
+    }
+
+    armDeadline();
+    auto stepCode{sqlite3_step(stmt)};
+    for (std::size_t retry{0U};
+         (stepCode & 0xFF) == SQLITE_BUSY && backOffRead(retry); ++retry) {
+      sqlite3_reset(stmt);
+      stepCode = sqlite3_step(stmt);
+    }
+    disarmDeadline();
+
+    return stepCode;
+  }
+
+  /// @brief method to return a snapshot of the contention metrics
+  /// @return the contention metrics
+  [[nodiscard]] auto stats() const noexcept -> BusyStats { return m_stats; }
+
+private:
+  /// @brief the policy of the handler
+  BusyPolicy m_policy;
+
+  /// @brief the generator of the jitter
+  std::minstd_rand m_random;
+
+  /// @brief the deadline of the current wait
+  Clock_type::time_point m_deadline;
+
+  /// @brief whether the deadline is armed by a statement, check armDeadline
+  bool m_armed{false};
+
+  /// @brief the contention metrics
+  BusyStats m_stats;
+
+  /// @brief private static method called by SQLite when a lock is busy
+  /// @param handler the busy handler
+  /// @param count the number of times it was called for the same lock
+  /// @return non-zero to retry the lock, zero to return SQLITE_BUSY
+  static auto onBusy(void *handler, int count) noexcept -> int {
+    auto &self{*static_cast<BusyHandler *>(handler)};
+    ++self.m_stats.busyCount;
+    if (count == 0 && !self.m_armed) {
+      self.m_deadline = Clock_type::now() + self.m_policy.maxWait;
+    }
+
+    if (!self.sleepFor(static_cast<std::size_t>(count))) {
+      ++self.m_stats.timeoutsCount;
+      return 0;
+    }
+
+    return 1;
+  }
+
+  /// @brief private method to sleep for the backoff of a retry, with equal
+  ///        jitter, i.e. a random time between the half and the whole of the
+  ///        exponential backoff, cut short by the deadline
+  /// @param retry the number of retries so far
+  /// @return true if slept, false if the deadline passed
+  auto sleepFor(std::size_t retry) noexcept -> bool {
+    auto const now{Clock_type::now()};
+    if (now >= m_deadline) {
+      return false;
+    }
+
+    // doubling stops at maxBackoff, so that many retries can't overflow
+    auto backoff{m_policy.initialBackoff};
+    for (std::size_t i{0U}; i < retry && backoff < m_policy.maxBackoff; ++i) {
+      backoff *= 2;
+    }
+    backoff = std::min(backoff, m_policy.maxBackoff);
+
+    std::uniform_int_distribution<std::int64_t> jitter{backoff.count() / 2,
+                                                       backoff.count()};
+    auto const sleep{std::min<Clock_type::duration>(
+        std::chrono::microseconds{jitter(m_random)}, m_deadline - now)};
+    std::this_thread::sleep_for(sleep);
+    m_stats.totalWait += Clock_type::now() - now;
+
+    return true;
+  }
+};
+
+} // namespace sql_with_cpp
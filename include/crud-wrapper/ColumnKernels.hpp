@@ -0,0 +1,616 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "ColumnarBatch.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SQL_WITH_CPP_AVX2_KERNELS 1
+#include <immintrin.h>
+#else
+#define SQL_WITH_CPP_AVX2_KERNELS 0
+#endif
+
+/// @brief namespace for SQL with c++
+namespace sql_with_cpp {
+
+/// @brief instruction sets the column kernels can run with
+enum class KernelIsa { Scalar, Avx2 };
+
+/// @brief comparisons the filter kernels can apply to column values
+enum class Comparison {
+  Equal,
+  NotEqual,
+  Less,
+  LessEqual,
+  Greater,
+  GreaterEqual
+};
+
+/// @brief a concept satisfied by the types of numeric column values
+template <typename T>
+concept ColumnValue = std::same_as<T, std::int64_t> || std::same_as<T, double>;
+
+/// @brief type of the indices of the rows selected by a filter, in ascending
+///        order
+using Selection_type = std::vector<std::uint32_t>;
+
+/// @brief aggregates of the non-NULL values of a numeric column
+/// @tparam T the type of the values
+template <ColumnValue T> struct Aggregates {
+  /// @brief the number of non-NULL values
+  std::size_t count{0U};
+
+  /// @brief the sum of the values, which wraps around on Integer overflow
+  T sum{0};
+
+  /// @brief the smallest value, or the largest T if count is zero
+  T min{std::numeric_limits<T>::has_infinity
+            ? std::numeric_limits<T>::infinity()
+            : std::numeric_limits<T>::max()};
+
+  /// @brief the largest value, or the lowest T if count is zero
+  T max{std::numeric_limits<T>::has_infinity
+            ? -std::numeric_limits<T>::infinity()
+            : std::numeric_limits<T>::lowest()};
+
+  /// @brief method to return the mean of the values
+  /// @return the mean, or std::nullopt if count is zero
+  [[nodiscard]] auto mean() const noexcept -> std::optional<double> {
+    if (count == 0U) {
+      return std::nullopt;
+    }
+
+    return static_cast<double>(sum) / static_cast<double>(count);
+  }
+};
+
+/// @brief aggregates of the values of a group sharing the same key
+/// @tparam T the type of the values
+template <ColumnValue T> struct Group {
+  /// @brief the key of the group
+  std::string key;
+
+  /// @brief the aggregates of the values of the group
+  Aggregates<T> aggregates;
+};
+
+/// @brief namespace for the implementation details of the column kernels
+namespace detail {
+
+/// @brief number of values covered by a word of a validity bitmap
+inline constexpr std::size_t kValuesPerWord{64U};
+
+/// @brief function to return the values of a column as a span of T
+/// @tparam T the type of the values
+/// @param column the column
+/// @return the values, or an empty span if the column is not of type T
+template <ColumnValue T>
+auto valuesOf(Column const &column) noexcept -> std::span<const T> {
+  if constexpr (std::same_as<T, std::int64_t>) {
+    return column.integers();
+  } else {
+    return column.reals();
+  }
+}
+
+/// @brief function to apply a comparison to a value
+/// @param lhs the compared value
+/// @param comparison the comparison to apply
+/// @param rhs the value compared to
+/// @return the result of the comparison
+template <ColumnValue T>
+constexpr auto compare(T lhs, Comparison comparison, T rhs) noexcept -> bool {
+  switch (comparison) {
+  case Comparison::Equal:
+    return lhs == rhs;
+  case Comparison::NotEqual:
+    return lhs != rhs;
+  case Comparison::Less:
+    return lhs < rhs;
+  case Comparison::LessEqual:
+    return lhs <= rhs;
+  case Comparison::Greater:
+    return lhs > rhs;
+  case Comparison::GreaterEqual:
+    return lhs >= rhs;
+  }
+
+  return false;
+}
+
+/// @brief function to add a value to aggregates
+/// @param aggregates the aggregates to update
+/// @param value the value to add
+template <ColumnValue T>
+void accumulate(Aggregates<T> &aggregates, T value) noexcept {
+  ++aggregates.count;
+  if constexpr (std::same_as<T, std::int64_t>) {
+    // unsigned arithmetic wraps around like the vectorized kernels do
+    aggregates.sum = static_cast<std::int64_t>(
+        static_cast<std::uint64_t>(aggregates.sum) +
+        static_cast<std::uint64_t>(value));
+  } else {
+    aggregates.sum += value;
+  }
+  aggregates.min = value < aggregates.min ? value : aggregates.min;
+  aggregates.max = value > aggregates.max ? value : aggregates.max;
+}
+
+/// @brief scalar kernel aggregating values along with their validity bitmap
+/// @param values the values, where NULL values hold zero
+/// @param validity the validity bitmap of the values
+/// @param first the index of the first value to aggregate
+/// @return the aggregates of the non-NULL values from the first one on
+template <ColumnValue T>
+auto aggregateScalar(std::span<const T> values,
+                     std::span<const std::uint64_t> validity,
+                     std::size_t first = 0U) noexcept -> Aggregates<T> {
+  Aggregates<T> aggregates;
+  for (auto i{first}; i < values.size(); ++i) {
+    if (((validity[i / kValuesPerWord] >> (i % kValuesPerWord)) & 1U) != 0U) {
+      accumulate(aggregates, values[i]);
+    }
+  }
+
+  return aggregates;
+}
+
+/// @brief function to count the valid values among the first ones
+/// @param validity the validity bitmap of the values
+/// @param valuesCount the number of values to check
+/// @return the number of valid values among the first valuesCount ones
+inline auto countValid(std::span<const std::uint64_t> validity,
+                       std::size_t valuesCount) noexcept -> std::size_t {
+  std::size_t count{0U};
+  for (std::size_t word{0U}; word < valuesCount / kValuesPerWord; ++word) {
+    count += static_cast<std::size_t>(std::popcount(validity[word]));
+  }
+  if (valuesCount % kValuesPerWord != 0U) {
+    count += static_cast<std::size_t>(
+        std::popcount(validity[valuesCount / kValuesPerWord] &
+                      ((std::uint64_t{1U} << (valuesCount % kValuesPerWord)) -
+                       1U)));
+  }
+
+  return count;
+}
+
+/// @brief scalar kernel comparing up to a word of values
+/// @param values the values to compare, at most kValuesPerWord of them
+/// @param comparison the comparison to apply
+/// @param operand the value compared to
+/// @return bitmap word where bit i is set if values[i] matches
+template <ColumnValue T>
+auto compareWordScalar(std::span<const T> values, Comparison comparison,
+                       T operand) noexcept -> std::uint64_t {
+  std::uint64_t matches{0U};
+  for (std::size_t i{0U}; i < values.size(); ++i) {
+    matches |= std::uint64_t{compare(values[i], comparison, operand)} << i;
+  }
+
+  return matches;
+}
+
+#if SQL_WITH_CPP_AVX2_KERNELS
+
+/// @brief function to check whether the running CPU supports AVX2
+/// @return true if AVX2 is supported, false otherwise
+inline auto avx2Supported() noexcept -> bool {
+  static bool const supported{[] {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+  }()};
+
+  return supported;
+}
+
+/// @brief function to expand 4 bits of a validity bitmap to a lanes mask
+/// @param bits the validity bits of 4 consecutive values, in the low bits
+/// @return mask whose 64 bit lane i is all ones if bit i is set
+__attribute__((target("avx2"))) inline auto
+lanesMask(std::uint64_t bits) noexcept -> __m256i {
+  auto const lanesBits{_mm256_setr_epi64x(1, 2, 4, 8)};
+  return _mm256_cmpeq_epi64(
+      _mm256_and_si256(_mm256_set1_epi64x(static_cast<long long>(bits)),
+                       lanesBits),
+      lanesBits);
+}
+
+/// @brief AVX2 kernel aggregating Integer values, check aggregateScalar
+__attribute__((target("avx2"))) inline auto
+aggregateAvx2(std::span<const std::int64_t> values,
+              std::span<const std::uint64_t> validity) noexcept
+    -> Aggregates<std::int64_t> {
+  Aggregates<std::int64_t> aggregates;
+  auto const minIdentity{_mm256_set1_epi64x(aggregates.min)};
+  auto const maxIdentity{_mm256_set1_epi64x(aggregates.max)};
+  auto sums{_mm256_setzero_si256()};
+  auto mins{minIdentity};
+  auto maxs{maxIdentity};
+
+  std::size_t i{0U};
+  for (; i + 4U <= values.size(); i += 4U) {
+    auto const lanes{_mm256_loadu_si256(
+        reinterpret_cast<__m256i const *>(values.data() + i))};
+    auto const valid{
+        lanesMask(validity[i / kValuesPerWord] >> (i % kValuesPerWord))};
+
+    // NULL values hold zero, so they can be summed as they are
+    sums = _mm256_add_epi64(sums, lanes);
+
+    auto const minLanes{_mm256_blendv_epi8(minIdentity, lanes, valid)};
+    mins = _mm256_blendv_epi8(mins, minLanes,
+                              _mm256_cmpgt_epi64(mins, minLanes));
+    auto const maxLanes{_mm256_blendv_epi8(maxIdentity, lanes, valid)};
+    maxs = _mm256_blendv_epi8(maxs, maxLanes,
+                              _mm256_cmpgt_epi64(maxLanes, maxs));
+  }
+
+  alignas(32) std::array<std::int64_t, 4U> lanesSums{};
+  alignas(32) std::array<std::int64_t, 4U> lanesMins{};
+  alignas(32) std::array<std::int64_t, 4U> lanesMaxs{};
+  _mm256_store_si256(reinterpret_cast<__m256i *>(lanesSums.data()), sums);
+  _mm256_store_si256(reinterpret_cast<__m256i *>(lanesMins.data()), mins);
+  _mm256_store_si256(reinterpret_cast<__m256i *>(lanesMaxs.data()), maxs);
+
+  auto tail{aggregateScalar(values, validity, i)};
+  tail.count += countValid(validity, i);
+  for (std::size_t lane{0U}; lane < 4U; ++lane) {
+    tail.sum = static_cast<std::int64_t>(
+        static_cast<std::uint64_t>(tail.sum) +
+        static_cast<std::uint64_t>(lanesSums[lane]));
+    tail.min = lanesMins[lane] < tail.min ? lanesMins[lane] : tail.min;
+    tail.max = lanesMaxs[lane] > tail.max ? lanesMaxs[lane] : tail.max;
+  }
+
+  return tail;
+}
+
+/// @brief AVX2 kernel aggregating Real values, check aggregateScalar
+/// @note the values are summed in 4 interleaved partial sums, so the sum may
+///       differ from the scalar one by rounding
+__attribute__((target("avx2"))) inline auto
+aggregateAvx2(std::span<const double> values,
+              std::span<const std::uint64_t> validity) noexcept
+    -> Aggregates<double> {
+  Aggregates<double> aggregates;
+  auto const minIdentity{_mm256_set1_pd(aggregates.min)};
+  auto const maxIdentity{_mm256_set1_pd(aggregates.max)};
+  auto sums{_mm256_setzero_pd()};
+  auto mins{minIdentity};
+  auto maxs{maxIdentity};
+
+  std::size_t i{0U};
+  for (; i + 4U <= values.size(); i += 4U) {
+    auto const lanes{_mm256_loadu_pd(values.data() + i)};
+    auto const valid{_mm256_castsi256_pd(
+        lanesMask(validity[i / kValuesPerWord] >> (i % kValuesPerWord)))};
+
+    sums = _mm256_add_pd(sums, lanes);
+    mins = _mm256_min_pd(mins, _mm256_blendv_pd(minIdentity, lanes, valid));
+    maxs = _mm256_max_pd(maxs, _mm256_blendv_pd(maxIdentity, lanes, valid));
+  }
+
+  alignas(32) std::array<double, 4U> lanesSums{};
+  alignas(32) std::array<double, 4U> lanesMins{};
+  alignas(32) std::array<double, 4U> lanesMaxs{};
+  _mm256_store_pd(lanesSums.data(), sums);
+  _mm256_store_pd(lanesMins.data(), mins);
+  _mm256_store_pd(lanesMaxs.data(), maxs);
+
+  auto tail{aggregateScalar(values, validity, i)};
+  tail.count += countValid(validity, i);
+  tail.sum += (lanesSums[0] + lanesSums[1]) + (lanesSums[2] + lanesSums[3]);
+  for (std::size_t lane{0U}; lane < 4U; ++lane) {
+    tail.min = lanesMins[lane] < tail.min ? lanesMins[lane] : tail.min;
+    tail.max = lanesMaxs[lane] > tail.max ? lanesMaxs[lane] : tail.max;
+  }
+
+  return tail;
+}
+
+/// @brief AVX2 kernel comparing 4 Integer values
+/// @tparam kComparison the comparison to apply
+/// @param values pointer to the 4 values
+/// @param operands the value compared to, broadcast to all lanes
+/// @return the matches of the 4 values, in the low 4 bits
+template <Comparison kComparison>
+__attribute__((target("avx2"))) inline auto
+compareLanes(std::int64_t const *values, __m256i operands) noexcept
+    -> std::uint64_t {
+  auto const lanes{
+      _mm256_loadu_si256(reinterpret_cast<__m256i const *>(values))};
+
+  // AVX2 only compares 64 bit integers for equality and greater than, so the
+  // other comparisons are derived from them
+  __m256i matches{};
+  bool inverted{false};
+  switch (kComparison) {
+  case Comparison::Equal:
+  case Comparison::NotEqual:
+    matches = _mm256_cmpeq_epi64(lanes, operands);
+    inverted = kComparison == Comparison::NotEqual;
+    break;
+  case Comparison::Greater:
+  case Comparison::LessEqual:
+    matches = _mm256_cmpgt_epi64(lanes, operands);
+    inverted = kComparison == Comparison::LessEqual;
+    break;
+  case Comparison::Less:
+  case Comparison::GreaterEqual:
+    matches = _mm256_cmpgt_epi64(operands, lanes);
+    inverted = kComparison == Comparison::GreaterEqual;
+    break;
+  }
+
+  auto const bits{static_cast<std::uint64_t>(
+      _mm256_movemask_pd(_mm256_castsi256_pd(matches)))};
+  return inverted ? bits ^ 0xFU : bits;
+}
+
+/// @brief AVX2 kernel comparing 4 Real values, check the Integer overload
+template <Comparison kComparison>
+__attribute__((target("avx2"))) inline auto
+compareLanes(double const *values, __m256d operands) noexcept -> std::uint64_t {
+  auto const lanes{_mm256_loadu_pd(values)};
+
+  __m256d matches{};
+  switch (kComparison) {
+  case Comparison::Equal:
+    matches = _mm256_cmp_pd(lanes, operands, _CMP_EQ_OQ);
+    break;
+  case Comparison::NotEqual:
+    matches = _mm256_cmp_pd(lanes, operands, _CMP_NEQ_UQ);
+    break;
+  case Comparison::Less:
+    matches = _mm256_cmp_pd(lanes, operands, _CMP_LT_OQ);
+    break;
+  case Comparison::LessEqual:
+    matches = _mm256_cmp_pd(lanes, operands, _CMP_LE_OQ);
+    break;
+  case Comparison::Greater:
+    matches = _mm256_cmp_pd(lanes, operands, _CMP_GT_OQ);
+    break;
+  case Comparison::GreaterEqual:
+    matches = _mm256_cmp_pd(lanes, operands, _CMP_GE_OQ);
+    break;
+  }
+
+  return static_cast<std::uint64_t>(_mm256_movemask_pd(matches));
+}
+
+/// @brief function to broadcast an Integer value to all lanes
+/// @param value the value to broadcast
+/// @return the lanes holding the value
+__attribute__((target("avx2"))) inline auto
+broadcast(std::int64_t value) noexcept -> __m256i {
+  return _mm256_set1_epi64x(value);
+}
+
+/// @brief function to broadcast a Real value to all lanes
+/// @param value the value to broadcast
+/// @return the lanes holding the value
+__attribute__((target("avx2"))) inline auto
+broadcast(double value) noexcept -> __m256d {
+  return _mm256_set1_pd(value);
+}
+
+/// @brief AVX2 kernel comparing up to a word of values, check
+///        compareWordScalar
+template <Comparison kComparison, ColumnValue T>
+__attribute__((target("avx2"))) inline auto
+compareWordAvx2(std::span<const T> values, T operand) noexcept
+    -> std::uint64_t {
+  auto const operands{broadcast(operand)};
+
+  std::uint64_t matches{0U};
+  std::size_t i{0U};
+  for (; i + 4U <= values.size(); i += 4U) {
+    matches |= compareLanes<kComparison>(values.data() + i, operands) << i;
+  }
+
+  if (i < values.size()) {
+    matches |= compareWordScalar(values.subspan(i), kComparison, operand) << i;
+  }
+
+  return matches;
+}
+
+/// @brief function to run the AVX2 comparison kernel of a comparison known
+///        only at runtime
+template <ColumnValue T>
+auto compareWordAvx2(std::span<const T> values, Comparison comparison,
+                     T operand) noexcept -> std::uint64_t {
+  switch (comparison) {
+  case Comparison::Equal:
+    return compareWordAvx2<Comparison::Equal>(values, operand);
+  case Comparison::NotEqual:
+    return compareWordAvx2<Comparison::NotEqual>(values, operand);
+  case Comparison::Less:
+    return compareWordAvx2<Comparison::Less>(values, operand);
+  case Comparison::LessEqual:
+    return compareWordAvx2<Comparison::LessEqual>(values, operand);
+  case Comparison::Greater:
+    return compareWordAvx2<Comparison::Greater>(values, operand);
+  case Comparison::GreaterEqual:
+    return compareWordAvx2<Comparison::GreaterEqual>(values, operand);
+  }
+
+  return 0U;
+}
+
+#endif
+
+/// @brief function to check whether a kernel runs with AVX2
+/// @param isa the requested instruction set
+/// @return true if AVX2 was requested and is supported, false otherwise
+inline auto usesAvx2(KernelIsa isa) noexcept -> bool {
+#if SQL_WITH_CPP_AVX2_KERNELS
+  return isa == KernelIsa::Avx2 && avx2Supported();
+#else
+  static_cast<void>(isa);
+  return false;
+#endif
+}
+
+} // namespace detail
+
+/// @brief function to return the best instruction set supported by the
+///        running CPU, which the kernels use by default
+/// @return the best supported instruction set
+inline auto bestKernelIsa() noexcept -> KernelIsa {
+  return detail::usesAvx2(KernelIsa::Avx2) ? KernelIsa::Avx2
+                                           : KernelIsa::Scalar;
+}
+
+/// @brief function to aggregate the non-NULL values of a numeric column
+/// @tparam T the type of the values, which has to match the column type
+/// @param column the column to aggregate
+/// @param isa the instruction set to run with, where unsupported instruction
+///            sets fall back to Scalar
+/// @return the aggregates, which have a zero count if the column is not of
+///         type T
+template <ColumnValue T>
+auto aggregate(Column const &column, KernelIsa isa = bestKernelIsa()) noexcept
+    -> Aggregates<T> {
+  auto const values{detail::valuesOf<T>(column)};
+#if SQL_WITH_CPP_AVX2_KERNELS
+  if (detail::usesAvx2(isa)) {
+    return detail::aggregateAvx2(values, column.validity());
+  }
+#endif
+
+  return detail::aggregateScalar(values, column.validity());
+}
+
+/// @brief function to aggregate the values of selected rows of a numeric
+///        column, skipping NULL values
+/// @tparam T the type of the values, which has to match the column type
+/// @param column the column to aggregate
+/// @param selection the indices of the rows to aggregate, e.g. from filter
+/// @return the aggregates, which have a zero count if the column is not of
+///         type T
+template <ColumnValue T>
+auto aggregate(Column const &column, Selection_type const &selection) noexcept
+    -> Aggregates<T> {
+  auto const values{detail::valuesOf<T>(column)};
+  Aggregates<T> aggregates;
+  if (values.empty()) {
+    return aggregates;
+  }
+
+  for (auto const index : selection) {
+    if (!column.isNull(index)) {
+      detail::accumulate(aggregates, values[index]);
+    }
+  }
+
+  return aggregates;
+}
+
+/// @brief function to select the rows of a numeric column whose values match
+///        a comparison, as in WHERE column <comparison> operand
+/// @tparam T the type of the values, which has to match the column type
+/// @param column the column to filter
+/// @param comparison the comparison to apply
+/// @param operand the value compared to
+/// @param isa the instruction set to run with, where unsupported instruction
+///            sets fall back to Scalar
+/// @return the indices of the matching rows, which never include NULL values
+///         as in SQL, or no indices if the column is not of type T
+template <ColumnValue T>
+auto filter(Column const &column, Comparison comparison, T operand,
+            KernelIsa isa = bestKernelIsa()) -> Selection_type {
+  auto const values{detail::valuesOf<T>(column)};
+  auto const validity{column.validity()};
+  [[maybe_unused]] bool const avx2{detail::usesAvx2(isa)};
+
+  Selection_type selection;
+  for (std::size_t word{0U}; word * detail::kValuesPerWord < values.size();
+       ++word) {
+    auto const first{word * detail::kValuesPerWord};
+    auto const wordValues{values.subspan(
+        first, std::min(detail::kValuesPerWord, values.size() - first))};
+
+#if SQL_WITH_CPP_AVX2_KERNELS
+    auto matches{
+        avx2 ? detail::compareWordAvx2(wordValues, comparison, operand)
+             : detail::compareWordScalar(wordValues, comparison, operand)};
+#else
+    auto matches{detail::compareWordScalar(wordValues, comparison, operand)};
+#endif
+
+    for (matches &= validity[word]; matches != 0U; matches &= matches - 1U) {
+      selection.push_back(
+          static_cast<std::uint32_t>(first) +
+          static_cast<std::uint32_t>(std::countr_zero(matches)));
+    }
+  }
+
+  return selection;
+}
+
+/// @brief function to aggregate the values of a numeric column by the keys of
+///        a Text column, as in SELECT key, COUNT(value), SUM(value), ...
+///        GROUP BY key
+/// @tparam T the type of the values, which has to match the values column
+///         type
+/// @param keys the Text column of the keys, expected to have few distinct
+///             values (e.g. continents or country codes)
+/// @param values the numeric column of the values, of the same size as keys
+/// @return the groups in the order their keys first appear, where rows with
+///         NULL keys are skipped, or no groups if the columns types do not
+///         match
+/// @note keys are mapped to dense group indices once per row, reusing the
+///       previous index for runs of equal keys, so that values get
+///       accumulated into flat arrays of aggregates
+template <ColumnValue T>
+auto groupBy(Column const &keys, Column const &values)
+    -> std::vector<Group<T>> {
+  auto const valuesArray{detail::valuesOf<T>(values)};
+  if (keys.type() != ColumnType::Text || valuesArray.size() != keys.size()) {
+    return {};
+  }
+
+  std::unordered_map<std::string_view, std::size_t> groupsIndices;
+  std::vector<Group<T>> groups;
+  std::string_view previousKey;
+  std::size_t groupIndex{0U};
+
+  for (std::size_t i{0U}; i < keys.size(); ++i) {
+    if (keys.isNull(i)) {
+      continue;
+    }
+
+    auto const key{keys.text(i)};
+    if (groups.empty() || key != previousKey) {
+      auto const [it, inserted]{groupsIndices.try_emplace(key, groups.size())};
+      if (inserted) {
+        groups.push_back(Group<T>{.key = std::string{key}, .aggregates = {}});
+      }
+      groupIndex = it->second;
+      previousKey = key;
+    }
+
+    if (!values.isNull(i)) {
+      detail::accumulate(groups[groupIndex].aggregates, valuesArray[i]);
+    }
+  }
+
+  return groups;
+}
+
+} // namespace sql_with_cpp
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <sqlite3.h>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "TypeTraits.hpp"
+
+/// @brief namespace for SQL with c++
+namespace sql_with_cpp {
+
+/// @brief a concept satisfied by tuple-like types (e.g. std::tuple, std::pair
+///        and std::array), where each element maps to a column in order
+template <typename T>
+concept TupleLike = requires { std::tuple_size<T>::value; };
+
+/// @brief function to read a column of the current row of a statement as the
+///        requested type, using the sqlite3 column function matching it so no
+///        conversion to text happens for numeric columns
+/// @tparam T the type to read the column as, where integers, floating point
+///           numbers, std::string, std::string_view, std::vector<std::byte>,
+///           std::span<const std::byte> and std::optional of any of them are
+///           supported
+/// @param stmt the statement whose current row is read
+/// @param index zero-based index of the column to read
+/// @return the value of the column, where std::optional holds no value for
+///         NULL columns, and other types hold their default value instead
+/// @note std::string_view and std::span<const std::byte> refer to memory owned
+///       by the statement, which stays valid only until it is stepped again,
+///       reset or finalized
+template <typename T>
+auto readColumn(sqlite3_stmt *stmt, int index) noexcept -> T {
+  if constexpr (OptionalType<T>) {
+    if (sqlite3_column_type(stmt, index) == SQLITE_NULL) {
+      return T{};
+    }
+
+    return T{readColumn<typename T::value_type>(stmt, index)};
+  } else if constexpr (std::same_as<T, bool>) {
+    return sqlite3_column_int64(stmt, index) != 0;
+  } else if constexpr (std::integral<T>) {
+    return static_cast<T>(sqlite3_column_int64(stmt, index));
+  } else if constexpr (std::floating_point<T>) {
+    return static_cast<T>(sqlite3_column_double(stmt, index));
+  } else if constexpr (std::same_as<T, std::string> ||
+                       std::same_as<T, std::string_view>) {
+    // text has to be read before its size, so that the size accounts for
+    // any conversion SQLite does to produce the text
+    const auto *text{reinterpret_cast<const char *>( // had to because
+                                                     // sqlite3_column_text API
+                                                     // returns const unsigned
+                                                     // char* instead
+        sqlite3_column_text(stmt, index))};
+    const auto size{static_cast<std::size_t>(sqlite3_column_bytes(stmt, index))};
+
+    return text == nullptr ? T{} : T{text, size};
+  } else if constexpr (std::same_as<T, std::vector<std::byte>> ||
+                       std::same_as<T, std::span<const std::byte>>) {
+    const auto *blob{static_cast<const std::byte *>(
+        sqlite3_column_blob(stmt, index))};
+    const auto size{static_cast<std::size_t>(sqlite3_column_bytes(stmt, index))};
+
+    return blob == nullptr ? T{} : T{blob, blob + size};
+  } else {
+    static_assert(kAlwaysFalse<T>, "type cannot be read from a column");
+  }
+}
+
+/// @brief function to read the current row of a statement as the requested
+///        type
+/// @tparam Row a tuple-like type whose elements are read from the columns in
+///             the same order, or a single column type read from the first
+///             column
+/// @param stmt the statement whose current row is read
+/// @return the current row read as the requested type
+template <typename Row>
+auto readRow(sqlite3_stmt *stmt) noexcept -> Row {
+  if constexpr (TupleLike<Row>) {
+    return [stmt]<std::size_t... Indices>(std::index_sequence<Indices...>) {
+      return Row{readColumn<std::tuple_element_t<Indices, Row>>(
+          stmt, static_cast<int>(Indices))...};
+    }(std::make_index_sequence<std::tuple_size_v<Row>>{});
+  } else {
+    return readColumn<Row>(stmt, 0);
+  }
+}
+
+/// @brief function to return how many columns the requested row type reads
+/// @tparam Row a tuple-like type or a single column type
+/// @return number of columns read by the row type
+template <typename Row> consteval auto columnsCountOf() noexcept -> std::size_t {
+  if constexpr (TupleLike<Row>) {
+    return std::tuple_size_v<Row>;
+  } else {
+    return 1U;
+  }
+}
+
+} // namespace sql_with_cpp
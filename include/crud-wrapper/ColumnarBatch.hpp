@@ -0,0 +1,325 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <sqlite3.h>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/// @brief namespace for SQL with c++
+namespace sql_with_cpp {
+
+/// @brief types of the values stored by a column of a columnar batch
+enum class ColumnType { Integer, Real, Text };
+
+/// @brief function to return the column type matching the affinity SQLite
+///        gives to a declared column type
+/// @param declaredType the declared type of a column (e.g. "int(11)")
+/// @return the column type, or std::nullopt for BLOB affinity (including
+///         columns without a declared type), whose values could be of any
+///         type
+/// @note it follows the rules of https://www.sqlite.org/datatype3.html, except
+///       for NUMERIC affinity, which is read as Real
+inline auto columnTypeOfDeclaredType(std::string_view declaredType) noexcept
+    -> std::optional<ColumnType> {
+  auto const contains{[declaredType](std::string_view pattern) {
+    return std::ranges::search(declaredType, pattern, [](char lhs, char rhs) {
+             return (lhs | 0x20) == (rhs | 0x20);
+           }).size() == pattern.size();
+  }};
+
+  if (contains("INT")) {
+    return ColumnType::Integer;
+  }
+  if (contains("CHAR") || contains("CLOB") || contains("TEXT")) {
+    return ColumnType::Text;
+  }
+  if (declaredType.empty() || contains("BLOB")) {
+    return std::nullopt;
+  }
+
+  return ColumnType::Real;
+}
+
+/// @brief a column of a columnar batch, storing its values contiguously in an
+///        array matching its type, along with a validity bitmap for NULLs
+/// @note the layout follows Apache Arrow: bit i of the validity bitmap is set
+///       if value i is not NULL, NULL values hold zero (or an empty text) in
+///       the values arrays, and texts are stored back to back in a single
+///       buffer delimited by an offsets array of size() + 1 elements
+class Column {
+public:
+  /// @brief parametrized constructor for an empty column
+  /// @param name the name of the column
+  /// @param type the type of the column, or std::nullopt to take the type of
+  ///             the first non-NULL value appended
+  Column(std::string name, std::optional<ColumnType> type) noexcept
+      : m_name{std::move(name)}, m_type{type} {}
+
+  /// @brief method to return the name of the column
+  /// @return the name of the column
+  [[nodiscard]] auto name() const noexcept -> std::string const & {
+    return m_name;
+  }
+
+  /// @brief method to return the type of the column
+  /// @return the type of the column, which is Integer if it was not declared,
+  ///         and all its values are NULL
+  [[nodiscard]] auto type() const noexcept -> ColumnType {
+    return m_type.value_or(ColumnType::Integer);
+  }
+
+  /// @brief method to return the number of values of the column
+  /// @return the number of values
+  [[nodiscard]] auto size() const noexcept -> std::size_t { return m_size; }
+
+  /// @brief method to return the number of NULL values of the column
+  /// @return the number of NULL values
+  [[nodiscard]] auto nullCount() const noexcept -> std::size_t {
+    return m_nullCount;
+  }
+
+  /// @brief method to check whether a value is NULL
+  /// @param index the index of the value
+  /// @return true if the value is NULL, false otherwise
+  [[nodiscard]] auto isNull(std::size_t index) const noexcept -> bool {
+    return (m_validity[index / kBitsPerWord] &
+            (std::uint64_t{1U} << (index % kBitsPerWord))) == 0U;
+  }
+
+  /// @brief method to return the validity bitmap of the column
+  /// @return the words of the bitmap, where bit i of word i / 64 is set if
+  ///         value i is not NULL
+  [[nodiscard]] auto
+  validity() const noexcept -> std::span<const std::uint64_t> {
+    return m_validity;
+  }
+
+  /// @brief method to return the values of an Integer column
+  /// @return the values, or an empty span for columns of other types
+  [[nodiscard]] auto
+  integers() const noexcept -> std::span<const std::int64_t> {
+    return m_integers;
+  }
+
+  /// @brief method to return the values of a Real column
+  /// @return the values, or an empty span for columns of other types
+  [[nodiscard]] auto reals() const noexcept -> std::span<const double> {
+    return m_reals;
+  }
+
+  /// @brief method to return the offsets delimiting the values of a Text
+  ///        column in its characters buffer
+  /// @return the offsets, where value i spans [offsets[i], offsets[i + 1]),
+  ///         or an empty span for columns of other types
+  [[nodiscard]] auto
+  offsets() const noexcept -> std::span<const std::uint64_t> {
+    return type() == ColumnType::Text ? std::span<const std::uint64_t>{m_offsets}
+                                      : std::span<const std::uint64_t>{};
+  }
+
+  /// @brief method to return the characters buffer of a Text column
+  /// @return the characters of all the values, back to back
+  [[nodiscard]] auto characters() const noexcept -> std::string_view {
+    return m_characters;
+  }
+
+  /// @brief method to return a value of a Text column
+  /// @param index the index of the value
+  /// @return view to the value, which is empty for NULL values
+  [[nodiscard]] auto text(std::size_t index) const noexcept
+      -> std::string_view {
+    return std::string_view{m_characters}.substr(
+        m_offsets[index], m_offsets[index + 1U] - m_offsets[index]);
+  }
+
+  /// @brief method to append the value of a column of the current row of a
+  ///        stepped statement, converting it to the type of this column
+  /// @param stmt the stepped statement
+  /// @param index the index of the column in the statement
+  void append(sqlite3_stmt *stmt, int index) {
+    auto const valueType{sqlite3_column_type(stmt, index)};
+    bool const isValid{valueType != SQLITE_NULL};
+
+    if (!m_type.has_value() && isValid) {
+      resolveType(valueType);
+    }
+
+    if (m_size % kBitsPerWord == 0U) {
+      m_validity.push_back(0U);
+    }
+    if (isValid) {
+      m_validity.back() |= std::uint64_t{1U} << (m_size % kBitsPerWord);
+    } else {
+      ++m_nullCount;
+    }
+    ++m_size;
+
+    if (!m_type.has_value()) {
+      return;
+    }
+
+    switch (*m_type) {
+    case ColumnType::Integer:
+      m_integers.push_back(isValid ? sqlite3_column_int64(stmt, index) : 0);
+      break;
+    case ColumnType::Real:
+      m_reals.push_back(isValid ? sqlite3_column_double(stmt, index) : 0.0);
+      break;
+    case ColumnType::Text:
+      if (isValid) {
+        // text has to be read before its size, so that the size accounts
+        // for any conversion SQLite does to produce the text
+        auto const *text{reinterpret_cast<char const *>(
+            sqlite3_column_text(stmt, index))};
+        m_characters.append(text, static_cast<std::size_t>(
+                                      sqlite3_column_bytes(stmt, index)));
+      }
+      m_offsets.push_back(m_characters.size());
+      break;
+    }
+  }
+
+  /// @brief method to complete a column whose type was never resolved, since
+  ///        all its values were NULL, which is read as an Integer column
+  void finish() {
+    if (!m_type.has_value()) {
+      resolveType(SQLITE_INTEGER);
+    }
+  }
+
+private:
+  /// @brief number of bits per word of the validity bitmap
+  static constexpr std::size_t kBitsPerWord{64U};
+
+  /// @brief the name of the column
+  std::string m_name;
+
+  /// @brief the type of the column, once resolved
+  std::optional<ColumnType> m_type;
+
+  /// @brief the number of values
+  std::size_t m_size{0U};
+
+  /// @brief the number of NULL values
+  std::size_t m_nullCount{0U};
+
+  /// @brief the validity bitmap
+  std::vector<std::uint64_t> m_validity;
+
+  /// @brief the values of an Integer column
+  std::vector<std::int64_t> m_integers;
+
+  /// @brief the values of a Real column
+  std::vector<double> m_reals;
+
+  /// @brief the offsets of the values of a Text column
+  std::vector<std::uint64_t> m_offsets{0U};
+
+  /// @brief the characters of the values of a Text column
+  std::string m_characters;
+
+  /// @brief private method to resolve the type of the column from the type
+  ///        of a value, filling the values appended so far, which are NULLs
+  /// @param valueType the sqlite3 fundamental type of the value
+  void resolveType(int valueType) {
+    switch (valueType) {
+    case SQLITE_INTEGER:
+      m_type = ColumnType::Integer;
+      m_integers.resize(m_size, 0);
+      break;
+    case SQLITE_FLOAT:
+      m_type = ColumnType::Real;
+      m_reals.resize(m_size, 0.0);
+      break;
+    default:
+      m_type = ColumnType::Text;
+      m_offsets.resize(m_size + 1U, 0U);
+      break;
+    }
+  }
+};
+
+/// @brief the result of a statement stored column by column, so that each
+///        column can be processed in tight loops over contiguous arrays
+class ColumnarBatch {
+public:
+  /// @brief method to read the columns of a statement from its declared
+  ///        types, which has to be called once before appending rows
+  /// @param stmt the statement to read the columns of
+  void readColumns(sqlite3_stmt *stmt) {
+    auto const columnsCount{sqlite3_column_count(stmt)};
+    m_columns.reserve(static_cast<std::size_t>(columnsCount));
+
+    for (int i{0}; i < columnsCount; ++i) {
+      char const *declaredType{sqlite3_column_decltype(stmt, i)};
+      m_columns.emplace_back(sqlite3_column_name(stmt, i),
+                             declaredType == nullptr
+                                 ? std::nullopt
+                                 : columnTypeOfDeclaredType(declaredType));
+    }
+  }
+
+  /// @brief method to append the current row of a stepped statement
+  /// @param stmt the statement whose current row gets appended
+  void appendRow(sqlite3_stmt *stmt) {
+    for (std::size_t i{0U}; i < m_columns.size(); ++i) {
+      m_columns[i].append(stmt, static_cast<int>(i));
+    }
+    ++m_rowsCount;
+  }
+
+  /// @brief method to complete the batch once all its rows were appended
+  void finish() {
+    std::ranges::for_each(m_columns, &Column::finish);
+  }
+
+  /// @brief method to return the number of rows
+  /// @return the number of rows
+  [[nodiscard]] auto rowsCount() const noexcept -> std::size_t {
+    return m_rowsCount;
+  }
+
+  /// @brief method to return the number of columns
+  /// @return the number of columns
+  [[nodiscard]] auto columnsCount() const noexcept -> std::size_t {
+    return m_columns.size();
+  }
+
+  /// @brief method to return all the columns
+  /// @return span of the columns, in the order of the statement
+  [[nodiscard]] auto columns() const noexcept -> std::span<const Column> {
+    return m_columns;
+  }
+
+  /// @brief method to return a column given its index
+  /// @param index the index of the column
+  /// @return reference to the column
+  [[nodiscard]] auto
+  column(std::size_t index) const noexcept -> Column const & {
+    return m_columns[index];
+  }
+
+  /// @brief method to look a column up by its name
+  /// @param name the name of the column
+  /// @return pointer to the column, or nullptr if there is no such column
+  [[nodiscard]] auto
+  column(std::string_view name) const noexcept -> Column const * {
+    auto const it{std::ranges::find(m_columns, name, &Column::name)};
+    return it == m_columns.end() ? nullptr : &*it;
+  }
+
+private:
+  /// @brief the columns of the batch
+  std::vector<Column> m_columns;
+
+  /// @brief the number of rows
+  std::size_t m_rowsCount{0U};
+};
+
+} // namespace sql_with_cpp
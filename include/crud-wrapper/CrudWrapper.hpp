@@ -1,39 +1,58 @@
 #pragma once
 
+#include <algorithm>
 #include <concepts>
+#include <cstddef>
+#include <cstdint>
 #include <exception>
 #include <filesystem>
+#include <limits>
 #include <memory>
+#include <memory_resource>
+#include <optional>
+#include <ranges>
+#include <span>
 #include <sqlite3.h>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <variant>
 #include <vector>
 
+#include "ColumnReader.hpp"
+#include "ColumnarBatch.hpp"
+#include "CrudWrapperOptions.hpp"
 #include "ICruddable.hpp"
+#include "InMemoryMirror.hpp"
+#include "Pagination.hpp"
+#include "Query.hpp"
+#include "QueryRange.hpp"
+#include "ResultCache.hpp"
+#include "ResultSet.hpp"
+#include "RowMapping.hpp"
+#include "SchemaCatalog.hpp"
+#include "ScriptLoader.hpp"
+#include "Sqlite3Handles.hpp"
+#include "StatementCache.hpp"
+#include "StatementProfiler.hpp"
+#include "TypeTraits.hpp"
 
 /// @brief namespace for SQL with c++
 namespace sql_with_cpp {
 
+/// @brief the ways a transaction acquires its locks, as in BEGIN DEFERRED,
+///        BEGIN IMMEDIATE and BEGIN EXCLUSIVE
+enum class TransactionMode { Deferred, Immediate, Exclusive };
+
 /// @brief class for CRUD operations implementing the interface ICruddable
 /// @note this class is based on sqlite3 database engine
 class CrudWrapper : public ICruddable {
-  /// @brief a custom deleter for sqlite3
-  struct Sqlite3Closer {
-    void operator()(sqlite3 *p) const { sqlite3_close(p); }
-  };
-
-  /// @brief a custom deleter for sqlite3_stmt
-  struct Sqlite3StmtCloser {
-    void operator()(sqlite3_stmt *p) const { sqlite3_finalize(p); }
-  };
-
-  /// @brief a type alias for sqlite3 database unique pointer type used
-  using Db_Ptr_type = std::unique_ptr<sqlite3, Sqlite3Closer>;
-
-  /// @brief a type alias for sqlite3 statement unique pointer type used
-  using Stmt_Ptr_type = std::unique_ptr<sqlite3_stmt, Sqlite3StmtCloser>;
-
   /// @brief a class that represents prepared statements in SQLite3 for
   ///        rebinding and reusability
+  /// @note the underlying statement is checked out of the statement cache of
+  ///       the CrudWrapper object it was prepared by, and is handed back to it
+  ///       on destruction, so it must not outlive that object
   class PreparedStatement {
   public:
     /// @brief deleted default constructor for allowing only construction with
@@ -49,40 +68,132 @@ class CrudWrapper : public ICruddable {
     /// @param statement the statement to be prepared
     /// @param cruddableObject the object that wraps the database for which the
     ///                        statement is prepared
-    PreparedStatement(std::string const &statement,
+    PreparedStatement(std::string_view statement,
                       CrudWrapper const &crudWrapperObj) noexcept
-        : m_stmt{initializeStatement(statement, crudWrapperObj.m_db)} {}
+        : m_stmt{crudWrapperObj.m_stmtCache->take(statement)},
+          m_cache{crudWrapperObj.m_stmtCache.get()},
+          m_cacheGeneration{m_cache->generation()} {
+      if (m_stmt == nullptr) {
+        m_stmt = initializeStatement(statement, crudWrapperObj.m_db,
+                                     crudWrapperObj.m_profiler.get());
+      }
+
+      // SQLite keeps the text of the statement only, dropping any trailing
+      // text, so the text it was looked up by is kept to hand it back by
+      if (m_stmt != nullptr && statement != sqlite3_sql(m_stmt.get())) {
+        m_lookupKey = statement;
+      }
+    }
+
+    /// @brief deleted copy operations, as the statement has a unique owner
+    PreparedStatement(PreparedStatement const &) = delete;
+    auto operator=(PreparedStatement const &) -> PreparedStatement & = delete;
+
+    /// @brief move constructor that takes over the statement of other
+    /// @param other the prepared statement to move from
+    PreparedStatement(PreparedStatement &&other) noexcept
+        : m_stmt{std::move(other.m_stmt)}, m_cache{other.m_cache},
+          m_cacheGeneration{other.m_cacheGeneration},
+          m_lookupKey{std::move(other.m_lookupKey)} {}
+
+    /// @brief move assignment operator that hands the currently owned
+    ///        statement back to the cache before taking over other's
+    /// @param other the prepared statement to move from
+    /// @return reference to this object
+    auto operator=(PreparedStatement &&other) noexcept -> PreparedStatement & {
+      if (this != &other) {
+        handBackToCache();
+        m_stmt = std::move(other.m_stmt);
+        m_cache = other.m_cache;
+        m_cacheGeneration = other.m_cacheGeneration;
+        m_lookupKey = std::move(other.m_lookupKey);
+      }
+
+      return *this;
+    }
+
+    /// @brief destructor that hands the statement back to the cache for
+    ///        later reuse
+    ~PreparedStatement() noexcept { handBackToCache(); }
 
     /// @brief method to bind text to placeholder parameters according to sqlite
     ///        syntax
     /// @param text text to bind
     /// @param position position of placeholder to bind that text to
     /// @return true if binding text was successful, false otherwise
+    /// @note the text is copied by SQLite, check bindTextView for a binding
+    ///       that avoids the copy
     auto bindText(std::string const &text,
                   std::size_t position) noexcept -> bool {
+      return rebind(text, position);
+    }
+
+    /// @brief method to bind text to placeholder parameters without copying it
+    /// @param text view to the text to bind
+    /// @param position position of placeholder to bind that text to
+    /// @return true if binding text was successful, false otherwise
+    /// @note the caller guarantees that the viewed characters stay valid until
+    ///       the statement is rebound, or until it is done being executed,
+    ///       which is the contract SQLite requires for SQLITE_STATIC
+    auto bindTextView(std::string_view text,
+                      std::size_t position) noexcept -> bool {
+      return rebind(text, position);
+    }
+
+    /// @brief method to bind an integer to placeholder parameters
+    /// @param value integer to bind, which is stored as a 64-bit integer
+    /// @param position position of placeholder to bind that integer to
+    /// @return true if binding the integer was successful, false otherwise
+    auto bind(std::integral auto value, std::size_t position) noexcept -> bool {
+      return rebind(value, position);
+    }
+
+    /// @brief method to bind a floating point number to placeholder parameters
+    /// @param value floating point number to bind, which is stored as a double
+    /// @param position position of placeholder to bind that number to
+    /// @return true if binding the number was successful, false otherwise
+    auto bind(std::floating_point auto value,
+              std::size_t position) noexcept -> bool {
+      return rebind(value, position);
+    }
+
+    /// @brief method to bind a blob to placeholder parameters without copying
+    /// @param blob view to the bytes to bind
+    /// @param position position of placeholder to bind that blob to
+    /// @return true if binding the blob was successful, false otherwise
+    /// @note the same lifetime contract of bindTextView applies here as well
+    auto bind(std::span<const std::byte> blob,
+              std::size_t position) noexcept -> bool {
+      return rebind(blob, position);
+    }
+
+    /// @brief method to bind NULL to placeholder parameters
+    /// @param position position of placeholder to bind NULL to
+    /// @return true if binding NULL was successful, false otherwise
+    auto bindNull(std::size_t position) noexcept -> bool {
+      return rebind(nullptr, position);
+    }
+
+    /// @brief method to bind all the passed values to the placeholders of
+    ///        positions 1 to N in a single call
+    /// @param values the values to bind, where integers, floating point
+    ///               numbers, texts, blobs, nullptr, std::nullopt and
+    ///               std::optional of any of them are supported
+    /// @return true if binding all the values was successful, false otherwise
+    /// @note owning values (i.e. std::string and std::vector<std::byte>) are
+    ///       copied by SQLite, while views (i.e. std::string_view, character
+    ///       pointers and std::span<const std::byte>) are bound without a copy
+    ///       under the same lifetime contract of bindTextView
+    template <typename... Values>
+    auto bindAll(Values const &...values) noexcept -> bool {
       if (m_stmt == nullptr) {
         return false;
       }
 
-      // reset is necessary before calling bind() in case of rebinding with
-      // new parameter after bind was called before to the same statement
       sqlite3_reset(m_stmt.get());
 
-      constexpr auto useStrLenInternally{-1};
-      const int rCode{sqlite3_bind_text(
-          m_stmt.get(), static_cast<int>(position), text.c_str(),
-          useStrLenInternally,
-          // Very important note for below parameter:
-          // I faced errors with ASAN when using SQLITE_STATIC
-          // instead of SQLITE_TRANSIENT
-          // SQLITE_TRANSIENT tells SQLite to copy the string
-          // while SQLITE_STATIC means you guarantee that the string will be
-          // valid until after the query is executed, which might not be the
-          // case when using std::string::c_str()
-          // So, it might be better to play it safe with this parameter
-          SQLITE_TRANSIENT)};
-
-      return {rCode == SQLITE_OK};
+      int position{0};
+      return (... && (bindValue(values, ++position) == SQLITE_OK));
     }
 
     /// @brief method to return immutable reference to the underlying statement
@@ -94,9 +205,274 @@ class CrudWrapper : public ICruddable {
   private:
     /// @brief unique pointer to the underlying sqlite3 statement object
     Stmt_Ptr_type m_stmt{nullptr};
+
+    /// @brief the statement cache to hand the statement back to
+    StatementCache *m_cache{nullptr};
+
+    /// @brief generation of the cache at the time the statement was taken
+    std::uint64_t m_cacheGeneration{0U};
+
+    /// @brief the SQL text the statement was looked up by, if it differs from
+    ///        the text SQLite keeps for it, which is empty otherwise
+    std::string m_lookupKey;
+
+    /// @brief private method to bind a single value after resetting the
+    ///        statement
+    /// @param value the value to bind
+    /// @param position position of placeholder to bind that value to
+    /// @return true if binding the value was successful, false otherwise
+    auto rebind(auto const &value, std::size_t position) noexcept -> bool {
+      if (m_stmt == nullptr) {
+        return false;
+      }
+
+      // reset is necessary before calling bind() in case of rebinding with
+      // new parameter after bind was called before to the same statement
+      sqlite3_reset(m_stmt.get());
+
+      return {bindValue(value, static_cast<int>(position)) == SQLITE_OK};
+    }
+
+    /// @brief private method to bind a single value using the sqlite3 binding
+    ///        function that matches its type, without resetting the statement
+    /// @param value the value to bind
+    /// @param position position of placeholder to bind that value to
+    /// @return the sqlite3 result code of the binding
+    template <typename T>
+    auto bindValue(T const &value, int position) noexcept -> int {
+      if constexpr (std::same_as<T, std::nullptr_t> ||
+                    std::same_as<T, std::nullopt_t>) {
+        return sqlite3_bind_null(m_stmt.get(), position);
+      } else if constexpr (OptionalType<T>) {
+        return value.has_value() ? bindValue(*value, position)
+                                 : sqlite3_bind_null(m_stmt.get(), position);
+      } else if constexpr (std::integral<T>) {
+        return sqlite3_bind_int64(m_stmt.get(), position,
+                                  static_cast<sqlite3_int64>(value));
+      } else if constexpr (std::floating_point<T>) {
+        return sqlite3_bind_double(m_stmt.get(), position,
+                                   static_cast<double>(value));
+      } else if constexpr (std::same_as<T, std::string>) {
+        // Very important note for SQLITE_TRANSIENT below:
+        // I faced errors with ASAN when using SQLITE_STATIC
+        // instead of SQLITE_TRANSIENT
+        // SQLITE_TRANSIENT tells SQLite to copy the string
+        // while SQLITE_STATIC means you guarantee that the string will be
+        // valid until after the query is executed, which might not be the
+        // case when using std::string::c_str()
+        // So, it might be better to play it safe with owning strings
+        return sqlite3_bind_text64(m_stmt.get(), position, value.data(),
+                                   value.size(), SQLITE_TRANSIENT,
+                                   SQLITE_UTF8);
+      } else if constexpr (std::convertible_to<T const &, std::string_view>) {
+        std::string_view const text{value};
+        // a null data pointer would bind NULL instead of an empty text
+        return sqlite3_bind_text64(m_stmt.get(), position,
+                                   text.empty() ? "" : text.data(),
+                                   text.size(), SQLITE_STATIC, SQLITE_UTF8);
+      } else if constexpr (std::same_as<T, std::vector<std::byte>>) {
+        return value.empty()
+                   ? sqlite3_bind_zeroblob(m_stmt.get(), position, 0)
+                   : sqlite3_bind_blob64(m_stmt.get(), position, value.data(),
+                                         value.size(), SQLITE_TRANSIENT);
+      } else if constexpr (std::convertible_to<T const &,
+                                               std::span<const std::byte>>) {
+        std::span<const std::byte> const blob{value};
+        // a null data pointer would bind NULL instead of an empty blob
+        return blob.empty()
+                   ? sqlite3_bind_zeroblob(m_stmt.get(), position, 0)
+                   : sqlite3_bind_blob64(m_stmt.get(), position, blob.data(),
+                                         blob.size(), SQLITE_STATIC);
+      } else {
+        static_assert(kAlwaysFalse<T>, "type cannot be bound to a statement");
+      }
+    }
+
+    /// @brief private method to hand the owned statement back to the cache
+    void handBackToCache() noexcept {
+      if (m_cache != nullptr) {
+        m_cache->give(std::move(m_stmt), m_cacheGeneration, m_lookupKey);
+      }
+    }
   };
 
 public:
+  /// @brief RAII guard of a transaction, which is rolled back on destruction
+  ///        unless it was committed, so that early returns and exceptions
+  ///        never leave half of its writes behind
+  /// @note a transaction begun while another one is open is nested into it
+  ///       as a savepoint, whose commit and rollback release and roll back
+  ///       to the savepoint, leaving the outer transaction open
+  /// @note nested transactions have to end before the transactions they are
+  ///       nested into, and a transaction must not outlive the CrudWrapper
+  ///       object it was begun on
+  class Transaction {
+  public:
+    /// @brief deleted default constructor for allowing only construction on
+    ///        a database
+    Transaction() = delete;
+
+    /// @brief parametrized constructor that begins the transaction, or the
+    ///        savepoint if a transaction is already open
+    /// @param crudWrapperObj the object wrapping the database
+    /// @param mode how the transaction acquires its locks, which is ignored
+    ///             by savepoints, as they share the locks of their
+    ///             transaction
+    /// @note the guard is inactive if the transaction could not be begun,
+    ///       check isActive()
+    Transaction(CrudWrapper &crudWrapperObj, TransactionMode mode) noexcept {
+      bool begun{false};
+      if (sqlite3_get_autocommit(crudWrapperObj.m_db.get()) == 0) {
+        m_savepoint = "crud_wrapper_savepoint_" +
+                      std::to_string(crudWrapperObj.m_savepointsCount);
+        begun = crudWrapperObj.runStatement("SAVEPOINT " + m_savepoint);
+        if (begun) {
+          ++crudWrapperObj.m_savepointsCount;
+        }
+      } else {
+        begun = crudWrapperObj.runStatement(beginStatement(mode));
+      }
+
+      if (begun) {
+        m_crudWrapper = &crudWrapperObj;
+      }
+    }
+
+    /// @brief deleted copy operations, as a transaction has a single owner
+    Transaction(Transaction const &) = delete;
+    auto operator=(Transaction const &) -> Transaction & = delete;
+
+    /// @brief move constructor that takes over the transaction of other
+    /// @param other the transaction to move from
+    Transaction(Transaction &&other) noexcept
+        : m_crudWrapper{std::exchange(other.m_crudWrapper, nullptr)},
+          m_savepoint{std::move(other.m_savepoint)} {}
+
+    /// @brief move assignment operator that rolls the current transaction
+    ///        back before taking over the transaction of other
+    /// @param other the transaction to move from
+    /// @return reference to this object
+    auto operator=(Transaction &&other) noexcept -> Transaction & {
+      if (this != &other) {
+        rollback();
+        m_crudWrapper = std::exchange(other.m_crudWrapper, nullptr);
+        m_savepoint = std::move(other.m_savepoint);
+      }
+
+      return *this;
+    }
+
+    /// @brief destructor that rolls the transaction back unless it ended
+    ~Transaction() noexcept { rollback(); }
+
+    /// @brief method to commit the transaction, or release the savepoint
+    /// @return true if committed, false if the transaction is not active or
+    ///         could not be committed, in which case it stays active (e.g.
+    ///         when COMMIT gets SQLITE_BUSY)
+    auto commit() noexcept -> bool {
+      if (m_crudWrapper == nullptr) {
+        return false;
+      }
+
+      if (!m_crudWrapper->runStatement(
+              m_savepoint.empty() ? "COMMIT" : "RELEASE " + m_savepoint)) {
+        return false;
+      }
+
+      end();
+      return true;
+    }
+
+    /// @brief method to roll the transaction back, or roll back to the
+    ///        savepoint and release it
+    /// @return true if rolled back, false if the transaction is not active
+    ///         or could not be rolled back
+    /// @note the transaction ends even if it could not be rolled back
+    auto rollback() noexcept -> bool {
+      if (m_crudWrapper == nullptr) {
+        return false;
+      }
+
+      // SQLite rolls the whole transaction back on some errors (e.g.
+      // SQLITE_FULL), after which there is nothing left to roll back
+      bool rolledBack{true};
+      if (sqlite3_get_autocommit(m_crudWrapper->m_db.get()) == 0) {
+        rolledBack = m_savepoint.empty()
+                         ? m_crudWrapper->runStatement("ROLLBACK")
+                         : m_crudWrapper->runStatement("ROLLBACK TO " +
+                                                       m_savepoint) &&
+                               m_crudWrapper->runStatement("RELEASE " +
+                                                           m_savepoint);
+      }
+      // rolling back may undo schema changes as well
+      m_crudWrapper->refreshSchemaVersion();
+
+      end();
+      return rolledBack;
+    }
+
+    /// @brief method to check whether the transaction is open, i.e. it was
+    ///        begun and neither committed nor rolled back yet
+    /// @return true if the transaction is open, false otherwise
+    [[nodiscard]] auto isActive() const noexcept -> bool {
+      return m_crudWrapper != nullptr;
+    }
+
+    /// @brief method to check whether the transaction is a savepoint nested
+    ///        into another transaction
+    /// @return true if the transaction is a savepoint, false otherwise
+    [[nodiscard]] auto isNested() const noexcept -> bool {
+      return !m_savepoint.empty();
+    }
+
+  private:
+    /// @brief the object wrapping the database, or nullptr once the
+    ///        transaction ended
+    CrudWrapper *m_crudWrapper{nullptr};
+
+    /// @brief the name of the savepoint, which is empty for transactions
+    ///        that are not nested
+    std::string m_savepoint;
+
+    /// @brief private method to mark the transaction as ended, forgetting
+    ///        its savepoint, or writing the changes of an in-memory mirror
+    ///        back once the outermost transaction ended
+    void end() noexcept {
+      if (m_savepoint.empty()) {
+        m_crudWrapper->syncMirrorIfDue();
+      } else {
+        --m_crudWrapper->m_savepointsCount;
+      }
+      m_crudWrapper = nullptr;
+    }
+
+    /// @brief private static method to return the statement beginning a
+    ///        transaction
+    /// @param mode how the transaction acquires its locks
+    /// @return the BEGIN statement
+    static auto beginStatement(TransactionMode mode) noexcept
+        -> std::string {
+      switch (mode) {
+      case TransactionMode::Immediate:
+        return "BEGIN IMMEDIATE";
+      case TransactionMode::Exclusive:
+        return "BEGIN EXCLUSIVE";
+      case TransactionMode::Deferred:
+        break;
+      }
+
+      return "BEGIN DEFERRED";
+    }
+  };
+
+  /// @brief flags used to open the database when none are specified, which
+  ///        match the behavior of sqlite3_open
+  static constexpr int kDefaultOpenFlags{CrudWrapperOptions{}.openFlags};
+
+  /// @brief number of rows committed per transaction by bulkInsert when none
+  ///        is specified explicitly
+  static constexpr std::size_t kDefaultBulkInsertBatchSize{1000U};
+
   /// @brief deleted default constructor for allowing only construction when
   ///        passing a path to the database
   /// @note this is the default behavior since a parametrized constructor is
@@ -107,27 +483,90 @@ public:
   /// @param path filesystem path to the database
   explicit CrudWrapper(
       const std::convertible_to<std::filesystem::path> auto &path)
+      : CrudWrapper{path, CrudWrapperOptions{}} {}
+
+  /// @brief parametrized constructor for CRUD wrapper class that opens the
+  ///        database with the given flags
+  /// @param path filesystem path to the database
+  /// @param openFlags flags passed to sqlite3_open_v2 (e.g.
+  ///                  SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX)
+  CrudWrapper(const std::convertible_to<std::filesystem::path> auto &path,
+              int openFlags)
+      : CrudWrapper{path, CrudWrapperOptions{.openFlags = openFlags,
+                                             .pragmas = {},
+                                             .statementCacheCapacity =
+                                                 StatementCache::
+                                                     kDefaultCapacity,
+                                             .mirror = std::nullopt,
+                                             .busyPolicy = std::nullopt}} {}
+
+  /// @brief parametrized constructor for CRUD wrapper class that opens the
+  ///        database with the given options, and applies their PRAGMA
+  ///        settings (e.g. CrudWrapperOptions::forProfile(profile))
+  /// @param path filesystem path to the database
+  /// @param options flags, PRAGMA settings, statement cache capacity,
+  ///                in-memory mirror and busy policy
+  /// @throws std::runtime_error if the database can't be opened, or one of
+  ///         the PRAGMA settings fails to apply
+  /// @note PRAGMA settings that SQLite refuses without failing (e.g. changing
+  ///       the journal mode of a read-only database) are kept at their
+  ///       current values, check effectiveSettings() for the values in effect
+  /// @note a mirrored database is copied into memory with the backup API,
+  ///       so reads never touch the file afterwards, and its journal mode is
+  ///       always memory; the load time is reported by mirrorStats()
+  CrudWrapper(const std::convertible_to<std::filesystem::path> auto &path,
+              CrudWrapperOptions const &options)
       : m_db_path{path} {
     if (std::error_code err; std::filesystem::exists(m_db_path, err) == false) {
       throw std::filesystem::filesystem_error(
           "Path to database not found! Error code: ", err);
     }
 
+    // a mirror is a private in-memory database, keeping the threading mode
+    // of the requested flags
+    auto const mirrorOpenFlags{
+        SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_MEMORY |
+        (options.openFlags & (SQLITE_OPEN_NOMUTEX | SQLITE_OPEN_FULLMUTEX))};
+
+    auto const isMirrored{options.mirror.has_value()};
     sqlite3 *dbPtr{nullptr};
-    const int rCode{sqlite3_open(m_db_path.string().c_str(), &dbPtr)};
+    constexpr auto defaultVfs{nullptr};
+    const int rCode{sqlite3_open_v2(
+        isMirrored ? ":memory:" : m_db_path.string().c_str(), &dbPtr,
+        isMirrored ? mirrorOpenFlags : options.openFlags, defaultVfs)};
+
+    // the handle is allocated even on failure, so it has to be closed
+    m_db = Db_Ptr_type{dbPtr};
     if (rCode != SQLITE_OK) {
       throw std::runtime_error(
           std::string{"Failed to open database, sqlite3 error: "} +
           sqlite3_errstr(rCode));
     }
 
-    m_db = Db_Ptr_type{dbPtr};
+    if (options.busyPolicy.has_value()) {
+      m_busyHandler = std::make_unique<BusyHandler>(*options.busyPolicy);
+      m_busyHandler->install(m_db.get());
+    }
+
+    if (isMirrored) {
+      m_mirror = std::make_unique<InMemoryMirror>(
+          m_db.get(), m_db_path, options.openFlags, *options.mirror);
+      if ((options.openFlags & SQLITE_OPEN_READWRITE) == 0) {
+        runStatement("PRAGMA query_only=1");
+      }
+    }
+
+    m_stmtCache->setCapacity(options.statementCacheCapacity);
+    applyPragmas(options.pragmas);
+    m_schemaVersion = readSchemaVersion();
   }
 
   /// @brief a class method that returns a prepared statement object based on
   ///        the passed statement parameter for reusability
   /// @param statement the statement to be prepared
   /// @return a prepared statement object based on the passed statement
+  /// @note the statement is taken from the statement cache if an idle one
+  ///       was prepared before for the same SQL text
   auto prepareStatement(std::string const &statement) const noexcept
       -> PreparedStatement {
     return PreparedStatement{statement, *this};
@@ -135,17 +574,44 @@ public:
 
   /// @brief implementation for the interface method
   /// @note for further info, check the interface documentation
+  /// @note names of tables and views are served from the schema catalog,
+  ///       check tableInfo, while other names (e.g. "main.City") are peeked
+  ///       by preparing a SELECT statement
   auto peekColumnsNames(std::string const &tableName) const
       -> std::vector<std::string> override {
+    if (auto const table{tableInfo(tableName)}) {
+      return table->columnsNames;
+    }
+
     return getColumnsNamesFromStatement(
-        buildSelectAllFromTableStatement(tableName));
+        buildSelectAllFromTableStatement(tableName).get());
+  }
+
+  /// @brief method to return the metadata of a table or a view, which is
+  ///        loaded once into the schema catalog of this object, and loaded
+  ///        again only once the schema version of the database changes
+  /// @param tableName the name of the table, compared case-insensitively
+  /// @return the metadata of the table, or nullptr if there is no such table
+  /// @note checking the schema version costs two PRAGMA steps per call, one
+  ///       for the main database and one for the temp database
+  auto tableInfo(std::string const &tableName) const
+      -> std::shared_ptr<const TableInfo> {
+    m_schemaCatalog->synchronize(readSchemaVersion());
+    if (auto table{m_schemaCatalog->find(tableName)}) {
+      return table;
+    }
+
+    auto table{loadTableInfo(tableName)};
+    return table.has_value() ? m_schemaCatalog->insert(std::move(*table))
+                             : nullptr;
   }
 
   /// @brief implementation for the interface method
   /// @note for further info, check the interface documentation
   auto getRows(std::string const &tableName) const
       -> std::vector<std::vector<std::string>> override {
-    return getRowsFromStatement(buildSelectAllFromTableStatement(tableName));
+    return getRowsFromStatement(
+        buildSelectAllFromTableStatement(tableName).get());
   }
 
   /// @brief an overload to getRows method that takes prepared statement
@@ -158,6 +624,313 @@ public:
     return getRowsFromStatement(statement.get());
   }
 
+  /// @brief method to read all the rows in the given table through the
+  ///        result cache, sharing the cached rows instead of copying them
+  /// @param tableName the name of the table to read all of its rows
+  /// @return shared pointer to the rows, where the first row represents the
+  ///         columns names, which are read from the database if the result
+  ///         cache is disabled or holds no rows for the statement
+  /// @note check setResultCacheBudget
+  auto getCachedRows(std::string const &tableName) const
+      -> std::shared_ptr<const ResultCache::Rows_type> {
+    return getCachedRowsFromStatement(
+        buildSelectAllFromTableStatement(tableName).get());
+  }
+
+  /// @brief an overload to getCachedRows method that takes prepared statement
+  /// @param statement prepared statement object, where the bound values are
+  ///                  part of the key the rows are cached with
+  /// @return shared pointer to the rows
+  auto getCachedRows(PreparedStatement const &statement) const
+      -> std::shared_ptr<const ResultCache::Rows_type> {
+    return getCachedRowsFromStatement(statement.get());
+  }
+
+  /// @brief method to read all the rows in the given table into a result set,
+  ///        which stores all the cells contiguously in an arena instead of
+  ///        allocating a string per cell
+  /// @param tableName the name of the table to read all of its rows
+  /// @param upstream memory resource the result set allocates from
+  /// @return the result set of the rows, which has no columns if the
+  ///         statement could not be prepared
+  auto getResultSet(std::string const &tableName,
+                    std::pmr::memory_resource *upstream =
+                        std::pmr::get_default_resource()) const -> ResultSet {
+    return getResultSetFromStatement(
+        buildSelectAllFromTableStatement(tableName).get(), upstream);
+  }
+
+  /// @brief an overload to getResultSet method that takes prepared statement
+  /// @param statement prepared statement object
+  /// @param upstream memory resource the result set allocates from
+  /// @return the result set of the rows
+  auto getResultSet(PreparedStatement const &statement,
+                    std::pmr::memory_resource *upstream =
+                        std::pmr::get_default_resource()) const -> ResultSet {
+    return getResultSetFromStatement(statement.get(), upstream);
+  }
+
+  /// @brief method to read a page of the rows of a table with keyset
+  ///        pagination, which seeks right after the last row of the previous
+  ///        page instead of skipping the rows before the page with OFFSET, so
+  ///        reading a deep page costs the same as reading the first one
+  /// @param tableName the name of the table or view to read the rows of
+  /// @param pageSize the maximum number of rows of the page
+  /// @param continuationToken the continuation token of the previous page,
+  ///                          or empty to read the first page
+  /// @param orderingKey the names of the columns to order the rows by, or
+  ///                    empty to order them by rowid (or by primary key for
+  ///                    WITHOUT ROWID tables)
+  /// @param upstream memory resource the rows of the page allocate from
+  /// @return the page, which has no rows and no continuation token if the
+  ///         table does not exist, the ordering key is unknown, or the token
+  ///         is malformed
+  /// @note the rowid (or the primary key) of a table is appended to its
+  ///       ordering key, so that rows sharing the same ordering key are never
+  ///       skipped nor repeated, while the ordering key of a view has to be
+  ///       unique on its own
+  /// @note rows are read in ascending order, and rows whose ordering key
+  ///       holds NULLs are left out of every page, the first one included,
+  ///       as they compare neither less nor greater than other keys, so no
+  ///       page could seek past them
+  /// @note seeking takes logarithmic time if the ordering key is indexed, as
+  ///       the rowid always is
+  auto getPage(std::string const &tableName, std::size_t pageSize,
+               std::string_view continuationToken = {},
+               std::vector<std::string> const &orderingKey = {},
+               std::pmr::memory_resource *upstream =
+                   std::pmr::get_default_resource()) const -> Page {
+    Page page{.rows = ResultSet{upstream}, .continuationToken = {}};
+    auto const table{tableInfo(tableName)};
+    if (table == nullptr || pageSize == 0U) {
+      return page;
+    }
+
+    auto key{orderingKey};
+    auto tiebreaker{table->withoutRowid      ? table->primaryKey()
+                    : table->type == "view" ? std::vector<std::string>{}
+                                            : std::vector<std::string>{
+                                                  "rowid"}};
+    for (auto &column : tiebreaker) {
+      if (std::ranges::find(key, column) == key.end()) {
+        key.push_back(std::move(column));
+      }
+    }
+    if (key.empty()) {
+      return page;
+    }
+
+    std::optional<std::vector<detail::KeyValue_type>> lastKey;
+    if (!continuationToken.empty()) {
+      lastKey = detail::decodeKey(continuationToken);
+      if (!lastKey.has_value() || lastKey->size() != key.size()) {
+        return page;
+      }
+    }
+
+    auto statement{buildPageStatement(tableName, key, lastKey.has_value())};
+    if (statement.get() == nullptr) {
+      return page;
+    }
+
+    // blobs are bound without a copy, as the key outlives the statement run
+    std::size_t position{0U};
+    for (auto const &value : lastKey.has_value()
+                                 ? std::span<const detail::KeyValue_type>{
+                                       *lastKey}
+                                 : std::span<const detail::KeyValue_type>{}) {
+      ++position;
+      std::visit(
+          [&statement, position]<typename T>(T const &keyValue) {
+            if constexpr (std::same_as<T, std::nullptr_t>) {
+              statement.bindNull(position);
+            } else if constexpr (std::same_as<T, std::string>) {
+              statement.bindText(keyValue, position);
+            } else if constexpr (std::same_as<T, std::vector<std::byte>>) {
+              statement.bind(std::span<const std::byte>{keyValue}, position);
+            } else {
+              statement.bind(keyValue, position);
+            }
+          },
+          value);
+    }
+
+    // one more row than the page tells whether there is a next page
+    auto const maxPageSize{
+        static_cast<std::size_t>(std::numeric_limits<std::int64_t>::max())};
+    statement.bind(std::min(pageSize, maxPageSize - 1U) + 1U, position + 1U);
+
+    auto *stmt{statement.get().get()};
+    auto const columnsCount{sqlite3_column_count(stmt) -
+                            static_cast<int>(key.size())};
+    auto const startTime{profilingStartTime()};
+    page.rows.readColumnsNames(stmt, columnsCount);
+
+    std::string pageLastKey;
+    while (stepRow(stmt) == SQLITE_ROW) {
+      if (page.rows.rowsCount() == pageSize) {
+        page.continuationToken = std::move(pageLastKey);
+        break;
+      }
+
+      page.rows.appendRow(stmt);
+      if (page.rows.rowsCount() == pageSize) {
+        pageLastKey = detail::encodeKey(stmt, columnsCount, key.size());
+      }
+    }
+    recordExecution(stmt, startTime, page.rows.rowsCount());
+
+    return page;
+  }
+
+  /// @brief method to read columns of the given table into a columnar batch,
+  ///        where each column is stored in a contiguous array of its type
+  /// @param tableName the name of the table to read the columns of
+  /// @param columnsNames the names of the columns to read, or empty to read
+  ///                     all the columns of the table
+  /// @return the columnar batch, which has no columns if the statement could
+  ///         not be prepared
+  /// @note the type of each column follows the affinity of its declared type,
+  ///       check columnTypeOfDeclaredType, and values are converted to it
+  ///       the same way sqlite3 column functions do
+  auto getColumns(std::string const &tableName,
+                  std::vector<std::string> const &columnsNames = {}) const
+      -> ColumnarBatch {
+    std::string statement{"SELECT "};
+    for (std::size_t i{0U}; i < columnsNames.size(); ++i) {
+      statement += (i == 0U ? "" : ", ") + columnsNames[i];
+    }
+    statement += (columnsNames.empty() ? "* FROM " : " FROM ") + tableName;
+
+    return getColumnsFromStatement(prepareStatement(statement).get());
+  }
+
+  /// @brief an overload to getColumns method that takes prepared statement
+  /// @param statement prepared statement object
+  /// @return the columnar batch
+  /// @note columns computed by expressions have no declared type, so they
+  ///       take the type of their first non-NULL value
+  auto getColumns(PreparedStatement const &statement) const -> ColumnarBatch {
+    return getColumnsFromStatement(statement.get());
+  }
+
+  /// @brief method to read all the rows in the given table as typed rows,
+  ///        reading each column with the sqlite3 column function matching its
+  ///        type instead of converting it to text
+  /// @tparam Row a tuple-like type whose elements are read from the columns in
+  ///             the same order (e.g. std::tuple<std::int64_t, std::string>),
+  ///             a single column type read from the first column, or a struct
+  ///             whose fields are read from their columns by name, check
+  ///             RowMapping
+  /// @param tableName the name of the table to read all of its rows
+  /// @return a vector of typed rows, without a row for the columns names
+  /// @note an empty vector is returned if the statement could not be prepared
+  ///       or has fewer columns than the row type reads
+  template <typename Row>
+  auto getRowsAs(std::string const &tableName) const noexcept
+      -> std::vector<Row> {
+    return getRowsAsFromStatement<Row>(
+        buildSelectAllFromTableStatement(tableName).get());
+  }
+
+  /// @brief an overload to getRowsAs method that reads all the rows of the
+  ///        table of a mapped struct
+  /// @tparam Row the mapped struct, check RowMapping
+  /// @return a vector of objects
+  template <MappedRow Row>
+  auto getRowsAs() const noexcept -> std::vector<Row> {
+    return getRowsAs<Row>(std::string{RowMapping<Row>::kTable});
+  }
+
+  /// @brief an overload to getRowsAs method that takes prepared statement
+  /// @tparam Row the type of the rows to read, check the other overload
+  /// @param statement prepared statement object
+  /// @return a vector of typed rows, without a row for the columns names
+  template <typename Row>
+  auto getRowsAs(PreparedStatement const &statement) const noexcept
+      -> std::vector<Row> {
+    return getRowsAsFromStatement<Row>(statement.get());
+  }
+
+  /// @brief method to run a query with result columns, whose statement is
+  ///        prepared once per connection and then taken from the statement
+  ///        cache, check Query
+  /// @param query the query to run
+  /// @param values the values of the parameters of the query, converted to
+  ///               its declared parameter types
+  /// @return a vector of typed rows, check Query::Row_type
+  /// @note an empty vector is returned if the statement could not be prepared
+  ///       or has fewer columns than the query reads
+  template <FixedString Sql, typename... Columns, typename... Values>
+    requires(sizeof...(Columns) > 0U)
+  auto run(Query<Sql, Result<Columns...>, Params<Values...>> const &query,
+           std::type_identity_t<Values> const &...values) const noexcept
+      -> std::vector<typename Result<Columns...>::Row_type> {
+    PreparedStatement statement{query.kSql, *this};
+    if (!statement.bindAll(values...)) {
+      return {};
+    }
+
+    return getRowsAsFromStatement<typename Result<Columns...>::Row_type>(
+        statement.get());
+  }
+
+  /// @brief method to run a query without result columns, e.g. an INSERT,
+  ///        whose statement is prepared once per connection and then taken
+  ///        from the statement cache, check Query
+  /// @param query the query to run
+  /// @param values the values of the parameters of the query, converted to
+  ///               its declared parameter types
+  /// @return true if the query ran successfully, false otherwise
+  template <FixedString Sql, typename... Values>
+  auto run(Query<Sql, Result<>, Params<Values...>> const &query,
+           std::type_identity_t<Values> const &...values) noexcept -> bool {
+    PreparedStatement statement{query.kSql, *this};
+    auto const succeeded{statement.bindAll(values...) &&
+                         sqlite3_step(statement.get().get()) == SQLITE_DONE};
+    refreshSchemaVersion();
+    syncMirrorIfDue();
+
+    return succeeded;
+  }
+
+  /// @brief method to run a query lazily, returning an input range that steps
+  ///        the statement on demand as it is iterated, so rows are processed
+  ///        one at a time without materializing the whole result
+  /// @param statement the SQL statement to run
+  /// @param values values to bind to the placeholders of positions 1 to N,
+  ///               check PreparedStatement::bindAll for the supported types
+  /// @return input range of RowView objects over the rows of the result
+  /// @note the returned range must not outlive this object, and any views
+  ///       bound through the values must stay valid until it is destroyed
+  template <typename... Values>
+  auto query(std::string const &statement, Values const &...values) const
+      noexcept -> QueryRange<PreparedStatement> {
+    auto preparedStatement{prepareStatement(statement)};
+    if (preparedStatement.get() == nullptr) {
+      return QueryRange<PreparedStatement>{std::move(preparedStatement),
+                                           SQLITE_ERROR};
+    }
+
+    if (!preparedStatement.bindAll(values...)) {
+      return QueryRange<PreparedStatement>{std::move(preparedStatement),
+                                           SQLITE_RANGE};
+    }
+
+    return QueryRange<PreparedStatement>{std::move(preparedStatement),
+                                         SQLITE_OK, m_busyHandler.get()};
+  }
+
+  /// @brief an overload to query method that takes an already bound prepared
+  ///        statement, and takes ownership of it
+  /// @param statement prepared statement object
+  /// @return input range of RowView objects over the rows of the result
+  auto query(PreparedStatement &&statement) const noexcept
+      -> QueryRange<PreparedStatement> {
+    return QueryRange<PreparedStatement>{std::move(statement), SQLITE_OK,
+                                         m_busyHandler.get()};
+  }
+
   /// @brief implementation for the interface method
   /// @note for further info, check the interface documentation
   auto
@@ -166,47 +939,901 @@ public:
     constexpr auto callbackFirstArg{nullptr};
     constexpr auto errMsg{nullptr};
 
+    auto const startTime{profilingStartTime()};
     const int rcode{sqlite3_exec(m_db.get(), statements.c_str(), callback,
                                  callbackFirstArg, errMsg)};
+    if (m_profiler != nullptr) {
+      m_profiler->recordExecution(
+          statements, StatementProfiler::Clock_type::now() - startTime, 0U, {});
+    }
+
+    refreshSchemaVersion();
+    syncMirrorIfDue();
 
     return {rcode == SQLITE_OK};
   }
 
+  /// @brief method to begin a transaction, or a savepoint nested into the
+  ///        open transaction, check Transaction
+  /// @param mode how the transaction acquires its locks
+  /// @return the guard of the transaction, which rolls it back on
+  ///         destruction unless committed, and is inactive if the
+  ///         transaction could not be begun
+  /// @note BEGIN, COMMIT and SAVEPOINT statements are prepared once, and
+  ///       reused from the statement cache afterwards
+  [[nodiscard]] auto
+  beginTransaction(TransactionMode mode = TransactionMode::Deferred) noexcept
+      -> Transaction {
+    return Transaction{*this, mode};
+  }
+
+  /// @brief method to insert many rows into a table, preparing a single
+  ///        INSERT statement that gets rebound for each row, and committing
+  ///        the rows in batches, each in its own transaction
+  /// @param tableName the name of the table to insert the rows into
+  /// @param columnsNames the names of the columns to fill, in the same order
+  ///                     of the elements of each row, or empty to fill all
+  ///                     the columns of the table in their declared order
+  /// @param rows a range of tuple-like rows, whose elements are bound as in
+  ///             PreparedStatement::bindAll
+  /// @param batchSize the number of rows committed per transaction
+  /// @return true if all the rows were inserted, false otherwise
+  /// @note on failure, the batch being inserted is rolled back, while the
+  ///       batches committed before it are kept
+  /// @note if a transaction is already open on the database, each batch is
+  ///       a savepoint nested into it, and committing the rows is left to
+  ///       its owner
+  template <std::ranges::input_range Rows>
+    requires TupleLike<std::ranges::range_value_t<Rows>>
+  auto bulkInsert(std::string const &tableName,
+                  std::vector<std::string> const &columnsNames, Rows &&rows,
+                  std::size_t batchSize = kDefaultBulkInsertBatchSize) noexcept
+      -> bool {
+    constexpr auto rowSize{
+        std::tuple_size_v<std::ranges::range_value_t<Rows>>};
+
+    auto insertStatement{prepareStatement(
+        buildInsertStatement(tableName, columnsNames, rowSize))};
+    if (insertStatement.get() == nullptr || batchSize == 0U ||
+        (!columnsNames.empty() && columnsNames.size() != rowSize)) {
+      return false;
+    }
+
+    // a failing batch is rolled back by the destruction of its transaction
+    std::optional<Transaction> batch;
+    std::size_t rowsInBatch{0U};
+    for (auto const &row : rows) {
+      if (rowsInBatch == 0U) {
+        batch.emplace(*this, TransactionMode::Immediate);
+        if (!batch->isActive()) {
+          return false;
+        }
+      }
+
+      const bool inserted{
+          std::apply(
+              [&insertStatement](auto const &...values) {
+                return insertStatement.bindAll(values...);
+              },
+              row) &&
+          sqlite3_step(insertStatement.get().get()) == SQLITE_DONE};
+      if (!inserted) {
+        return false;
+      }
+
+      if (++rowsInBatch == batchSize) {
+        if (!batch->commit()) {
+          return false;
+        }
+
+        rowsInBatch = 0U;
+      }
+    }
+
+    return rowsInBatch == 0U || batch->commit();
+  }
+
+  /// @brief method to insert objects into the table of their mapped struct,
+  ///        binding each field straight from the object, check bulkInsert
+  /// @param rows a range of objects of a mapped struct, check RowMapping
+  /// @param batchSize the number of rows committed per transaction
+  /// @return true if all the objects were inserted, false otherwise
+  template <std::ranges::input_range Rows>
+    requires MappedRow<std::ranges::range_value_t<Rows>>
+  auto insertRows(Rows &&rows,
+                  std::size_t batchSize = kDefaultBulkInsertBatchSize) noexcept
+      -> bool {
+    using Row = std::ranges::range_value_t<Rows>;
+    auto const fields{
+        [](Row const &row) { return detail::fieldsOf(row); }};
+    return bulkInsert(std::string{RowMapping<Row>::kTable},
+                      detail::columnsNamesOf<Row>(),
+                      std::forward<Rows>(rows) | std::views::transform(fields),
+                      batchSize);
+  }
+
+  /// @brief method to update the rows of objects in the table of their
+  ///        mapped struct, looking each row up by the first field, and
+  ///        setting its columns to the other fields
+  /// @param rows a range of objects of a mapped struct, check RowMapping
+  /// @return true if all the rows were found and updated, false otherwise
+  /// @note all the rows are updated in a single transaction, which is rolled
+  ///       back on failure, or a savepoint if a transaction is already open
+  template <std::ranges::input_range Rows>
+    requires MappedRow<std::ranges::range_value_t<Rows>>
+  auto updateRows(Rows &&rows) noexcept -> bool {
+    using Row = std::ranges::range_value_t<Rows>;
+    static_assert(detail::fieldsCountOf<Row>() > 1U,
+                  "Mapped struct has no fields to update besides its key");
+
+    auto updateStatement{prepareStatement(detail::updateStatementOf<Row>())};
+    if (updateStatement.get() == nullptr) {
+      return false;
+    }
+
+    // a failing update is rolled back by the destruction of the transaction
+    auto transaction{beginTransaction(TransactionMode::Immediate)};
+    if (!transaction.isActive()) {
+      return false;
+    }
+
+    for (auto const &row : rows) {
+      const bool updated{
+          std::apply(
+              [&updateStatement](auto const &...values) {
+                return updateStatement.bindAll(values...);
+              },
+              detail::updatedFieldsOf(row)) &&
+          sqlite3_step(updateStatement.get().get()) == SQLITE_DONE &&
+          sqlite3_changes(m_db.get()) > 0};
+      if (!updated) {
+        return false;
+      }
+    }
+
+    return transaction.commit();
+  }
+
+  /// @brief method to run an SQL script file (e.g. the sql/*.sql seed files),
+  ///        which is much faster than running its text through
+  ///        executeStatements
+  /// @param scriptPath filesystem path to the script
+  /// @param options progress reporting options
+  /// @return the outcome of the load, holding the error of the failed
+  ///         statement, if any
+  /// @throws std::filesystem::filesystem_error if the script cannot be mapped
+  /// @note the script is memory-mapped, and its statements are prepared one
+  ///       after the other by following the tail pointer of
+  ///       sqlite3_prepare_v2, except for INSERT statements whose values are
+  ///       all literals, whose rows are bound to a single reused INSERT
+  ///       statement per table instead
+  /// @note the whole script runs inside a single BEGIN IMMEDIATE / COMMIT, so
+  ///       its own BEGIN, COMMIT and END statements are skipped, and a failure
+  ///       rolls back the whole script; if a transaction is already open on
+  ///       the database, the script runs as part of it, and committing or
+  ///       rolling back is left to its owner
+  /// @note statements that cannot run inside a transaction (e.g. VACUUM) make
+  ///       the load fail
+  auto executeScript(std::filesystem::path const &scriptPath,
+                     ScriptOptions const &options = {}) -> ScriptResult {
+    MappedFile const script{scriptPath};
+    auto const sql{script.view()};
+
+    ScriptResult result;
+    ScriptProgress progress{
+        .bytesCount = 0U, .bytesTotal = sql.size(), .statementsCount = 0U};
+    auto const report{[&options, &progress] {
+      if (options.onProgress) {
+        options.onProgress(progress);
+      }
+    }};
+
+    bool const ownsTransaction{sqlite3_get_autocommit(m_db.get()) != 0};
+    if (ownsTransaction && !runStatement("BEGIN IMMEDIATE")) {
+      result.errorMessage = sqlite3_errmsg(m_db.get());
+      return result;
+    }
+
+    detail::LiteralInsert insert;
+    std::string insertTarget;
+    std::optional<PreparedStatement> insertStatement;
+    std::string unescapedText;
+
+    for (auto offset{detail::skipBlanks(sql, 0U)}; offset < sql.size();
+         offset = detail::skipBlanks(sql, offset)) {
+      auto const statement{sql.substr(offset)};
+      std::size_t length{0U};
+      bool ran{false};
+      bool const skipped{detail::isTransactionControl(statement)};
+
+      if (!skipped && detail::parseLiteralInsert(statement, insert)) {
+        if (!insertStatement.has_value() || insert.target != insertTarget ||
+            sqlite3_bind_parameter_count(insertStatement->get().get()) !=
+                static_cast<int>(insert.columnsCount)) {
+          insertTarget = insert.target;
+          insertStatement.emplace(prepareStatement(
+              buildInsertStatement(insertTarget, {}, insert.columnsCount)));
+        }
+
+        length = insert.length;
+        ran = runLiteralInsert(*insertStatement, insert, unescapedText);
+        if (ran) {
+          result.reboundRowsCount +=
+              insert.values.size() / insert.columnsCount;
+        }
+      } else {
+        ran = runFirstStatement(statement, length, skipped);
+      }
+
+      if (!ran) {
+        result.errorMessage = sqlite3_errmsg(m_db.get());
+        result.errorLine = detail::lineOf(sql, offset);
+        break;
+      }
+
+      offset += length;
+      progress.bytesCount = offset;
+      if (skipped) {
+        continue;
+      }
+
+      ++progress.statementsCount;
+      if (options.progressInterval != 0U &&
+          progress.statementsCount % options.progressInterval == 0U) {
+        report();
+      }
+    }
+
+    // the INSERT statement is handed back before the statement cache gets
+    // cleared by a schema change
+    insertStatement.reset();
+    result.statementsCount = progress.statementsCount;
+
+    if (result.errorMessage.empty() && ownsTransaction &&
+        !runStatement("COMMIT")) {
+      result.errorMessage = sqlite3_errmsg(m_db.get());
+    }
+    if (!result.errorMessage.empty()) {
+      if (ownsTransaction) {
+        runStatement("ROLLBACK");
+      }
+      refreshSchemaVersion();
+      return result;
+    }
+
+    result.succeeded = true;
+    progress.bytesCount = sql.size();
+    report();
+    refreshSchemaVersion();
+    syncMirrorIfDue();
+
+    return result;
+  }
+
+  /// @brief method to change the maximum number of idle prepared statements
+  ///        kept in the statement cache of this object
+  /// @param capacity the new capacity, where zero disables caching
+  void setStatementCacheCapacity(std::size_t capacity) noexcept {
+    m_stmtCache->setCapacity(capacity);
+  }
+
+  /// @brief method to enable the result cache of this object, which keeps the
+  ///        rows read by getRows and getCachedRows from read-only statements,
+  ///        keyed by their SQL text along with their bound values
+  /// @param budget approximate maximum number of bytes taken by the cached
+  ///               rows, where zero disables the cache and drops its rows
+  /// @note cached rows are dropped once a table they were read from changes
+  ///       through this connection, once a transaction gets rolled back, and
+  ///       once another connection commits changes to the database
+  /// @note statements running a PRAGMA or a function whose result changes
+  ///       from a call to another (e.g. random(), datetime('now')) are never
+  ///       cached
+  void setResultCacheBudget(std::size_t budget) {
+    if (budget == 0U) {
+      if (m_resultCache != nullptr) {
+        ResultCache::detach(m_db.get());
+        m_resultCache.reset();
+      }
+      return;
+    }
+
+    if (m_resultCache == nullptr) {
+      m_resultCache = std::make_unique<ResultCache>(budget);
+      m_resultCache->attach(m_db.get());
+      m_resultCache->synchronize(sqlite3_total_changes64(m_db.get()),
+                                 readDataVersion());
+      return;
+    }
+
+    m_resultCache->setBudget(budget);
+  }
+
+  /// @brief method to return the counters of the result cache of this object
+  /// @return hits, misses, evictions, invalidations, size and bytes of the
+  ///         cache, which are all zeros if the cache is disabled
+  [[nodiscard]] auto resultCacheStats() const noexcept -> ResultCache::Stats {
+    return m_resultCache != nullptr ? m_resultCache->stats()
+                                    : ResultCache::Stats{};
+  }
+
+  /// @brief method to attach a profiler that records the latency, the rows
+  ///        count and the counters of each statement run through getRows,
+  ///        getRowsAs and executeStatements, and the time spent preparing
+  ///        statements
+  /// @param profiler the profiler, which may be shared with other objects, or
+  ///                 nullptr to stop profiling
+  /// @note statements are not timed at all while no profiler is attached
+  void setProfiler(std::shared_ptr<StatementProfiler> profiler) noexcept {
+    m_profiler = std::move(profiler);
+  }
+
+  /// @brief method to return the profiler attached to this object
+  /// @return the attached profiler, or nullptr if none is attached
+  [[nodiscard]] auto
+  profiler() const noexcept -> std::shared_ptr<StatementProfiler> const & {
+    return m_profiler;
+  }
+
+  /// @brief method to read back the PRAGMA settings in effect on the database
+  /// @return the PRAGMA settings in effect, where settings that could not be
+  ///         read are left unset
+  [[nodiscard]] auto effectiveSettings() const noexcept -> PragmaSettings {
+    PragmaSettings settings;
+
+    if (const auto journalMode{readPragma<std::string>("journal_mode")}) {
+      settings.journalMode = parseJournalMode(*journalMode);
+    }
+    if (const auto synchronous{readPragma<int>("synchronous")}) {
+      settings.synchronous = static_cast<SynchronousLevel>(*synchronous);
+    }
+    settings.cacheSize = readPragma<std::int64_t>("cache_size");
+    settings.mmapSize = readPragma<std::int64_t>("mmap_size");
+    if (const auto tempStore{readPragma<int>("temp_store")}) {
+      settings.tempStore = static_cast<TempStore>(*tempStore);
+    }
+
+    return settings;
+  }
+
+  /// @brief method to write the committed changes of the in-memory database
+  ///        back to its file now, check CrudWrapperOptions::mirror
+  /// @return true if the file holds all the committed changes, false if it
+  ///         could not be updated (e.g. while a transaction is open), or the
+  ///         database is not mirrored
+  /// @note writes made by stepping prepared statements directly are written
+  ///       back by the next sync, which is either this call, a later write
+  ///       through executeStatements, bulkInsert or executeScript, or the
+  ///       destruction of this object
+  auto syncMirror() noexcept -> bool {
+    return m_mirror != nullptr && m_mirror->sync();
+  }
+
+  /// @brief method to return the metrics of the in-memory mirror of the
+  ///        database, such as the time it took to load
+  /// @return the mirror metrics, or std::nullopt if the database is not
+  ///         mirrored
+  [[nodiscard]] auto
+  mirrorStats() const noexcept -> std::optional<MirrorStats> {
+    if (m_mirror == nullptr) {
+      return std::nullopt;
+    }
+
+    return m_mirror->stats();
+  }
+
+  /// @brief method to return the contention metrics of the connection, such
+  ///        as the time spent waiting for locks held by other connections
+  /// @return the contention metrics, or std::nullopt if no busy policy was
+  ///         set, check CrudWrapperOptions::busyPolicy
+  [[nodiscard]] auto busyStats() const noexcept -> std::optional<BusyStats> {
+    if (m_busyHandler == nullptr) {
+      return std::nullopt;
+    }
+
+    return m_busyHandler->stats();
+  }
+
+  /// @brief method to return the counters of the statement cache of this
+  ///        object
+  /// @return hits, misses, evictions, size and capacity of the cache
+  [[nodiscard]] auto
+  statementCacheStats() const noexcept -> StatementCache::Stats {
+    return m_stmtCache->stats();
+  }
+
 private:
   /// @brief path to the database to connect to
   const std::filesystem::path m_db_path{""};
 
+  /// @brief cache of the rows read by the statements of the database, if
+  ///        enabled
+  /// @note it is declared before the database so that it outlives it, since
+  ///       closing the database may roll back a transaction, which calls the
+  ///       hooks referring to the cache
+  std::unique_ptr<ResultCache> m_resultCache{nullptr};
+
+  /// @brief the busy handler of the database, if a busy policy was set
+  /// @note it is declared before the database so that it outlives it, since
+  ///       closing the database may wait for locks
+  std::unique_ptr<BusyHandler> m_busyHandler{nullptr};
+
   /// @brief unique pointer that owns the handle to the sqlite3 database
   Db_Ptr_type m_db{nullptr};
 
+  /// @brief the mirror loading the database file into the in-memory
+  ///        database, if enabled
+  /// @note it is declared after the database so that it writes the pending
+  ///       changes back before the database is closed
+  std::unique_ptr<InMemoryMirror> m_mirror{nullptr};
+
+  /// @brief cache of idle prepared statements of the database
+  /// @note it is declared after the database so that its statements get
+  ///       finalized before the database is closed, and it is allocated on
+  ///       the heap so that prepared statements can refer to it even if this
+  ///       object was moved
+  std::unique_ptr<StatementCache> m_stmtCache{
+      std::make_unique<StatementCache>()};
+
+  /// @brief the last known schema version of the database
+  std::int64_t m_schemaVersion{0};
+
+  /// @brief cache of the metadata of the tables of the database, allocated
+  ///        on the heap like the statement cache so that const methods can
+  ///        fill it
+  std::unique_ptr<SchemaCatalog> m_schemaCatalog{
+      std::make_unique<SchemaCatalog>()};
+
+  /// @brief profiler of the statements run on the database, if attached
+  std::shared_ptr<StatementProfiler> m_profiler{nullptr};
+
+  /// @brief number of savepoints opened by nested transactions, which names
+  ///        the next one
+  std::size_t m_savepointsCount{0U};
+
   /// @brief private method to build select all from statement on a table
-  ///        given its name, and returns its statement pointer wrapped in a
-  ///        unique pointer
+  ///        given its name, and returns it as a prepared statement object
   /// @param tableName the name of the table to prepare the statement for
-  /// @return unique pointer to the statement prepared
+  /// @return prepared statement object for the statement built
   auto buildSelectAllFromTableStatement(
-      std::string const &tableName) const noexcept -> Stmt_Ptr_type {
-    return initializeStatement(
-        std::string{"SELECT * FROM " + tableName}.c_str(), m_db);
+      std::string const &tableName) const noexcept -> PreparedStatement {
+    return prepareStatement(std::string{"SELECT * FROM " + tableName});
+  }
+
+  /// @brief private method to build the statement reading a page of the rows
+  ///        of a table, which reads the ordering key after the columns of
+  ///        the table, and takes the key to seek past, if any, and the
+  ///        maximum number of rows as parameters
+  /// @param tableName the name of the table to read the rows of
+  /// @param key the names of the columns of the ordering key
+  /// @param seeks whether the page starts after a given key, rather than at
+  ///              the first row
+  /// @return prepared statement object for the statement built
+  auto buildPageStatement(std::string const &tableName,
+                          std::vector<std::string> const &key,
+                          bool seeks) const noexcept -> PreparedStatement {
+    std::string keyList;
+    std::string placeholders;
+    std::string notNull;
+    for (std::size_t i{0U}; i < key.size(); ++i) {
+      keyList += (i == 0U ? "" : ", ") + key[i];
+      placeholders += (i == 0U ? "?" : ", ?");
+      notNull += (i == 0U ? "" : " AND ") + key[i] + " IS NOT NULL";
+    }
+
+    // a row value comparison seeks the index of the key, just like a
+    // comparison on a single column, while NULL keys are filtered out of
+    // every page, since a page ending on one could never be sought past
+    std::string statement{"SELECT *, " + keyList + " FROM " + tableName +
+                          " WHERE " + notNull};
+    if (seeks) {
+      statement += " AND (" + keyList + ") > (" + placeholders + ')';
+    }
+    statement += " ORDER BY " + keyList + " LIMIT ?";
+
+    return prepareStatement(statement);
+  }
+
+  /// @brief private static method to build an INSERT statement with a
+  ///        placeholder for each inserted column
+  /// @param tableName the name of the table to insert into
+  /// @param columnsNames the names of the columns to fill, or empty to fill
+  ///                     all the columns
+  /// @param columnsCount the number of columns to fill
+  /// @return the INSERT statement built
+  static auto buildInsertStatement(std::string const &tableName,
+                                   std::vector<std::string> const &columnsNames,
+                                   std::size_t columnsCount) noexcept
+      -> std::string {
+    std::string statement{"INSERT INTO " + tableName};
+
+    if (!columnsNames.empty()) {
+      statement += " (";
+      for (std::size_t i{0U}; i < columnsNames.size(); ++i) {
+        statement += (i == 0U ? "" : ", ") + columnsNames[i];
+      }
+      statement += ')';
+    }
+
+    statement += " VALUES (";
+    for (std::size_t i{0U}; i < columnsCount; ++i) {
+      statement += (i == 0U ? "?" : ", ?");
+    }
+    statement += ')';
+
+    return statement;
+  }
+
+  /// @brief private method to run a statement that returns no rows (e.g.
+  ///        BEGIN, COMMIT) through the statement cache, so it gets prepared
+  ///        only once
+  /// @param statement the statement to run
+  /// @return true if the statement ran successfully, false otherwise
+  auto runStatement(std::string const &statement) noexcept -> bool {
+    auto const preparedStatement{prepareStatement(statement)};
+    return preparedStatement.get() != nullptr &&
+           sqlite3_step(preparedStatement.get().get()) == SQLITE_DONE;
+  }
+
+  /// @brief private method to prepare and run the first statement of an SQL
+  ///        text, without caching it since it is run only once
+  /// @param sql the SQL text, starting at the statement
+  /// @param length set to the number of bytes of the statement
+  /// @param skipped whether the statement gets prepared only to find where it
+  ///                ends, without running it
+  /// @return true if the statement was prepared and ran successfully, false
+  ///         otherwise
+  auto runFirstStatement(std::string_view sql, std::size_t &length,
+                         bool skipped) noexcept -> bool {
+    sqlite3_stmt *stmtPtr{nullptr};
+    char const *tail{nullptr};
+    // statements are prepared from the mapped text in place, which is not
+    // NUL-terminated, so its length has to be passed and fit an int
+    auto const textLength{static_cast<int>(std::min<std::size_t>(
+        sql.size(),
+        static_cast<std::size_t>(std::numeric_limits<int>::max())))};
+    const int rcode{sqlite3_prepare_v2(m_db.get(), sql.data(), textLength,
+                                       &stmtPtr, &tail)};
+    Stmt_Ptr_type const stmt{stmtPtr};
+    if (rcode != SQLITE_OK || tail == sql.data()) {
+      return false;
+    }
+
+    length = static_cast<std::size_t>(tail - sql.data());
+    if (stmt == nullptr || skipped) {
+      return true;
+    }
+
+    int stepCode{SQLITE_ROW};
+    while (stepCode == SQLITE_ROW) {
+      stepCode = sqlite3_step(stmt.get());
+    }
+
+    return {stepCode == SQLITE_DONE};
+  }
+
+  /// @brief private static method to insert the rows of an INSERT statement
+  ///        whose values are all literals, by binding them to a statement
+  ///        with a placeholder per value
+  /// @param statement the INSERT statement with placeholders
+  /// @param insert the parsed INSERT statement
+  /// @param unescapedText buffer reused to unescape the texts holding quotes
+  /// @return true if all the rows were inserted, false otherwise
+  static auto runLiteralInsert(PreparedStatement &statement,
+                               detail::LiteralInsert const &insert,
+                               std::string &unescapedText) -> bool {
+    for (std::size_t first{0U}; first < insert.values.size();
+         first += insert.columnsCount) {
+      for (std::size_t i{0U}; i < insert.columnsCount; ++i) {
+        auto const &literal{insert.values[first + i]};
+        auto const position{i + 1U};
+
+        bool bound{false};
+        switch (literal.kind) {
+        case detail::LiteralKind::Integer:
+          bound = statement.bind(literal.integer, position);
+          break;
+        case detail::LiteralKind::Real:
+          bound = statement.bind(literal.real, position);
+          break;
+        case detail::LiteralKind::Text:
+          bound = statement.bindTextView(literal.text, position);
+          break;
+        case detail::LiteralKind::EscapedText:
+          // each quote of the text is doubled in the literal
+          unescapedText.clear();
+          for (std::size_t c{0U}; c < literal.text.size(); ++c) {
+            unescapedText += literal.text[c];
+            c += literal.text[c] == '\'' ? 1U : 0U;
+          }
+          bound = statement.bindText(unescapedText, position);
+          break;
+        case detail::LiteralKind::Null:
+          bound = statement.bindNull(position);
+          break;
+        }
+
+        if (!bound) {
+          return false;
+        }
+      }
+
+      if (sqlite3_step(statement.get().get()) != SQLITE_DONE) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  /// @brief private method to forget everything cached about the schema of
+  ///        the database if it changed, since cached statements and results
+  ///        could refer to a schema that no longer exists
+  /// @note TEMP schema changes count too, as a TEMP table shadowing a cached
+  ///       table changes no rows, so no change of the data invalidates it
+  void refreshSchemaVersion() noexcept {
+    if (const auto schemaVersion{readSchemaVersion()};
+        schemaVersion != m_schemaVersion) {
+      m_stmtCache->clear();
+      if (m_resultCache != nullptr) {
+        m_resultCache->resetSchema();
+      }
+      m_schemaVersion = schemaVersion;
+    }
+  }
+
+  /// @brief private method to write the changes of the in-memory database
+  ///        back to its file if they are due, check MirrorSync
+  /// @note a failed write back leaves the changes pending, which is reported
+  ///       by mirrorStats()
+  void syncMirrorIfDue() noexcept {
+    if (m_mirror != nullptr) {
+      m_mirror->afterWrite();
+    }
+  }
+
+  /// @brief private method to apply the set PRAGMA settings to the database,
+  ///        one PRAGMA at a time so that a failing one can't skip the others
+  /// @param pragmas the PRAGMA settings to apply
+  /// @throws std::runtime_error if a PRAGMA fails to run (e.g. changing the
+  ///         journal mode while another connection holds a lock)
+  void applyPragmas(PragmaSettings const &pragmas) {
+    std::vector<std::string> statements;
+
+    if (pragmas.journalMode.has_value()) {
+      statements.emplace_back("PRAGMA journal_mode=" +
+                              std::string{toString(*pragmas.journalMode)});
+    }
+    if (pragmas.synchronous.has_value()) {
+      statements.emplace_back(
+          "PRAGMA synchronous=" +
+          std::to_string(static_cast<int>(*pragmas.synchronous)));
+    }
+    if (pragmas.cacheSize.has_value()) {
+      statements.emplace_back("PRAGMA cache_size=" +
+                              std::to_string(*pragmas.cacheSize));
+    }
+    if (pragmas.mmapSize.has_value()) {
+      statements.emplace_back("PRAGMA mmap_size=" +
+                              std::to_string(*pragmas.mmapSize));
+    }
+    if (pragmas.tempStore.has_value()) {
+      statements.emplace_back(
+          "PRAGMA temp_store=" +
+          std::to_string(static_cast<int>(*pragmas.tempStore)));
+    }
+
+    // each PRAGMA runs only once, so it is not worth a cached statement
+    constexpr auto callback{nullptr};
+    constexpr auto callbackFirstArg{nullptr};
+    constexpr auto errMsg{nullptr};
+    for (auto const &statement : statements) {
+      if (const int rCode{sqlite3_exec(m_db.get(), statement.c_str(),
+                                       callback, callbackFirstArg, errMsg)};
+          rCode != SQLITE_OK) {
+        throw std::runtime_error("Failed to run " + statement +
+                                 ", sqlite3 error: " + sqlite3_errstr(rCode));
+      }
+    }
+  }
+
+  /// @brief private method to read the value of a PRAGMA
+  /// @tparam T the type to read the value as
+  /// @param pragmaName the name of the PRAGMA
+  /// @return the value of the PRAGMA, or std::nullopt if it could not be read
+  template <typename T>
+  auto readPragma(std::string const &pragmaName) const noexcept
+      -> std::optional<T> {
+    auto const values{getRowsAs<T>(prepareStatement("PRAGMA " + pragmaName))};
+    if (values.empty()) {
+      return std::nullopt;
+    }
+
+    return values.front();
+  }
+
+  /// @brief private method to read the schema version of the database, which
+  ///        changes each time the schema of its main or temp database gets
+  ///        modified, since TEMP tables shadow main tables of the same name
+  /// @return the schema versions of the temp and main databases, in the high
+  ///         and low 32 bits, or -1 if they could not be read
+  /// @note schema versions are 32-bit integers, so combining them this way
+  ///       tells apart any two pairs of versions
+  auto readSchemaVersion() const noexcept -> std::int64_t {
+    auto const readVersion{[this](std::string const &statement) {
+      auto const preparedStatement{prepareStatement(statement)};
+      return sqlite3_step(preparedStatement.get().get()) == SQLITE_ROW
+                 ? std::optional<std::uint32_t>{static_cast<std::uint32_t>(
+                       sqlite3_column_int(preparedStatement.get().get(), 0))}
+                 : std::nullopt;
+    }};
+
+    auto const mainVersion{readVersion("PRAGMA main.schema_version")};
+    auto const tempVersion{readVersion("PRAGMA temp.schema_version")};
+    if (!mainVersion.has_value() || !tempVersion.has_value()) {
+      return -1;
+    }
+
+    return static_cast<std::int64_t>(
+        (static_cast<std::uint64_t>(*tempVersion) << 32U) | *mainVersion);
+  }
+
+  /// @brief private method to load the metadata of a table or a view from
+  ///        the table-valued PRAGMA functions
+  /// @param tableName the name of the table, where a TEMP table shadows a
+  ///                  table of the same name, just like in statements
+  /// @return the metadata of the table, or std::nullopt if there is no such
+  ///         table
+  auto loadTableInfo(std::string const &tableName) const
+      -> std::optional<TableInfo> {
+    auto tablesStatement{prepareStatement(
+        "SELECT schema, name, type, wr FROM pragma_table_list(?) "
+        "ORDER BY schema <> 'temp'")};
+    if (!tablesStatement.bindAll(tableName)) {
+      return std::nullopt;
+    }
+
+    auto tables{getRowsAs<
+        std::tuple<std::string, std::string, std::string, bool>>(
+        tablesStatement)};
+    if (tables.empty()) {
+      return std::nullopt;
+    }
+
+    auto &[schema, name, type, withoutRowid]{tables.front()};
+    TableInfo table{.name = std::move(name),
+                    .type = std::move(type),
+                    .withoutRowid = withoutRowid,
+                    .columns = {},
+                    .indexes = {},
+                    .columnsNames = {}};
+
+    // hidden columns of virtual tables are not read by SELECT *
+    auto columnsStatement{prepareStatement(
+        "SELECT name, type, \"notnull\", dflt_value, pk "
+        "FROM pragma_table_xinfo(?, ?) WHERE hidden <> 1")};
+    columnsStatement.bindAll(table.name, schema);
+    for (auto &[columnName, declaredType, notNull, defaultValue,
+                primaryKeyPosition] :
+         getRowsAs<std::tuple<std::string, std::string, bool,
+                              std::optional<std::string>, std::size_t>>(
+             columnsStatement)) {
+      table.columnsNames.push_back(columnName);
+      table.columns.push_back(
+          ColumnInfo{.name = std::move(columnName),
+                     .declaredType = std::move(declaredType),
+                     .notNull = notNull,
+                     .defaultValue = std::move(defaultValue),
+                     .primaryKeyPosition = primaryKeyPosition});
+    }
+
+    auto indexesStatement{prepareStatement(
+        "SELECT name, \"unique\", origin, partial "
+        "FROM pragma_index_list(?, ?)")};
+    indexesStatement.bindAll(table.name, schema);
+    auto indexColumnsStatement{prepareStatement(
+        "SELECT name FROM pragma_index_info(?, ?) ORDER BY seqno")};
+    for (auto &[indexName, unique, origin, partial] :
+         getRowsAs<std::tuple<std::string, bool, std::string, bool>>(
+             indexesStatement)) {
+      IndexInfo index{.name = std::move(indexName),
+                      .unique = unique,
+                      .origin = std::move(origin),
+                      .partial = partial,
+                      .columnsNames = {}};
+
+      indexColumnsStatement.bindAll(index.name, schema);
+      for (auto &columnName : getRowsAs<std::optional<std::string>>(
+               indexColumnsStatement)) {
+        index.columnsNames.push_back(std::move(columnName).value_or(""));
+      }
+
+      table.indexes.push_back(std::move(index));
+    }
+
+    return table;
+  }
+
+  /// @brief private method to read the data version of the database, which
+  ///        changes each time another connection commits changes to it
+  /// @return the data version, or -1 if it could not be read
+  auto readDataVersion() const noexcept -> std::int64_t {
+    auto const statement{prepareStatement("PRAGMA data_version")};
+    if (sqlite3_step(statement.get().get()) != SQLITE_ROW) {
+      return -1;
+    }
+
+    return sqlite3_column_int64(statement.get().get(), 0);
+  }
+
+  /// @brief private method to return the time a profiled statement starts
+  ///        running at
+  /// @return the current time if a profiler is attached, or the epoch of the
+  ///         clock otherwise, so that the clock is not read needlessly
+  auto profilingStartTime() const noexcept
+      -> StatementProfiler::Clock_type::time_point {
+    return m_profiler != nullptr ? StatementProfiler::Clock_type::now()
+                                 : StatementProfiler::Clock_type::time_point{};
+  }
+
+  /// @brief private method to step a statement to its next row, retrying
+  ///        read statements as allowed by the busy policy, check
+  ///        BusyHandler::step
+  /// @param stmt the statement to step
+  /// @return the result code of the last step
+  auto stepRow(sqlite3_stmt *stmt) const noexcept -> int {
+    return m_busyHandler == nullptr ? sqlite3_step(stmt)
+                                    : m_busyHandler->step(stmt);
+  }
+
+  /// @brief private method to record an execution of a statement if a
+  ///        profiler is attached
+  /// @param stmt the executed statement
+  /// @param startTime the time returned by profilingStartTime before the
+  ///                  statement was executed
+  /// @param rowsCount the number of rows returned by the statement
+  void recordExecution(sqlite3_stmt *stmt,
+                       StatementProfiler::Clock_type::time_point startTime,
+                       std::size_t rowsCount) const noexcept {
+    if (m_profiler == nullptr || stmt == nullptr) {
+      return;
+    }
+
+    m_profiler->recordExecution(sqlite3_sql(stmt),
+                                StatementProfiler::Clock_type::now() -
+                                    startTime,
+                                rowsCount, takeStatementCounters(stmt));
   }
 
   /// @brief a private static class method for preparing statements
   /// @param statement the statement to be prepared
   /// @param db the database for which the statement need to be prepared
+  /// @param profiler the profiler to record the preparation time to, if any
   /// @return a unique pointer to the prepared statement
   static auto
-  initializeStatement(std::string const &statement,
-                      Db_Ptr_type const &db) noexcept -> Stmt_Ptr_type {
-    if (db == nullptr) {
+  initializeStatement(std::string_view statement, Db_Ptr_type const &db,
+                      StatementProfiler *profiler = nullptr) noexcept
+      -> Stmt_Ptr_type {
+    // statements longer than an int can take are not prepared
+    constexpr auto maxLength{
+        static_cast<std::size_t>(std::numeric_limits<int>::max())};
+    if (db == nullptr || statement.size() > maxLength) {
       return static_cast<Stmt_Ptr_type>(nullptr);
     }
 
     sqlite3_stmt *stmtPtr{nullptr};
-    constexpr auto useStrLenInternally{-1};
     constexpr auto pzTailPtr{nullptr};
 
-    sqlite3_prepare_v2(db.get(), statement.c_str(), useStrLenInternally,
-                       &stmtPtr, pzTailPtr);
+    auto const startTime{profiler != nullptr
+                             ? StatementProfiler::Clock_type::now()
+                             : StatementProfiler::Clock_type::time_point{}};
+    // the length is passed, as views (e.g. Query::kSql) need no terminator
+    sqlite3_prepare_v2(db.get(), statement.data(),
+                       static_cast<int>(statement.size()), &stmtPtr,
+                       pzTailPtr);
+    if (profiler != nullptr) {
+      profiler->recordPrepare(statement, StatementProfiler::Clock_type::now() -
+                                             startTime);
+    }
 
     return Stmt_Ptr_type{stmtPtr};
   }
@@ -235,11 +1862,153 @@ private:
     return columnsNames;
   }
 
-  /// @brief a private method to return all the rows given the statement passed
+  /// @brief a private method to return all the rows given the statement
+  ///        passed, read as the requested type
+  /// @tparam Row the type of the rows to read
+  /// @param stmt a unique pointer to sqlite3 prepared statement
+  /// @return vector of typed rows representing the results
+  template <typename Row>
+  auto getRowsAsFromStatement(Stmt_Ptr_type const &stmt) const noexcept
+      -> std::vector<Row> {
+    if constexpr (MappedRow<Row>) {
+      // the columns of the fields are looked up once per statement
+      auto const columns{stmt != nullptr
+                             ? detail::resolveColumns<Row>(stmt.get())
+                             : std::nullopt};
+      if (!columns.has_value()) {
+        return {};
+      }
+
+      auto const startTime{profilingStartTime()};
+      std::vector<Row> rows;
+      while (stepRow(stmt.get()) == SQLITE_ROW) {
+        rows.emplace_back(detail::readMappedRow<Row>(stmt.get(), *columns));
+      }
+      recordExecution(stmt.get(), startTime, rows.size());
+
+      return rows;
+    } else {
+      if (stmt == nullptr || static_cast<std::size_t>(sqlite3_column_count(
+                                 stmt.get())) < columnsCountOf<Row>()) {
+        return {};
+      }
+
+      auto const startTime{profilingStartTime()};
+      std::vector<Row> rows;
+      while (stepRow(stmt.get()) == SQLITE_ROW) {
+        rows.emplace_back(readRow<Row>(stmt.get()));
+      }
+      recordExecution(stmt.get(), startTime, rows.size());
+
+      return rows;
+    }
+  }
+
+  /// @brief a private method to read all the rows given the statement passed
+  ///        into a columnar batch
+  /// @param stmt a unique pointer to sqlite3 prepared statement
+  /// @return the columnar batch of the rows
+  auto getColumnsFromStatement(Stmt_Ptr_type const &stmt) const
+      -> ColumnarBatch {
+    ColumnarBatch batch;
+    if (stmt == nullptr) {
+      return batch;
+    }
+
+    auto const startTime{profilingStartTime()};
+    batch.readColumns(stmt.get());
+    while (stepRow(stmt.get()) == SQLITE_ROW) {
+      batch.appendRow(stmt.get());
+    }
+    batch.finish();
+    recordExecution(stmt.get(), startTime, batch.rowsCount());
+
+    return batch;
+  }
+
+  /// @brief a private method to read all the rows given the statement passed
+  ///        into a result set
+  /// @param stmt a unique pointer to sqlite3 prepared statement
+  /// @param upstream memory resource the result set allocates from
+  /// @return the result set of the rows
+  auto getResultSetFromStatement(Stmt_Ptr_type const &stmt,
+                                 std::pmr::memory_resource *upstream) const
+      -> ResultSet {
+    ResultSet resultSet{upstream};
+    if (stmt == nullptr) {
+      return resultSet;
+    }
+
+    auto const startTime{profilingStartTime()};
+    resultSet.readColumnsNames(stmt.get());
+    while (stepRow(stmt.get()) == SQLITE_ROW) {
+      resultSet.appendRow(stmt.get());
+    }
+    recordExecution(stmt.get(), startTime, resultSet.rowsCount());
+
+    return resultSet;
+  }
+
+  /// @brief a private method to return all the rows given the statement
+  ///        passed, copying them out of the result cache if it is enabled
   /// @param stmt a unique pointer to sqlite3 prepared statement
   /// @return vector of vector of strings representing the results
   auto getRowsFromStatement(Stmt_Ptr_type const &stmt) const noexcept
       -> std::vector<std::vector<std::string>> {
+    if (m_resultCache != nullptr) {
+      return *getCachedRowsFromStatement(stmt);
+    }
+
+    return readRowsFromStatement(stmt);
+  }
+
+  /// @brief a private method to return all the rows given the statement
+  ///        passed through the result cache, reading and caching them if it
+  ///        holds none for the statement
+  /// @param stmt a unique pointer to sqlite3 prepared statement
+  /// @return shared pointer to the rows
+  /// @note statements whose rows could not all be read are not cached
+  auto getCachedRowsFromStatement(Stmt_Ptr_type const &stmt) const noexcept
+      -> std::shared_ptr<const ResultCache::Rows_type> {
+    if (m_resultCache == nullptr || stmt == nullptr ||
+        sqlite3_stmt_readonly(stmt.get()) == 0) {
+      return std::make_shared<const ResultCache::Rows_type>(
+          readRowsFromStatement(stmt));
+    }
+
+    m_resultCache->synchronize(sqlite3_total_changes64(m_db.get()),
+                               readDataVersion());
+
+    std::unique_ptr<char, decltype(&sqlite3_free)> const key{
+        sqlite3_expanded_sql(stmt.get()), &sqlite3_free};
+    if (key != nullptr) {
+      if (auto rows{m_resultCache->find(key.get())}) {
+        return rows;
+      }
+    }
+
+    auto rows{std::make_shared<const ResultCache::Rows_type>(
+        readRowsFromStatement(stmt))};
+    if (key == nullptr || sqlite3_errcode(m_db.get()) != SQLITE_DONE) {
+      return rows;
+    }
+
+    if (auto const &tables{
+            m_resultCache->dependenciesOf(m_db.get(), sqlite3_sql(stmt.get()))};
+        tables.has_value()) {
+      m_resultCache->insert(key.get(), rows, *tables);
+    }
+
+    return rows;
+  }
+
+  /// @brief a private method to read all the rows given the statement passed
+  ///        from the database
+  /// @param stmt a unique pointer to sqlite3 prepared statement
+  /// @return vector of vector of strings representing the results
+  auto readRowsFromStatement(Stmt_Ptr_type const &stmt) const noexcept
+      -> std::vector<std::vector<std::string>> {
+    auto const startTime{profilingStartTime()};
     std::vector<std::vector<std::string>> rows;
 
     // where first row shall be the columns names
@@ -247,7 +2016,7 @@ private:
 
     // read and emplace remaining rows
     const auto noOfColumns{rows[0].size()};
-    while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+    while (stepRow(stmt.get()) == SQLITE_ROW) {
       std::vector<std::string> rowElements;
       rowElements.reserve(noOfColumns);
 
@@ -261,6 +2030,7 @@ private:
 
       rows.emplace_back(std::move(rowElements));
     }
+    recordExecution(stmt.get(), startTime, rows.size() - 1U);
 
     return rows;
   }
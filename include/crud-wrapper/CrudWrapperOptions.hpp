@@ -0,0 +1,212 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <sqlite3.h>
+#include <string_view>
+#include <utility>
+
+#include "BusyHandler.hpp"
+#include "InMemoryMirror.hpp"
+#include "StatementCache.hpp"
+
+/// @brief namespace for SQL with c++
+namespace sql_with_cpp {
+
+/// @brief journal modes supported by SQLite
+enum class JournalMode { Delete, Truncate, Persist, Memory, Wal, Off };
+
+/// @brief synchronous levels supported by SQLite, valued as in PRAGMA
+///        synchronous
+enum class SynchronousLevel : int { Off = 0, Normal = 1, Full = 2, Extra = 3 };
+
+/// @brief temporary storage locations supported by SQLite, valued as in
+///        PRAGMA temp_store
+enum class TempStore : int { Default = 0, File = 1, Memory = 2 };
+
+/// @brief named sets of PRAGMA settings tuned for common workloads
+enum class TuningProfile {
+  /// @brief SQLite's own defaults
+  Default,
+
+  /// @brief many concurrent readers, and occasional writes
+  ReadHeavy,
+
+  /// @brief loading large amounts of data, trading durability for speed
+  BulkLoad,
+
+  /// @brief writes that must survive power loss
+  Durable
+};
+
+/// @brief PRAGMA settings of a database connection, where unset settings are
+///        left at SQLite's defaults when applied
+struct PragmaSettings {
+  /// @brief value of PRAGMA journal_mode
+  std::optional<JournalMode> journalMode;
+
+  /// @brief value of PRAGMA synchronous
+  std::optional<SynchronousLevel> synchronous;
+
+  /// @brief value of PRAGMA cache_size, which is a number of pages if
+  ///        positive, or a number of KiB if negative
+  std::optional<std::int64_t> cacheSize;
+
+  /// @brief value of PRAGMA mmap_size in bytes
+  std::optional<std::int64_t> mmapSize;
+
+  /// @brief value of PRAGMA temp_store
+  std::optional<TempStore> tempStore;
+
+  /// @brief defaulted equality operator
+  auto operator==(PragmaSettings const &) const -> bool = default;
+};
+
+/// @brief options for opening a database connection by CrudWrapper
+struct CrudWrapperOptions {
+  /// @brief flags passed to sqlite3_open_v2, which match the behavior of
+  ///        sqlite3_open by default
+  int openFlags{SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE};
+
+  /// @brief PRAGMA settings applied once the database is opened
+  PragmaSettings pragmas;
+
+  /// @brief capacity of the prepared statements cache
+  std::size_t statementCacheCapacity{StatementCache::kDefaultCapacity};
+
+  /// @brief if set, the database file is copied into an in-memory database
+  ///        once opened, which then serves all the reads and writes
+  std::optional<MirrorOptions> mirror;
+
+  /// @brief if set, locks held by other connections are waited for with
+  ///        exponential backoff and jitter, instead of failing at once with
+  ///        SQLITE_BUSY
+  std::optional<BusyPolicy> busyPolicy;
+
+  /// @brief static method to return the options of a tuning profile
+  /// @param profile the tuning profile
+  /// @return the options of the tuning profile
+  static constexpr auto forProfile(TuningProfile profile) noexcept
+      -> CrudWrapperOptions {
+    constexpr std::int64_t kib64Mib{-65536};
+    constexpr std::int64_t kib256Mib{-262144};
+    constexpr std::int64_t bytes256Mib{268435456};
+
+    CrudWrapperOptions options;
+    switch (profile) {
+    case TuningProfile::ReadHeavy:
+      options.pragmas = {.journalMode = JournalMode::Wal,
+                         .synchronous = SynchronousLevel::Normal,
+                         .cacheSize = kib64Mib,
+                         .mmapSize = bytes256Mib,
+                         .tempStore = TempStore::Memory};
+      break;
+    case TuningProfile::BulkLoad:
+      options.pragmas = {.journalMode = JournalMode::Memory,
+                         .synchronous = SynchronousLevel::Off,
+                         .cacheSize = kib256Mib,
+                         .mmapSize = std::nullopt,
+                         .tempStore = TempStore::Memory};
+      break;
+    case TuningProfile::Durable:
+      options.pragmas = {.journalMode = JournalMode::Wal,
+                         .synchronous = SynchronousLevel::Full,
+                         .cacheSize = std::nullopt,
+                         .mmapSize = std::nullopt,
+                         .tempStore = std::nullopt};
+      break;
+    case TuningProfile::Default:
+      break;
+    }
+
+    return options;
+  }
+};
+
+/// @brief names of the journal modes as used by PRAGMA journal_mode
+inline constexpr std::array<std::pair<JournalMode, std::string_view>, 6U>
+    kJournalModesNames{{{JournalMode::Delete, "delete"},
+                        {JournalMode::Truncate, "truncate"},
+                        {JournalMode::Persist, "persist"},
+                        {JournalMode::Memory, "memory"},
+                        {JournalMode::Wal, "wal"},
+                        {JournalMode::Off, "off"}}};
+
+/// @brief names of the tuning profiles, e.g. as used in configuration files
+inline constexpr std::array<std::pair<TuningProfile, std::string_view>, 4U>
+    kTuningProfilesNames{{{TuningProfile::Default, "default"},
+                          {TuningProfile::ReadHeavy, "read-heavy"},
+                          {TuningProfile::BulkLoad, "bulk-load"},
+                          {TuningProfile::Durable, "durable"}}};
+
+/// @brief function to return the name of a journal mode
+/// @param mode the journal mode
+/// @return the name of the journal mode as used by PRAGMA journal_mode
+constexpr auto toString(JournalMode mode) noexcept -> std::string_view {
+  for (auto const &[journalMode, name] : kJournalModesNames) {
+    if (journalMode == mode) {
+      return name;
+    }
+  }
+
+  return {};
+}
+
+/// @brief function to return the name of a tuning profile
+/// @param profile the tuning profile
+/// @return the name of the tuning profile
+constexpr auto toString(TuningProfile profile) noexcept -> std::string_view {
+  for (auto const &[tuningProfile, name] : kTuningProfilesNames) {
+    if (tuningProfile == profile) {
+      return name;
+    }
+  }
+
+  return {};
+}
+
+/// @brief function to parse the name of a journal mode case-insensitively
+/// @param name the name of the journal mode
+/// @return the journal mode, or std::nullopt for unknown names
+constexpr auto parseJournalMode(std::string_view name) noexcept
+    -> std::optional<JournalMode> {
+  auto const equalsIgnoringCase{[](std::string_view lhs, std::string_view rhs) {
+    if (lhs.size() != rhs.size()) {
+      return false;
+    }
+
+    for (std::size_t i{0U}; i < lhs.size(); ++i) {
+      if ((lhs[i] | 0x20) != (rhs[i] | 0x20)) {
+        return false;
+      }
+    }
+
+    return true;
+  }};
+
+  for (auto const &[journalMode, modeName] : kJournalModesNames) {
+    if (equalsIgnoringCase(name, modeName)) {
+      return journalMode;
+    }
+  }
+
+  return std::nullopt;
+}
+
+/// @brief function to parse the name of a tuning profile
+/// @param name the name of the tuning profile, e.g. "read-heavy"
+/// @return the tuning profile, or std::nullopt for unknown names
+constexpr auto parseTuningProfile(std::string_view name) noexcept
+    -> std::optional<TuningProfile> {
+  for (auto const &[tuningProfile, profileName] : kTuningProfilesNames) {
+    if (name == profileName) {
+      return tuningProfile;
+    }
+  }
+
+  return std::nullopt;
+}
+
+} // namespace sql_with_cpp
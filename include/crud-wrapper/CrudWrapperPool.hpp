@@ -0,0 +1,535 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "CrudWrapper.hpp"
+#include "ThreadPool.hpp"
+
+/// @brief namespace for SQL with c++
+namespace sql_with_cpp {
+
+/// @brief a thread-safe pool of connections to the same database, made of a
+///        single writer connection and many read-only reader connections
+/// @note the database is switched to WAL journal mode, so that readers do not
+///       block the writer, nor get blocked by it
+/// @note connections are opened with SQLITE_OPEN_NOMUTEX, which is safe since
+///       each one is leased to a single thread at a time
+class CrudWrapperPool {
+  /// @brief clock used for measuring wait and lease times
+  using Clock_type = std::chrono::steady_clock;
+
+public:
+  /// @brief RAII lease of a connection, which returns it to the pool on
+  ///        destruction
+  /// @tparam Wrapper CrudWrapper const for readers, CrudWrapper for writers
+  /// @note a lease must not outlive the pool it was acquired from
+  template <typename Wrapper> class Lease {
+  public:
+    /// @brief parametrized constructor for the lease
+    /// @param pool the pool the connection is leased from
+    /// @param wrapper the leased connection
+    Lease(CrudWrapperPool &pool, Wrapper &wrapper) noexcept
+        : m_pool{&pool}, m_wrapper{&wrapper}, m_leasedAt{Clock_type::now()} {}
+
+    /// @brief deleted copy operations, as a connection has a single lessee
+    Lease(Lease const &) = delete;
+    auto operator=(Lease const &) -> Lease & = delete;
+
+    /// @brief move constructor that takes over the lease of other
+    /// @param other the lease to move from
+    Lease(Lease &&other) noexcept
+        : m_pool{std::exchange(other.m_pool, nullptr)},
+          m_wrapper{std::exchange(other.m_wrapper, nullptr)},
+          m_leasedAt{other.m_leasedAt} {}
+
+    /// @brief move assignment operator that returns the currently leased
+    ///        connection before taking over the lease of other
+    /// @param other the lease to move from
+    /// @return reference to this object
+    auto operator=(Lease &&other) noexcept -> Lease & {
+      if (this != &other) {
+        giveBack();
+        m_pool = std::exchange(other.m_pool, nullptr);
+        m_wrapper = std::exchange(other.m_wrapper, nullptr);
+        m_leasedAt = other.m_leasedAt;
+      }
+
+      return *this;
+    }
+
+    /// @brief destructor that returns the connection to the pool
+    ~Lease() noexcept { giveBack(); }
+
+    /// @brief member access operator to the leased connection
+    /// @return pointer to the leased connection
+    auto operator->() const noexcept -> Wrapper * { return m_wrapper; }
+
+    /// @brief dereference operator to the leased connection
+    /// @return reference to the leased connection
+    auto operator*() const noexcept -> Wrapper & { return *m_wrapper; }
+
+  private:
+    /// @brief the pool the connection is leased from
+    CrudWrapperPool *m_pool{nullptr};
+
+    /// @brief the leased connection
+    Wrapper *m_wrapper{nullptr};
+
+    /// @brief the time the connection was leased at
+    Clock_type::time_point m_leasedAt;
+
+    /// @brief private method to return the connection to the pool
+    void giveBack() noexcept {
+      if (m_pool != nullptr) {
+        m_pool->release(m_wrapper, Clock_type::now() - m_leasedAt);
+        m_pool = nullptr;
+        m_wrapper = nullptr;
+      }
+    }
+  };
+
+  /// @brief a type alias for leases of reader connections, which expose only
+  ///        the const (i.e. reading) interface of CrudWrapper
+  using ReaderLease = Lease<CrudWrapper const>;
+
+  /// @brief a type alias for leases of the writer connection
+  using WriterLease = Lease<CrudWrapper>;
+
+  /// @brief metrics describing how the pool is used
+  struct Stats {
+    /// @brief number of reader connections in the pool
+    std::size_t readersCount{0U};
+
+    /// @brief number of reader leases acquired so far
+    std::size_t readerLeases{0U};
+
+    /// @brief number of writer leases acquired so far
+    std::size_t writerLeases{0U};
+
+    /// @brief number of reader connections currently leased
+    std::size_t readersInUse{0U};
+
+    /// @brief highest number of reader connections leased at the same time
+    std::size_t peakReadersInUse{0U};
+
+    /// @brief whether the writer connection is currently leased
+    bool writerInUse{false};
+
+    /// @brief total time spent waiting for reader connections
+    std::chrono::nanoseconds totalReaderWait{0};
+
+    /// @brief longest time spent waiting for a reader connection
+    std::chrono::nanoseconds maxReaderWait{0};
+
+    /// @brief total time spent waiting for the writer connection
+    std::chrono::nanoseconds totalWriterWait{0};
+
+    /// @brief longest time spent waiting for the writer connection
+    std::chrono::nanoseconds maxWriterWait{0};
+
+    /// @brief fraction of the reader connections time spent leased since the
+    ///        pool was created, ranging from 0 to 1
+    double readersUtilization{0.0};
+
+    /// @brief fraction of the writer connection time spent leased since the
+    ///        pool was created, ranging from 0 to 1
+    double writerUtilization{0.0};
+  };
+
+  /// @brief deleted default constructor for allowing only construction when
+  ///        passing a path to the database
+  CrudWrapperPool() = delete;
+
+  /// @brief parametrized constructor that opens all the connections upfront
+  /// @param path filesystem path to the database
+  /// @param readersCount number of reader connections to open
+  /// @param options options applied to all the connections, where the open
+  ///                flags and the journal mode are overridden by the pool
+  /// @note throws the same exceptions of the CrudWrapper constructor, or
+  ///       std::invalid_argument for a zero readers count, or
+  ///       std::runtime_error if WAL journal mode could not be enabled
+  explicit CrudWrapperPool(
+      const std::convertible_to<std::filesystem::path> auto &path,
+      std::size_t readersCount = defaultReadersCount(),
+      CrudWrapperOptions const &options = CrudWrapperOptions::forProfile(
+          TuningProfile::ReadHeavy))
+      : m_writer{path, withOpenFlags(options, SQLITE_OPEN_READWRITE |
+                                                  SQLITE_OPEN_NOMUTEX)} {
+    if (readersCount == 0U) {
+      throw std::invalid_argument("Pool requires at least one reader");
+    }
+
+    // journal mode can't be changed by read-only connections, and it is
+    // persisted in the database, so readers open in WAL mode as well
+    if (m_writer.effectiveSettings().journalMode != JournalMode::Wal) {
+      throw std::runtime_error("Failed to enable WAL journal mode");
+    }
+
+    m_readers.reserve(readersCount);
+    m_idleReaders.reserve(readersCount);
+    for (std::size_t i{0U}; i < readersCount; ++i) {
+      m_readers.push_back(std::make_unique<CrudWrapper>(
+          path, withOpenFlags(options,
+                              SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX)));
+      m_idleReaders.push_back(m_readers.back().get());
+    }
+  }
+
+  /// @brief deleted copy and move operations, as leases refer to the pool
+  CrudWrapperPool(CrudWrapperPool const &) = delete;
+  CrudWrapperPool(CrudWrapperPool &&) = delete;
+  auto operator=(CrudWrapperPool const &) -> CrudWrapperPool & = delete;
+  auto operator=(CrudWrapperPool &&) -> CrudWrapperPool & = delete;
+  ~CrudWrapperPool() noexcept = default;
+
+  /// @brief method to lease a reader connection, blocking until one is idle
+  /// @return lease of a reader connection
+  [[nodiscard]] auto acquireReader() -> ReaderLease {
+    auto const waitStart{Clock_type::now()};
+    std::unique_lock lock{m_mutex};
+    m_readerReleased.wait(lock, [this] { return !m_idleReaders.empty(); });
+
+    CrudWrapper const *reader{m_idleReaders.back()};
+    m_idleReaders.pop_back();
+
+    recordWait(Clock_type::now() - waitStart, m_stats.totalReaderWait,
+               m_stats.maxReaderWait);
+    ++m_stats.readerLeases;
+    m_stats.peakReadersInUse =
+        std::max(m_stats.peakReadersInUse, readersInUse());
+
+    return ReaderLease{*this, *reader};
+  }
+
+  /// @brief method to lease the writer connection, blocking until it is idle
+  /// @return lease of the writer connection
+  [[nodiscard]] auto acquireWriter() -> WriterLease {
+    auto const waitStart{Clock_type::now()};
+    std::unique_lock lock{m_mutex};
+    m_writerReleased.wait(lock, [this] { return !m_writerInUse; });
+
+    m_writerInUse = true;
+
+    recordWait(Clock_type::now() - waitStart, m_stats.totalWriterWait,
+               m_stats.maxWriterWait);
+    ++m_stats.writerLeases;
+
+    return WriterLease{*this, m_writer};
+  }
+
+  /// @brief method to return a snapshot of the pool metrics
+  /// @return the pool metrics
+  [[nodiscard]] auto stats() const -> Stats {
+    std::scoped_lock const lock{m_mutex};
+
+    Stats stats{m_stats};
+    stats.readersCount = m_readers.size();
+    stats.readersInUse = readersInUse();
+    stats.writerInUse = m_writerInUse;
+
+    const std::chrono::duration<double> elapsed{Clock_type::now() -
+                                                m_createdAt};
+    if (elapsed.count() > 0.0) {
+      const std::chrono::duration<double> readersBusy{m_readersBusyTime};
+      const std::chrono::duration<double> writerBusy{m_writerBusyTime};
+
+      stats.readersUtilization =
+          readersBusy.count() /
+          (elapsed.count() * static_cast<double>(m_readers.size()));
+      stats.writerUtilization = writerBusy.count() / elapsed.count();
+    }
+
+    return stats;
+  }
+
+  /// @brief method to scan all the rows of a table in parallel, by splitting
+  ///        the table into chunks of contiguous rowid ranges, each read into
+  ///        a result set by a reader connection on a worker thread
+  /// @param tableName the name of the table to scan, which must have rowids
+  /// @param onChunk function called with the index of a chunk and its rows,
+  ///                ordered by rowid, which is called concurrently from the
+  ///                worker threads
+  /// @param chunksCount the number of chunks, or zero for a chunk per reader
+  ///                    connection
+  /// @return the number of chunks scanned, which is zero for an empty table
+  /// @note throws std::invalid_argument if the table does not exist or has
+  ///       no rowids (i.e. views and WITHOUT ROWID tables), or the first
+  ///       exception thrown by onChunk once all the chunks were scanned
+  /// @note the rowid ranges are split evenly between the lowest and the
+  ///       highest rowids, so chunks hold similar numbers of rows as long as
+  ///       the rowids are dense
+  /// @note each chunk is read in its own read transaction, so chunks may see
+  ///       different snapshots of the table if it is written meanwhile
+  /// @note the calling thread must not hold all the reader leases, as each
+  ///       chunk leases a reader connection
+  template <std::invocable<std::size_t, ResultSet const &> OnChunk>
+  auto scanChunks(std::string const &tableName, OnChunk const &onChunk,
+                  std::size_t chunksCount = 0U) -> std::size_t {
+    auto const ranges{splitRowids(tableName, chunksCount)};
+    auto const statement{selectRowidRangeStatement(tableName)};
+
+    scanners().forEachIndex(ranges.size(), [&](std::size_t index) {
+      auto reader{acquireReader()};
+      auto chunkStatement{reader->prepareStatement(statement)};
+      chunkStatement.bindAll(ranges[index].first, ranges[index].second);
+      onChunk(index, reader->getResultSet(chunkStatement));
+    });
+
+    return ranges.size();
+  }
+
+  /// @brief method to read all the rows of a table in parallel, check
+  ///        scanChunks, merging the rows of the chunks in rowid order
+  /// @tparam Row the type of the rows to read, check CrudWrapper::getRowsAs
+  /// @param tableName the name of the table to read, which must have rowids
+  /// @param chunksCount the number of chunks, or zero for a chunk per reader
+  ///                    connection
+  /// @return the rows of the table, ordered by rowid
+  /// @note throws std::invalid_argument if the table does not exist or has
+  ///       no rowids
+  template <std::default_initializable Row>
+  auto parallelScan(std::string const &tableName, std::size_t chunksCount = 0U)
+      -> std::vector<Row> {
+    auto const ranges{splitRowids(tableName, chunksCount)};
+    auto const statement{selectRowidRangeStatement(tableName)};
+
+    std::vector<std::vector<Row>> chunks(ranges.size());
+    scanners().forEachIndex(ranges.size(), [&](std::size_t index) {
+      auto reader{acquireReader()};
+      auto chunkStatement{reader->prepareStatement(statement)};
+      chunkStatement.bindAll(ranges[index].first, ranges[index].second);
+      chunks[index] = reader->getRowsAs<Row>(chunkStatement);
+    });
+    if (chunks.size() == 1U) {
+      return std::move(chunks.front());
+    }
+
+    // the chunks are moved into place in parallel as well, since moving
+    // millions of rows costs as much as reading a chunk of them
+    std::vector<std::size_t> offsets(chunks.size() + 1U, 0U);
+    for (std::size_t i{0U}; i < chunks.size(); ++i) {
+      offsets[i + 1U] = offsets[i] + chunks[i].size();
+    }
+
+    std::vector<Row> rows(offsets.back());
+    scanners().forEachIndex(chunks.size(), [&](std::size_t index) {
+      std::ranges::move(chunks[index],
+                        rows.begin() +
+                            static_cast<std::ptrdiff_t>(offsets[index]));
+      chunks[index] = {};
+    });
+
+    return rows;
+  }
+
+  /// @brief static method to return the readers count used when none is
+  ///        specified, which is the number of hardware threads
+  /// @return the default readers count
+  static auto defaultReadersCount() noexcept -> std::size_t {
+    return std::max(1U, std::thread::hardware_concurrency());
+  }
+
+private:
+  /// @brief the single writer connection
+  CrudWrapper m_writer;
+
+  /// @brief the reader connections, allocated on the heap so that they have
+  ///        stable addresses
+  std::vector<std::unique_ptr<CrudWrapper const>> m_readers;
+
+  /// @brief the reader connections that are not leased
+  std::vector<CrudWrapper const *> m_idleReaders;
+
+  /// @brief whether the writer connection is leased
+  bool m_writerInUse{false};
+
+  /// @brief mutex guarding the state of the pool
+  mutable std::mutex m_mutex;
+
+  /// @brief condition signaled when a reader connection gets idle
+  std::condition_variable m_readerReleased;
+
+  /// @brief condition signaled when the writer connection gets idle
+  std::condition_variable m_writerReleased;
+
+  /// @brief the metrics of the pool, where the current state is filled on
+  ///        demand
+  Stats m_stats;
+
+  /// @brief the worker threads of parallel scans, with a thread per reader
+  ///        connection, which are started by the first scan
+  std::unique_ptr<ThreadPool> m_scanners;
+
+  /// @brief flag starting the worker threads of parallel scans once
+  std::once_flag m_scannersStarted;
+
+  /// @brief the time the pool was created at
+  Clock_type::time_point m_createdAt{Clock_type::now()};
+
+  /// @brief total time reader connections spent leased
+  Clock_type::duration m_readersBusyTime{0};
+
+  /// @brief total time the writer connection spent leased
+  Clock_type::duration m_writerBusyTime{0};
+
+  /// @brief private method to return a reader connection to the pool
+  /// @param reader the reader connection
+  /// @param leaseDuration the time the connection was leased for
+  void release(CrudWrapper const *reader,
+               Clock_type::duration leaseDuration) noexcept {
+    {
+      std::scoped_lock const lock{m_mutex};
+      m_idleReaders.push_back(reader);
+      m_readersBusyTime += leaseDuration;
+    }
+
+    m_readerReleased.notify_one();
+  }
+
+  /// @brief private method to return the writer connection to the pool
+  /// @param leaseDuration the time the connection was leased for
+  void release(CrudWrapper * /*writer*/,
+               Clock_type::duration leaseDuration) noexcept {
+    {
+      std::scoped_lock const lock{m_mutex};
+      m_writerInUse = false;
+      m_writerBusyTime += leaseDuration;
+    }
+
+    m_writerReleased.notify_one();
+  }
+
+  /// @brief private static method to return a copy of the options with the
+  ///        given open flags and WAL journal mode
+  /// @param options the options to copy
+  /// @param openFlags the open flags to use
+  /// @return the copy of the options
+  static auto withOpenFlags(CrudWrapperOptions options, int openFlags) noexcept
+      -> CrudWrapperOptions {
+    options.openFlags = openFlags;
+    options.pragmas.journalMode = JournalMode::Wal;
+
+    return options;
+  }
+
+  /// @brief private method to return the worker threads of parallel scans,
+  ///        starting them on the first call
+  /// @return the worker threads of parallel scans
+  auto scanners() -> ThreadPool & {
+    std::call_once(m_scannersStarted, [this] {
+      m_scanners = std::make_unique<ThreadPool>(m_readers.size());
+    });
+
+    return *m_scanners;
+  }
+
+  /// @brief private method to split the rowids of a table into contiguous
+  ///        ranges of similar widths
+  /// @param tableName the name of the table
+  /// @param chunksCount the number of ranges, or zero for a range per reader
+  ///                    connection
+  /// @return the inclusive rowid ranges, in ascending order, which are fewer
+  ///         than requested if the table has fewer rowids, or none if the
+  ///         table is empty
+  /// @note throws std::invalid_argument if the table does not exist or has
+  ///       no rowids
+  auto splitRowids(std::string const &tableName, std::size_t chunksCount)
+      -> std::vector<std::pair<std::int64_t, std::int64_t>> {
+    auto reader{acquireReader()};
+    auto const table{reader->tableInfo(tableName)};
+    if (table == nullptr || table->type != "table" || table->withoutRowid) {
+      throw std::invalid_argument("Table " + tableName +
+                                  " can't be scanned by rowid ranges");
+    }
+
+    auto const bounds{
+        reader->getRowsAs<std::tuple<std::optional<std::int64_t>,
+                                     std::optional<std::int64_t>>>(
+            reader->prepareStatement("SELECT MIN(rowid), MAX(rowid) FROM " +
+                                     tableName))};
+    if (bounds.empty() || !std::get<0>(bounds.front()).has_value()) {
+      return {};
+    }
+
+    // unsigned arithmetic, as the width of the rowids may overflow int64
+    auto const first{static_cast<std::uint64_t>(*std::get<0>(bounds.front()))};
+    auto const last{static_cast<std::uint64_t>(*std::get<1>(bounds.front()))};
+    auto const width{last - first};
+    auto const count{std::min<std::uint64_t>(
+        chunksCount == 0U ? m_readers.size() : chunksCount,
+        width == std::numeric_limits<std::uint64_t>::max() ? width
+                                                           : width + 1U)};
+
+    // the width + 1 rowids are spread evenly, the first ranges taking one
+    // more rowid each when they don't divide evenly
+    auto rangeSize{width / count};
+    auto longerRanges{width % count + 1U};
+    if (longerRanges == count) {
+      ++rangeSize;
+      longerRanges = 0U;
+    }
+
+    std::vector<std::pair<std::int64_t, std::int64_t>> ranges;
+    ranges.reserve(count);
+    auto rangeFirst{first};
+    for (std::uint64_t i{0U}; i < count; ++i) {
+      auto const rangeLast{rangeFirst + rangeSize -
+                           (i < longerRanges ? 0U : 1U)};
+      ranges.emplace_back(static_cast<std::int64_t>(rangeFirst),
+                          static_cast<std::int64_t>(rangeLast));
+      rangeFirst = rangeLast + 1U;
+    }
+
+    return ranges;
+  }
+
+  /// @brief private static method to build the SELECT statement reading the
+  ///        rows of a rowid range of a table
+  /// @param tableName the name of the table
+  /// @return the SELECT statement, with placeholders for the first and the
+  ///         last rowids of the range
+  static auto selectRowidRangeStatement(std::string const &tableName)
+      -> std::string {
+    // the range is a seek on the table b-tree, read in rowid order
+    return "SELECT * FROM " + tableName +
+           " WHERE rowid BETWEEN ? AND ? ORDER BY rowid";
+  }
+
+  /// @brief private method to return the number of leased reader connections
+  /// @return the number of leased reader connections
+  /// @note it expects the mutex to be locked by the caller
+  auto readersInUse() const noexcept -> std::size_t {
+    return m_readers.size() - m_idleReaders.size();
+  }
+
+  /// @brief private static method to accumulate a wait time into metrics
+  /// @param wait the time waited
+  /// @param total the total wait time to add to
+  /// @param max the longest wait time to update
+  static void recordWait(Clock_type::duration wait,
+                         std::chrono::nanoseconds &total,
+                         std::chrono::nanoseconds &max) noexcept {
+    auto const waitNs{std::chrono::duration_cast<std::chrono::nanoseconds>(wait)};
+    total += waitNs;
+    max = std::max(max, waitNs);
+  }
+};
+
+} // namespace sql_with_cpp
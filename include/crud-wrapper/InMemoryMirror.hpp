@@ -0,0 +1,255 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <sqlite3.h>
+#include <stdexcept>
+#include <string>
+
+#include "Sqlite3Handles.hpp"
+
+/// @brief namespace for SQL with c++
+namespace sql_with_cpp {
+
+/// @brief how the changes made to an in-memory mirror get written back to
+///        the database file it was loaded from
+enum class MirrorSync {
+  /// @brief changes stay in memory, and are lost once the mirror is closed
+  Never,
+
+  /// @brief the file is updated after each write that gets committed
+  OnCommit,
+
+  /// @brief the file is updated by the first write committed once the sync
+  ///        interval elapsed since the last update, and once more on close
+  Periodic
+};
+
+/// @brief options for serving a database from an in-memory mirror of its
+///        file, check CrudWrapperOptions::mirror
+struct MirrorOptions {
+  /// @brief interval between the updates of the file when none is specified
+  static constexpr std::chrono::milliseconds kDefaultSyncInterval{1000};
+
+  /// @brief how changes get written back to the database file
+  MirrorSync sync{MirrorSync::Never};
+
+  /// @brief minimum interval between two updates of the file, used by
+  ///        MirrorSync::Periodic
+  std::chrono::milliseconds syncInterval{kDefaultSyncInterval};
+};
+
+/// @brief metrics describing the cost of an in-memory mirror
+struct MirrorStats {
+  /// @brief time spent copying the database file into memory
+  std::chrono::nanoseconds loadTime{0};
+
+  /// @brief number of pages of the database, as of its last copy
+  std::size_t pagesCount{0U};
+
+  /// @brief number of times the file was updated from memory
+  std::size_t syncsCount{0U};
+
+  /// @brief total time spent updating the file from memory
+  std::chrono::nanoseconds totalSyncTime{0};
+
+  /// @brief whether the mirror holds changes not written to the file yet
+  bool dirty{false};
+};
+
+/// @brief an in-memory database loaded from a database file with the backup
+///        API, which keeps a connection to the file for writing changes back
+/// @note the in-memory database is owned by its CrudWrapper, and the mirror
+///       has to be destroyed before it gets closed
+/// @note this class is not thread safe, just like the connection it serves
+class InMemoryMirror {
+  /// @brief clock used for measuring load and sync times
+  using Clock_type = std::chrono::steady_clock;
+
+public:
+  /// @brief deleted default constructor for allowing only construction when
+  ///        loading a database file
+  InMemoryMirror() = delete;
+
+  /// @brief parametrized constructor that copies a database file into an
+  ///        in-memory database
+  /// @param memoryDb the empty in-memory database to copy the file into
+  /// @param path filesystem path to the database file
+  /// @param openFlags flags the file is opened with by sqlite3_open_v2, whose
+  ///                  threading mode is always SQLITE_OPEN_NOMUTEX
+  /// @param options how changes get written back to the file
+  /// @note throws std::invalid_argument if changes have to be written back
+  ///       to a file opened read-only, or std::runtime_error if the file
+  ///       could not be opened or copied
+  InMemoryMirror(sqlite3 *memoryDb, std::filesystem::path const &path,
+                 int openFlags, MirrorOptions const &options)
+      : m_memoryDb{memoryDb}, m_options{options} {
+    if (m_options.sync != MirrorSync::Never &&
+        (openFlags & SQLITE_OPEN_READWRITE) == 0) {
+      throw std::invalid_argument(
+          "Mirror can't sync to a database opened read-only");
+    }
+
+    // the file connection is private to this object, which is not thread
+    // safe anyway, so it goes without a mutex: backups lock the mutexes of
+    // both their connections, in opposite orders when loading and syncing
+    auto const fileOpenFlags{(openFlags & ~SQLITE_OPEN_FULLMUTEX) |
+                             SQLITE_OPEN_NOMUTEX};
+    sqlite3 *fileDbPtr{nullptr};
+    constexpr auto defaultVfs{nullptr};
+    const int rCode{sqlite3_open_v2(path.string().c_str(), &fileDbPtr,
+                                    fileOpenFlags, defaultVfs)};
+    m_fileDb = Db_Ptr_type{fileDbPtr};
+    if (rCode != SQLITE_OK) {
+      throw std::runtime_error(
+          std::string{"Failed to open database, sqlite3 error: "} +
+          sqlite3_errstr(rCode));
+    }
+
+    auto const startTime{Clock_type::now()};
+    if (copy(m_memoryDb, m_fileDb.get()) != SQLITE_OK) {
+      throw std::runtime_error(
+          std::string{"Failed to load database into memory, sqlite3 "
+                      "error: "} +
+          sqlite3_errmsg(m_memoryDb));
+    }
+    m_stats.loadTime = Clock_type::now() - startTime;
+    m_lastSyncAt = Clock_type::now();
+    m_syncedDataVersion = dataVersion();
+  }
+
+  /// @brief deleted copy and move operations, as the mirror is held on the
+  ///        heap by its CrudWrapper
+  InMemoryMirror(InMemoryMirror const &) = delete;
+  InMemoryMirror(InMemoryMirror &&) = delete;
+  auto operator=(InMemoryMirror const &) -> InMemoryMirror & = delete;
+  auto operator=(InMemoryMirror &&) -> InMemoryMirror & = delete;
+
+  /// @brief destructor that writes the pending changes back to the file,
+  ///        unless they are meant to stay in memory
+  ~InMemoryMirror() noexcept {
+    if (m_options.sync != MirrorSync::Never) {
+      sync();
+    }
+  }
+
+  /// @brief method to write the changes back to the file if they are due,
+  ///        which is called after each write to the in-memory database
+  /// @return false if the file had to be updated but could not be, true
+  ///         otherwise
+  auto afterWrite() noexcept -> bool {
+    switch (m_options.sync) {
+    case MirrorSync::OnCommit:
+      return sync();
+    case MirrorSync::Periodic:
+      return Clock_type::now() - m_lastSyncAt < m_options.syncInterval ||
+             sync();
+    case MirrorSync::Never:
+      break;
+    }
+
+    return true;
+  }
+
+  /// @brief method to write the committed changes back to the file, which
+  ///        replaces the content of the file with the in-memory database
+  /// @return true if the file holds all the committed changes, false if it
+  ///         could not be updated
+  /// @note committed changes can't be written back while a transaction is
+  ///       open on the in-memory database, as the file would get its
+  ///       uncommitted changes as well
+  auto sync() noexcept -> bool {
+    if (!dirty()) {
+      return true;
+    }
+    // the changes of an open transaction are not committed yet
+    if (sqlite3_get_autocommit(m_memoryDb) == 0) {
+      return false;
+    }
+
+    auto const startTime{Clock_type::now()};
+    if (copy(m_fileDb.get(), m_memoryDb) != SQLITE_OK) {
+      return false;
+    }
+    m_lastSyncAt = Clock_type::now();
+    m_stats.totalSyncTime += m_lastSyncAt - startTime;
+    ++m_stats.syncsCount;
+    m_syncedDataVersion = dataVersion();
+
+    return true;
+  }
+
+  /// @brief method to check whether the in-memory database holds changes not
+  ///        written to the file yet
+  /// @return true if there are pending changes, false otherwise
+  [[nodiscard]] auto dirty() const noexcept -> bool {
+    return dataVersion() != m_syncedDataVersion;
+  }
+
+  /// @brief method to return a snapshot of the mirror metrics
+  /// @return the mirror metrics
+  [[nodiscard]] auto stats() const noexcept -> MirrorStats {
+    MirrorStats stats{m_stats};
+    stats.dirty = dirty();
+
+    return stats;
+  }
+
+private:
+  /// @brief the in-memory database, owned by the CrudWrapper of the mirror
+  sqlite3 *m_memoryDb{nullptr};
+
+  /// @brief the connection to the database file
+  Db_Ptr_type m_fileDb{nullptr};
+
+  /// @brief how changes get written back to the file
+  MirrorOptions m_options;
+
+  /// @brief the metrics of the mirror, where the dirty flag is filled on
+  ///        demand
+  MirrorStats m_stats;
+
+  /// @brief the time the file was last loaded or updated at
+  Clock_type::time_point m_lastSyncAt;
+
+  /// @brief the data version of the in-memory database when the file was
+  ///        last loaded or updated
+  std::optional<unsigned int> m_syncedDataVersion;
+
+  /// @brief private method to copy all the pages of a database into another
+  ///        in a single step, recording the pages count
+  /// @param destination the database to overwrite
+  /// @param source the database to copy
+  /// @return the result code of the copy
+  auto copy(sqlite3 *destination, sqlite3 *source) noexcept -> int {
+    auto *backup{sqlite3_backup_init(destination, "main", source, "main")};
+    if (backup == nullptr) {
+      return sqlite3_errcode(destination);
+    }
+
+    constexpr int allPages{-1};
+    sqlite3_backup_step(backup, allPages);
+    m_stats.pagesCount =
+        static_cast<std::size_t>(sqlite3_backup_pagecount(backup));
+
+    return sqlite3_backup_finish(backup);
+  }
+
+  /// @brief private method to read the data version of the in-memory
+  ///        database, which changes with every commit, including the commits
+  ///        of its own connection unlike PRAGMA data_version
+  /// @return the data version, or std::nullopt if it could not be read
+  auto dataVersion() const noexcept -> std::optional<unsigned int> {
+    unsigned int version{0U};
+    if (sqlite3_file_control(m_memoryDb, "main", SQLITE_FCNTL_DATA_VERSION,
+                             &version) != SQLITE_OK) {
+      return std::nullopt;
+    }
+
+    return version;
+  }
+};
+
+} // namespace sql_with_cpp
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <sqlite3.h>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "ResultSet.hpp"
+
+/// @brief namespace for SQL with c++
+namespace sql_with_cpp {
+
+/// @brief a page of the rows of a table, read by CrudWrapper::getPage
+struct Page {
+  /// @brief the rows of the page, in the order of the ordering key
+  ResultSet rows;
+
+  /// @brief the opaque token to pass to read the next page, which is empty if
+  ///        this is the last page
+  std::string continuationToken;
+
+  /// @brief method to check whether there are no pages after this one
+  /// @return true if this is the last page, false otherwise
+  [[nodiscard]] auto isLast() const noexcept -> bool {
+    return continuationToken.empty();
+  }
+};
+
+/// @brief namespace for the implementation details of pagination
+namespace detail {
+
+/// @brief a value of an ordering key, typed as stored by SQLite
+using KeyValue_type = std::variant<std::nullptr_t, std::int64_t, double,
+                                   std::string, std::vector<std::byte>>;
+
+/// @brief function to encode the values of an ordering key into a
+///        continuation token, keeping their types so that they compare as the
+///        stored values once bound back
+/// @param stmt the stepped statement whose current row holds the key values
+/// @param firstColumn the index of the column of the first key value
+/// @param keySize the number of key values
+/// @return the continuation token, which is printable (hexadecimal) so it
+///         can be passed around in URLs or JSON
+inline auto encodeKey(sqlite3_stmt *stmt, int firstColumn,
+                      std::size_t keySize) -> std::string {
+  std::string key;
+  for (std::size_t i{0U}; i < keySize; ++i) {
+    auto const column{firstColumn + static_cast<int>(i)};
+    switch (sqlite3_column_type(stmt, column)) {
+    case SQLITE_INTEGER:
+      key += 'i' + std::to_string(sqlite3_column_int64(stmt, column)) + ';';
+      break;
+    case SQLITE_FLOAT: {
+      // the shortest representation that reads back as the same double
+      std::array<char, 32U> digits{};
+      auto const [end, errc]{std::to_chars(
+          digits.data(), digits.data() + digits.size(),
+          sqlite3_column_double(stmt, column))};
+      key += 'f' + std::string{digits.data(), end} + ';';
+      break;
+    }
+    case SQLITE_TEXT: {
+      // text has to be read before its size, check Column::append
+      auto const *text{
+          reinterpret_cast<char const *>(sqlite3_column_text(stmt, column))};
+      auto const size{
+          static_cast<std::size_t>(sqlite3_column_bytes(stmt, column))};
+      key += 't' + std::to_string(size) + ':';
+      key.append(text, size);
+      break;
+    }
+    case SQLITE_BLOB: {
+      auto const *blob{
+          static_cast<char const *>(sqlite3_column_blob(stmt, column))};
+      auto const size{
+          static_cast<std::size_t>(sqlite3_column_bytes(stmt, column))};
+      key += 'b' + std::to_string(size) + ':';
+      key.append(blob == nullptr ? "" : blob, size);
+      break;
+    }
+    default:
+      key += 'n';
+      break;
+    }
+  }
+
+  constexpr std::string_view hexDigits{"0123456789abcdef"};
+  std::string token;
+  token.reserve(key.size() * 2U);
+  for (auto const c : key) {
+    auto const byte{static_cast<unsigned char>(c)};
+    token += hexDigits[byte >> 4U];
+    token += hexDigits[byte & 0x0FU];
+  }
+
+  return token;
+}
+
+/// @brief function to decode the values of an ordering key out of a
+///        continuation token made by encodeKey
+/// @param token the continuation token
+/// @return the key values, or std::nullopt if the token is malformed
+inline auto
+decodeKey(std::string_view token) -> std::optional<std::vector<KeyValue_type>> {
+  if (token.size() % 2U != 0U) {
+    return std::nullopt;
+  }
+
+  std::string key;
+  key.reserve(token.size() / 2U);
+  for (std::size_t i{0U}; i < token.size(); i += 2U) {
+    unsigned int byte{0U};
+    auto const [end, errc]{
+        std::from_chars(token.data() + i, token.data() + i + 2U, byte, 16)};
+    if (errc != std::errc{} || end != token.data() + i + 2U) {
+      return std::nullopt;
+    }
+    key += static_cast<char>(byte);
+  }
+
+  std::vector<KeyValue_type> values;
+  std::string_view rest{key};
+  // reads the characters of rest up to a delimiter, dropping the delimiter
+  auto const readUntil{
+      [&rest](char delimiter) -> std::optional<std::string_view> {
+        auto const end{rest.find(delimiter)};
+        if (end == std::string_view::npos) {
+          return std::nullopt;
+        }
+
+        auto const field{rest.substr(0U, end)};
+        rest.remove_prefix(end + 1U);
+        return field;
+      }};
+
+  while (!rest.empty()) {
+    auto const tag{rest.front()};
+    rest.remove_prefix(1U);
+
+    if (tag == 'n') {
+      values.emplace_back(nullptr);
+      continue;
+    }
+
+    auto const field{readUntil(tag == 'i' || tag == 'f' ? ';' : ':')};
+    if (!field.has_value()) {
+      return std::nullopt;
+    }
+
+    auto const *first{field->data()};
+    auto const *last{field->data() + field->size()};
+    if (tag == 'i') {
+      std::int64_t integer{0};
+      auto const [end, errc]{std::from_chars(first, last, integer)};
+      if (errc != std::errc{} || end != last) {
+        return std::nullopt;
+      }
+      values.emplace_back(integer);
+      continue;
+    }
+    if (tag == 'f') {
+      double real{0.0};
+      auto const [end, errc]{std::from_chars(first, last, real)};
+      if (errc != std::errc{} || end != last) {
+        return std::nullopt;
+      }
+      values.emplace_back(real);
+      continue;
+    }
+
+    std::size_t size{0U};
+    auto const [end, errc]{std::from_chars(first, last, size)};
+    if ((tag != 't' && tag != 'b') || errc != std::errc{} || end != last ||
+        size > rest.size()) {
+      return std::nullopt;
+    }
+
+    auto const bytes{rest.substr(0U, size)};
+    rest.remove_prefix(size);
+    if (tag == 't') {
+      values.emplace_back(std::string{bytes});
+    } else {
+      auto const *data{reinterpret_cast<std::byte const *>(bytes.data())};
+      values.emplace_back(std::vector<std::byte>{data, data + bytes.size()});
+    }
+  }
+
+  return values;
+}
+
+} // namespace detail
+
+} // namespace sql_with_cpp
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+/// @brief namespace for SQL with c++
+namespace sql_with_cpp {
+
+/// @brief a string literal usable as a template argument, holding the SQL
+///        text of a Query
+/// @tparam N the size of the literal, including its NUL terminator
+template <std::size_t N> struct FixedString {
+  /// @brief the characters of the literal, including its NUL terminator
+  std::array<char, N> text{};
+
+  /// @brief implicit constructor from a string literal, so that literals can
+  ///        be passed as template arguments directly
+  /// @param literal the string literal
+  consteval FixedString(char const (&literal)[N]) noexcept {
+    std::copy_n(literal, N, text.begin());
+  }
+
+  /// @brief method to view the characters of the literal
+  /// @return view to the literal, without its NUL terminator
+  [[nodiscard]] constexpr auto view() const noexcept -> std::string_view {
+    return {text.data(), N - 1U};
+  }
+};
+
+/// @brief the types of the result columns of a Query, read in order
+/// @tparam Columns the types of the columns, check readColumn
+template <typename... Columns> struct Result {
+  /// @brief type of the rows read by the query
+  using Row_type = std::tuple<Columns...>;
+};
+
+/// @brief specialization for a single result column, read as a plain value
+/// @tparam Column the type of the column, check readColumn
+template <typename Column> struct Result<Column> {
+  /// @brief type of the rows read by the query
+  using Row_type = Column;
+};
+
+/// @brief the types of the parameters of a Query, bound to its placeholders in
+///        order
+/// @tparam Values the types of the parameters, check
+///                PreparedStatement::bindAll
+template <typename... Values> struct Params {};
+
+/// @brief namespace for the implementation details of queries
+namespace detail {
+
+/// @brief function to count the ? placeholders of an SQL text, skipping
+///        quoted strings and identifiers, and comments
+/// @param sql the SQL text
+/// @return the number of placeholders, or std::nullopt if the text has a
+///         numbered (?NNN) or named (:AAA, @AAA, $AAA) placeholder, or an
+///         unterminated quote
+constexpr auto
+countPlaceholders(std::string_view sql) noexcept -> std::optional<std::size_t> {
+  auto const isDigit{[](char c) { return c >= '0' && c <= '9'; }};
+  auto const isIdentifier{[&isDigit](char c) {
+    return isDigit(c) || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+           c == '_' || c == '$';
+  }};
+
+  std::size_t count{0U};
+  for (std::size_t i{0U}; i < sql.size(); ++i) {
+    auto const next{i + 1U < sql.size() ? sql[i + 1U] : '\0'};
+    switch (sql[i]) {
+    case '\'':
+    case '"':
+    case '`':
+    case '[': {
+      // doubled quotes escape a quote, and read here as two quoted strings
+      auto const end{sql.find(sql[i] == '[' ? ']' : sql[i], i + 1U)};
+      if (end == std::string_view::npos) {
+        return std::nullopt;
+      }
+      i = end;
+      break;
+    }
+    case '-':
+      if (next == '-') {
+        i = std::min(sql.find('\n', i), sql.size());
+      }
+      break;
+    case '/':
+      // SQLite ends an unterminated block comment at the end of the text
+      if (next == '*') {
+        auto const end{sql.find("*/", i + 2U)};
+        i = end == std::string_view::npos ? sql.size() : end + 1U;
+      }
+      break;
+    case '?':
+      if (isDigit(next)) {
+        return std::nullopt;
+      }
+      ++count;
+      break;
+    case ':':
+    case '@':
+    case '$':
+      if (isIdentifier(next) && (i == 0U || !isIdentifier(sql[i - 1U]))) {
+        return std::nullopt;
+      }
+      break;
+    default:
+      break;
+    }
+  }
+
+  return count;
+}
+
+/// @brief a trait to detect column types viewing the memory of a statement,
+///        which would dangle once the rows of a query are returned
+template <typename T>
+struct IsView
+    : std::bool_constant<std::same_as<T, std::string_view> ||
+                         std::same_as<T, std::span<const std::byte>>> {};
+
+/// @brief specialization of the trait for std::optional
+template <typename T> struct IsView<std::optional<T>> : IsView<T> {};
+
+} // namespace detail
+
+/// @brief primary template of a query, check the specialization
+template <FixedString Sql, typename ResultColumns = Result<>,
+          typename ParamsValues = Params<>>
+class Query;
+
+/// @brief an SQL query whose text, parameters and result columns are known at
+///        compile time, run by CrudWrapper::run, e.g.
+///        Query<"SELECT Name FROM City WHERE ID = ?", Result<std::string>,
+///              Params<std::int64_t>>
+/// @tparam Sql the SQL text of a single statement, with ? placeholders
+/// @tparam Columns the types of the result columns, none for writes
+/// @tparam Values the types of the parameters, one per placeholder
+/// @note a mismatch between the placeholders and the parameters fails to
+///       compile, while the result columns are checked against the prepared
+///       statement, as counting them takes the parser of SQLite
+/// @note binding and reading are resolved at compile time from the declared
+///       types, so no types get checked or switched on at run time
+template <FixedString Sql, typename... Columns, typename... Values>
+class Query<Sql, Result<Columns...>, Params<Values...>> {
+public:
+  /// @brief the SQL text of the query
+  static constexpr std::string_view kSql{Sql.view()};
+
+  /// @brief the number of parameters of the query
+  static constexpr std::size_t kParamsCount{sizeof...(Values)};
+
+  /// @brief the number of result columns of the query
+  static constexpr std::size_t kColumnsCount{sizeof...(Columns)};
+
+  /// @brief type of the rows read by the query, which is a std::tuple of the
+  ///        columns, or the column itself for a single column
+  using Row_type = typename Result<Columns...>::Row_type;
+
+  static_assert(detail::countPlaceholders(kSql).has_value(),
+                "Query SQL must close its quotes, and use ? placeholders "
+                "only");
+  static_assert(detail::countPlaceholders(kSql) == kParamsCount,
+                "Query SQL placeholders must match its Params");
+  static_assert((!detail::IsView<Columns>::value && ...),
+                "Query results can't be views, since they outlive their "
+                "statement");
+};
+
+} // namespace sql_with_cpp
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <sqlite3.h>
+#include <string_view>
+#include <utility>
+
+#include "BusyHandler.hpp"
+#include "ColumnReader.hpp"
+
+/// @brief namespace for SQL with c++
+namespace sql_with_cpp {
+
+/// @brief a lightweight, non-owning view over the current row of a statement
+/// @note the view, and any views read through it, are valid only until the
+///       statement is stepped to the next row
+class RowView {
+public:
+  /// @brief parametrized constructor for the row view
+  /// @param stmt the statement whose current row is viewed
+  explicit RowView(sqlite3_stmt *stmt) noexcept : m_stmt{stmt} {}
+
+  /// @brief method to return the number of columns in the row
+  /// @return number of columns in the row
+  [[nodiscard]] auto columnsCount() const noexcept -> std::size_t {
+    return static_cast<std::size_t>(sqlite3_column_count(m_stmt));
+  }
+
+  /// @brief method to return the name of a column in the row
+  /// @param index zero-based index of the column
+  /// @return name of the column, or an empty view for invalid indices
+  [[nodiscard]] auto columnName(std::size_t index) const noexcept
+      -> std::string_view {
+    const char *name{sqlite3_column_name(m_stmt, static_cast<int>(index))};
+    return name == nullptr ? std::string_view{} : std::string_view{name};
+  }
+
+  /// @brief method to check whether a column in the row holds NULL
+  /// @param index zero-based index of the column
+  /// @return true if the column holds NULL, false otherwise
+  [[nodiscard]] auto isNull(std::size_t index) const noexcept -> bool {
+    return sqlite3_column_type(m_stmt, static_cast<int>(index)) == SQLITE_NULL;
+  }
+
+  /// @brief method to read a column in the row as the requested type
+  /// @tparam T the type to read the column as, check readColumn for the
+  ///           supported types
+  /// @param index zero-based index of the column
+  /// @return value of the column
+  template <typename T>
+  [[nodiscard]] auto get(std::size_t index) const noexcept -> T {
+    return readColumn<T>(m_stmt, static_cast<int>(index));
+  }
+
+  /// @brief method to read a column in the row as text without copying it
+  /// @param index zero-based index of the column
+  /// @return view to the text of the column
+  [[nodiscard]] auto text(std::size_t index) const noexcept
+      -> std::string_view {
+    return get<std::string_view>(index);
+  }
+
+  /// @brief method to read the whole row as the requested type
+  /// @tparam Row a tuple-like type or a single column type, check readRow
+  /// @return the row read as the requested type
+  template <typename Row> [[nodiscard]] auto as() const noexcept -> Row {
+    return readRow<Row>(m_stmt);
+  }
+
+private:
+  /// @brief the statement whose current row is viewed
+  sqlite3_stmt *m_stmt{nullptr};
+};
+
+/// @brief an input range over the rows of a statement, which steps the
+///        statement lazily as it is iterated, so only the current row is held
+///        in memory at any time
+/// @tparam Statement type of the owned statement, which exposes the underlying
+///                   statement unique pointer through get()
+/// @note as in any input range, begin() shall be called only once
+template <typename Statement>
+class QueryRange : public std::ranges::view_interface<QueryRange<Statement>> {
+public:
+  /// @brief iterator over the rows of the range
+  class Iterator {
+  public:
+    using value_type = RowView;
+    using difference_type = std::ptrdiff_t;
+
+    /// @brief default constructor needed for iterator concepts
+    Iterator() noexcept = default;
+
+    /// @brief parametrized constructor for the iterator
+    /// @param range the range to iterate
+    explicit Iterator(QueryRange *range) noexcept : m_range{range} {}
+
+    /// @brief dereference operator returning a view over the current row
+    /// @return view over the current row
+    auto operator*() const noexcept -> RowView {
+      return RowView{m_range->rawStatement()};
+    }
+
+    /// @brief pre-increment operator stepping to the next row
+    /// @return reference to this iterator
+    auto operator++() noexcept -> Iterator & {
+      m_range->step();
+      return *this;
+    }
+
+    /// @brief post-increment operator stepping to the next row
+    void operator++(int) noexcept { ++*this; }
+
+    /// @brief comparison operator with the end sentinel
+    /// @param it the iterator to compare
+    /// @return true if no more rows are available, false otherwise
+    friend auto operator==(Iterator const &it,
+                           std::default_sentinel_t) noexcept -> bool {
+      return it.isAtEnd();
+    }
+
+  private:
+    /// @brief the range being iterated
+    QueryRange *m_range{nullptr};
+
+    /// @brief private method to check whether no more rows are available
+    /// @return true if no more rows are available, false otherwise
+    auto isAtEnd() const noexcept -> bool {
+      return m_range == nullptr || m_range->m_lastCode != SQLITE_ROW;
+    }
+  };
+
+  /// @brief parametrized constructor taking ownership of the statement
+  /// @param statement the statement to iterate its rows
+  /// @param initialResultCode an error code to report instead of iterating
+  ///                          the statement, e.g. if binding it failed
+  /// @param busyHandler the busy handler of the connection of the statement,
+  ///                    which retries its first step, or nullptr to step it
+  ///                    once, check BusyHandler::step
+  explicit QueryRange(Statement &&statement, int initialResultCode = SQLITE_OK,
+                      BusyHandler *busyHandler = nullptr) noexcept
+      : m_statement{std::move(statement)}, m_busyHandler{busyHandler},
+        m_lastCode{initialResultCode} {}
+
+  /// @brief method that steps to the first row and returns an iterator to it
+  /// @return iterator to the first row
+  auto begin() noexcept -> Iterator {
+    if (m_lastCode == SQLITE_OK) {
+      step();
+    }
+
+    return Iterator{this};
+  }
+
+  /// @brief method to return the end sentinel of the range
+  /// @return the end sentinel
+  auto end() const noexcept -> std::default_sentinel_t {
+    return std::default_sentinel;
+  }
+
+  /// @brief method to return the result code of the last step
+  /// @return SQLITE_ROW while iterating, SQLITE_DONE once all the rows were
+  ///         read successfully, or the error code that stopped the iteration
+  [[nodiscard]] auto lastResultCode() const noexcept -> int {
+    return m_lastCode;
+  }
+
+  /// @brief method to check whether the iteration stopped due to an error
+  /// @return true if an error occurred, false otherwise
+  [[nodiscard]] auto failed() const noexcept -> bool {
+    return m_lastCode != SQLITE_ROW && m_lastCode != SQLITE_DONE &&
+           m_lastCode != SQLITE_OK;
+  }
+
+private:
+  /// @brief the owned statement
+  Statement m_statement;
+
+  /// @brief the busy handler of the connection of the statement, if any
+  BusyHandler *m_busyHandler{nullptr};
+
+  /// @brief result code of the last step, SQLITE_OK before the first one
+  int m_lastCode{SQLITE_OK};
+
+  /// @brief private method to return the raw underlying statement
+  /// @return the raw underlying statement
+  auto rawStatement() const noexcept -> sqlite3_stmt * {
+    return m_statement.get().get();
+  }
+
+  /// @brief private method to step the statement to its next row
+  void step() noexcept {
+    if (rawStatement() == nullptr) {
+      m_lastCode = SQLITE_MISUSE;
+    } else {
+      m_lastCode = m_busyHandler == nullptr
+                       ? sqlite3_step(rawStatement())
+                       : m_busyHandler->step(rawStatement());
+    }
+  }
+};
+
+} // namespace sql_with_cpp
@@ -0,0 +1,416 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <optional>
+#include <sqlite3.h>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/// @brief namespace for SQL with c++
+namespace sql_with_cpp {
+
+/// @brief a memory bounded LRU cache of the results of read-only statements
+///        run on a single database connection, keyed by their SQL text with
+///        the bound values expanded into it
+/// @note cached results are invalidated per table as the connection changes
+///       rows (through sqlite3_update_hook), all at once when a transaction
+///       is rolled back, and all at once when the owner notices changes that
+///       the hook does not report, check synchronize()
+/// @note this class is not thread safe, just like the connection it serves
+class ResultCache {
+public:
+  /// @brief type of the cached rows, where the first row represents the
+  ///        columns names, just like CrudWrapper::getRows
+  using Rows_type = std::vector<std::vector<std::string>>;
+
+  /// @brief counters that describe how effective the cache is
+  struct Stats {
+    /// @brief number of lookups that found a cached result
+    std::size_t hits{0U};
+
+    /// @brief number of lookups that found no cached result
+    std::size_t misses{0U};
+
+    /// @brief number of results dropped to respect the memory budget
+    std::size_t evictions{0U};
+
+    /// @brief number of results dropped since the data they were read from
+    ///        changed
+    std::size_t invalidations{0U};
+
+    /// @brief number of results currently held
+    std::size_t size{0U};
+
+    /// @brief approximate number of bytes taken by the results held
+    std::size_t bytes{0U};
+
+    /// @brief maximum number of bytes taken by the results held
+    std::size_t budget{0U};
+  };
+
+  /// @brief parametrized constructor for the result cache
+  /// @param budget approximate maximum number of bytes taken by the cached
+  ///               results
+  explicit ResultCache(std::size_t budget) noexcept : m_budget{budget} {}
+
+  /// @brief deleted copy and move operations, as the hooks of the connection
+  ///        refer to this object
+  ResultCache(ResultCache const &) = delete;
+  ResultCache(ResultCache &&) = delete;
+  auto operator=(ResultCache const &) -> ResultCache & = delete;
+  auto operator=(ResultCache &&) -> ResultCache & = delete;
+  ~ResultCache() noexcept = default;
+
+  /// @brief method to register the hooks that invalidate the cache on the
+  ///        connection whose results it caches
+  /// @param db the database connection
+  /// @note this object must outlive the connection, or be detached first
+  void attach(sqlite3 *db) noexcept {
+    sqlite3_update_hook(db, &ResultCache::onUpdate, this);
+    sqlite3_rollback_hook(db, &ResultCache::onRollback, this);
+  }
+
+  /// @brief static method to unregister the hooks registered by attach
+  /// @param db the database connection
+  static void detach(sqlite3 *db) noexcept {
+    sqlite3_update_hook(db, nullptr, nullptr);
+    sqlite3_rollback_hook(db, nullptr, nullptr);
+  }
+
+  /// @brief method to look a result up, marking it as the most recently used
+  /// @param key the SQL text of the statement, with its bound values
+  ///            expanded, check sqlite3_expanded_sql
+  /// @return the cached result, or nullptr if none is cached
+  auto find(std::string_view key) noexcept
+      -> std::shared_ptr<const Rows_type> {
+    auto const it{m_index.find(key)};
+    if (it == m_index.end()) {
+      ++m_stats.misses;
+      return nullptr;
+    }
+
+    ++m_stats.hits;
+    m_lru.splice(m_lru.begin(), m_lru, it->second);
+    return it->second->rows;
+  }
+
+  /// @brief method to cache the result of a statement, evicting the least
+  ///        recently used results as needed to respect the memory budget
+  /// @param key the SQL text of the statement, with its bound values expanded
+  /// @param rows the result of the statement
+  /// @param tables the names of the tables the statement reads from
+  /// @note results larger than the whole budget are not cached
+  void insert(std::string key, std::shared_ptr<const Rows_type> rows,
+              std::vector<std::string> tables) {
+    auto const bytes{bytesOf(key, *rows)};
+    if (bytes > m_budget || m_index.contains(key)) {
+      return;
+    }
+
+    for (auto const &table : tables) {
+      ++m_entriesPerTable[table];
+    }
+    m_lru.push_front(Entry{.key = std::move(key),
+                           .rows = std::move(rows),
+                           .tables = std::move(tables),
+                           .bytes = bytes});
+    m_index.emplace(m_lru.front().key, m_lru.begin());
+    m_bytes += bytes;
+
+    evictExcessEntries();
+  }
+
+  /// @brief method to drop the results read from a table
+  /// @param table the name of the table
+  void invalidateTable(std::string_view table) noexcept {
+    auto const it{m_entriesPerTable.find(table)};
+    if (it == m_entriesPerTable.end()) {
+      return;
+    }
+
+    for (auto entry{m_lru.begin()}; entry != m_lru.end();) {
+      if (std::ranges::find(entry->tables, table) == entry->tables.end()) {
+        ++entry;
+        continue;
+      }
+
+      entry = erase(entry);
+      ++m_stats.invalidations;
+    }
+  }
+
+  /// @brief method to drop all the cached results
+  void clear() noexcept {
+    m_stats.invalidations += m_lru.size();
+    m_index.clear();
+    m_lru.clear();
+    m_entriesPerTable.clear();
+    m_bytes = 0U;
+  }
+
+  /// @brief method to drop all the cached results if the database changed in
+  ///        ways the hooks do not report, which are other connections
+  ///        committing changes, and changes the update hook skips (e.g.
+  ///        DELETE without WHERE, WITHOUT ROWID tables)
+  /// @param totalChanges the value of sqlite3_total_changes64 on the
+  ///                     connection
+  /// @param dataVersion the value of PRAGMA data_version on the connection,
+  ///                    which changes once another connection commits
+  void synchronize(std::int64_t totalChanges,
+                   std::int64_t dataVersion) noexcept {
+    if (dataVersion != m_dataVersion ||
+        totalChanges - m_totalChanges > m_hookedChanges) {
+      clear();
+    }
+
+    m_dataVersion = dataVersion;
+    m_totalChanges = totalChanges;
+    m_hookedChanges = 0;
+  }
+
+  /// @brief method to change the approximate maximum number of bytes taken by
+  ///        the cached results
+  /// @param budget the new budget
+  void setBudget(std::size_t budget) noexcept {
+    m_budget = budget;
+    evictExcessEntries();
+  }
+
+  /// @brief method to return a snapshot of the cache counters
+  /// @return the cache counters
+  [[nodiscard]] auto stats() const noexcept -> Stats {
+    Stats stats{m_stats};
+    stats.size = m_lru.size();
+    stats.bytes = m_bytes;
+    stats.budget = m_budget;
+
+    return stats;
+  }
+
+  /// @brief method to return the tables a statement reads from, which are
+  ///        found once per SQL text and remembered until the schema changes
+  /// @param db the database connection
+  /// @param sql the SQL text of the statement, without its bound values
+  /// @return check readDependencies
+  auto dependenciesOf(sqlite3 *db, char const *sql)
+      -> std::optional<std::vector<std::string>> const & {
+    auto it{m_dependencies.find(std::string_view{sql})};
+    if (it == m_dependencies.end()) {
+      if (m_dependencies.size() >= kMaxRememberedStatements) {
+        m_dependencies.clear();
+      }
+      it = m_dependencies.emplace(sql, readDependencies(db, sql)).first;
+    }
+
+    return it->second;
+  }
+
+  /// @brief method to drop all the cached results along with the remembered
+  ///        tables of statements, which is necessary once the schema changes
+  void resetSchema() noexcept {
+    clear();
+    m_dependencies.clear();
+  }
+
+  /// @brief static method to find the tables a statement reads from, by
+  ///        preparing it once more with an authorizer that records them
+  /// @param db the database connection
+  /// @param sql the SQL text of the statement
+  /// @return the names of the tables read, including the tables underlying
+  ///         views, or std::nullopt if the result of the statement must not
+  ///         be cached since it runs a PRAGMA or a function whose result
+  ///         changes from a call to another (e.g. random(), datetime())
+  /// @note setting an authorizer expires the prepared statements of the
+  ///       connection, which get prepared again once stepped
+  static auto readDependencies(sqlite3 *db, char const *sql)
+      -> std::optional<std::vector<std::string>> {
+    Dependencies dependencies;
+    sqlite3_set_authorizer(db, &ResultCache::onAuthorize, &dependencies);
+
+    sqlite3_stmt *stmt{nullptr};
+    constexpr auto useStrLenInternally{-1};
+    constexpr auto pzTailPtr{nullptr};
+    auto const rcode{
+        sqlite3_prepare_v2(db, sql, useStrLenInternally, &stmt, pzTailPtr)};
+    sqlite3_finalize(stmt);
+    sqlite3_set_authorizer(db, nullptr, nullptr);
+
+    if (rcode != SQLITE_OK || !dependencies.cacheable) {
+      return std::nullopt;
+    }
+
+    return std::move(dependencies.tables);
+  }
+
+private:
+  /// @brief a cached result along with the tables it was read from
+  struct Entry {
+    std::string key;
+    std::shared_ptr<const Rows_type> rows;
+    std::vector<std::string> tables;
+    std::size_t bytes;
+  };
+
+  /// @brief the tables recorded by the authorizer of readDependencies
+  struct Dependencies {
+    std::vector<std::string> tables;
+    bool cacheable{true};
+  };
+
+  /// @brief hash of strings that also hashes views to them, so that lookups
+  ///        do not need to build strings
+  struct StringHash {
+    using is_transparent = void;
+
+    auto operator()(std::string_view text) const noexcept -> std::size_t {
+      return std::hash<std::string_view>{}(text);
+    }
+  };
+
+  /// @brief functions whose result may change from a call to another
+  static constexpr std::array<std::string_view, 13U> kVolatileFunctions{
+      "random",       "randomblob",        "changes",
+      "total_changes", "last_insert_rowid", "date",
+      "time",          "datetime",          "julianday",
+      "unixepoch",     "strftime",          "current_date",
+      "current_time"};
+
+  /// @brief maximum number of SQL texts whose tables are remembered, past
+  ///        which they are all forgotten
+  static constexpr std::size_t kMaxRememberedStatements{256U};
+
+  /// @brief cached results ordered from the most to the least recently used
+  std::list<Entry> m_lru;
+
+  /// @brief index into the cached results, keys refer to Entry::key which
+  ///        stays valid as long as its list node exists
+  std::unordered_map<std::string_view, std::list<Entry>::iterator> m_index;
+
+  /// @brief number of cached results read from each table, so that changes
+  ///        to tables without cached results are skipped quickly
+  std::unordered_map<std::string, std::size_t, StringHash, std::equal_to<>>
+      m_entriesPerTable;
+
+  /// @brief the tables read by each SQL text, or std::nullopt for SQL texts
+  ///        whose results must not be cached
+  std::unordered_map<std::string, std::optional<std::vector<std::string>>,
+                     StringHash, std::equal_to<>>
+      m_dependencies;
+
+  /// @brief approximate maximum number of bytes taken by the results held
+  std::size_t m_budget{0U};
+
+  /// @brief approximate number of bytes taken by the results held
+  std::size_t m_bytes{0U};
+
+  /// @brief the last value of PRAGMA data_version given to synchronize
+  std::int64_t m_dataVersion{0};
+
+  /// @brief the last total changes count given to synchronize
+  std::int64_t m_totalChanges{0};
+
+  /// @brief number of changes reported by the update hook since the last
+  ///        call to synchronize
+  std::int64_t m_hookedChanges{0};
+
+  /// @brief cache counters, where size, bytes and budget are filled on demand
+  Stats m_stats;
+
+  /// @brief private static method to approximate the bytes taken by a result
+  /// @param key the key of the result
+  /// @param rows the rows of the result
+  /// @return the approximate number of bytes
+  static auto bytesOf(std::string const &key, Rows_type const &rows) noexcept
+      -> std::size_t {
+    auto bytes{sizeof(Entry) + key.size()};
+    for (auto const &row : rows) {
+      bytes += sizeof(row);
+      for (auto const &cell : row) {
+        bytes += sizeof(cell) + cell.size();
+      }
+    }
+
+    return bytes;
+  }
+
+  /// @brief private method to drop a cached result
+  /// @param entry iterator to the result to drop
+  /// @return iterator to the result following the dropped one
+  auto erase(std::list<Entry>::iterator entry) noexcept
+      -> std::list<Entry>::iterator {
+    for (auto const &table : entry->tables) {
+      if (auto const it{m_entriesPerTable.find(table)};
+          it != m_entriesPerTable.end() && --it->second == 0U) {
+        m_entriesPerTable.erase(it);
+      }
+    }
+
+    m_bytes -= entry->bytes;
+    m_index.erase(entry->key);
+    return m_lru.erase(entry);
+  }
+
+  /// @brief private method to drop the least recently used results until the
+  ///        budget is respected
+  void evictExcessEntries() noexcept {
+    while (m_bytes > m_budget && !m_lru.empty()) {
+      erase(std::prev(m_lru.end()));
+      ++m_stats.evictions;
+    }
+  }
+
+  /// @brief private static method called by sqlite3 for each row changed by
+  ///        the connection
+  static void onUpdate(void *cache, int /*operation*/, char const * /*db*/,
+                       char const *table, sqlite3_int64 /*rowid*/) noexcept {
+    auto *self{static_cast<ResultCache *>(cache)};
+    ++self->m_hookedChanges;
+    self->invalidateTable(table);
+  }
+
+  /// @brief private static method called by sqlite3 once a transaction of
+  ///        the connection gets rolled back, since results read within the
+  ///        transaction could hold changes that no longer exist
+  static void onRollback(void *cache) noexcept {
+    static_cast<ResultCache *>(cache)->clear();
+  }
+
+  /// @brief private static authorizer used by readDependencies, which records
+  ///        the tables read and the functions called, and allows everything
+  static auto onAuthorize(void *dependencies, int action, char const *arg1,
+                          char const *arg2, char const * /*db*/,
+                          char const * /*trigger*/) noexcept -> int {
+    auto &self{*static_cast<Dependencies *>(dependencies)};
+
+    if (action == SQLITE_READ && arg1 != nullptr &&
+        std::ranges::find(self.tables, std::string_view{arg1}) ==
+            self.tables.end()) {
+      self.tables.emplace_back(arg1);
+    } else if (action == SQLITE_PRAGMA) {
+      self.cacheable = false;
+    } else if (action == SQLITE_FUNCTION && arg2 != nullptr) {
+      std::string name{arg2};
+      std::ranges::transform(name, name.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+      });
+      if (std::ranges::find(kVolatileFunctions, name) !=
+          kVolatileFunctions.end()) {
+        self.cacheable = false;
+      }
+    }
+
+    return SQLITE_OK;
+  }
+};
+
+} // namespace sql_with_cpp
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <memory_resource>
+#include <ranges>
+#include <span>
+#include <sqlite3.h>
+#include <string_view>
+#include <vector>
+
+/// @brief namespace for SQL with c++
+namespace sql_with_cpp {
+
+/// @brief the rows of a statement result, where the bytes of all the cells
+///        are stored contiguously in a monotonic arena, and each row is
+///        exposed as a span of views to its cells
+/// @note reading a result takes a few allocations for its whole lifetime
+///       instead of one per row and per cell, and destroying it releases the
+///       arena at once
+/// @note views to the cells stay valid as long as the result set exists, even
+///       if it was moved
+class ResultSet {
+public:
+  /// @brief size of the first buffer of the arena, where later buffers grow
+  ///        geometrically
+  static constexpr std::size_t kInitialArenaSize{16U * 1024U};
+
+  /// @brief parametrized constructor for an empty result set
+  /// @param upstream memory resource the arena and the cells table allocate
+  ///                 from
+  explicit ResultSet(std::pmr::memory_resource *upstream =
+                         std::pmr::get_default_resource())
+      : m_arena{std::make_unique<std::pmr::monotonic_buffer_resource>(
+            kInitialArenaSize, upstream)},
+        m_columnsNames{upstream}, m_cells{upstream} {}
+
+  /// @brief method to return the number of columns of each row
+  /// @return the number of columns
+  [[nodiscard]] auto columnsCount() const noexcept -> std::size_t {
+    return m_columnsNames.size();
+  }
+
+  /// @brief method to return the number of rows, without the columns names
+  /// @return the number of rows
+  [[nodiscard]] auto rowsCount() const noexcept -> std::size_t {
+    return m_columnsNames.empty() ? 0U : m_cells.size() / m_columnsNames.size();
+  }
+
+  /// @brief method to check whether the result has no rows
+  /// @return true if there are no rows, false otherwise
+  [[nodiscard]] auto empty() const noexcept -> bool { return m_cells.empty(); }
+
+  /// @brief method to return the names of the columns
+  /// @return span of views to the names of the columns
+  [[nodiscard]] auto
+  columnsNames() const noexcept -> std::span<const std::string_view> {
+    return m_columnsNames;
+  }
+
+  /// @brief method to return the cells of a row
+  /// @param index the index of the row, which must be less than rowsCount()
+  /// @return span of views to the cells of the row, where NULL cells are
+  ///         views with a null data pointer
+  [[nodiscard]] auto
+  row(std::size_t index) const noexcept -> std::span<const std::string_view> {
+    return std::span{m_cells}.subspan(index * columnsCount(), columnsCount());
+  }
+
+  /// @brief subscript operator to the cells of a row, check row()
+  /// @param index the index of the row
+  /// @return span of views to the cells of the row
+  auto operator[](std::size_t index) const noexcept
+      -> std::span<const std::string_view> {
+    return row(index);
+  }
+
+  /// @brief method to return a view over all the rows, as spans of views to
+  ///        their cells
+  /// @return random access view of the rows
+  [[nodiscard]] auto rows() const noexcept {
+    return std::views::iota(std::size_t{0U}, rowsCount()) |
+           std::views::transform(
+               [this](std::size_t index) { return row(index); });
+  }
+
+  /// @brief method to check whether a cell is NULL
+  /// @param rowIndex the index of the row
+  /// @param columnIndex the index of the column
+  /// @return true if the cell is NULL, false otherwise
+  [[nodiscard]] auto isNull(std::size_t rowIndex,
+                            std::size_t columnIndex) const noexcept -> bool {
+    return row(rowIndex)[columnIndex].data() == nullptr;
+  }
+
+  /// @brief method to return the number of bytes of the cells and names
+  ///        stored in the arena
+  /// @return the number of stored bytes
+  [[nodiscard]] auto storedBytes() const noexcept -> std::size_t {
+    return m_storedBytes;
+  }
+
+  /// @brief method to read the columns names of a statement, which has to be
+  ///        called once before appending rows
+  /// @param stmt the statement to read the columns names of
+  void readColumnsNames(sqlite3_stmt *stmt) {
+    readColumnsNames(stmt, sqlite3_column_count(stmt));
+  }
+
+  /// @brief an overload to readColumnsNames method that reads the leading
+  ///        columns of a statement only, so that rows appended later leave its
+  ///        trailing columns out
+  /// @param stmt the statement to read the columns names of
+  /// @param columnsCount the number of leading columns to read
+  void readColumnsNames(sqlite3_stmt *stmt, int columnsCount) {
+    m_columnsNames.reserve(static_cast<std::size_t>(columnsCount));
+
+    for (int i{0}; i < columnsCount; ++i) {
+      char const *name{sqlite3_column_name(stmt, i)};
+      m_columnsNames.push_back(store(name, std::strlen(name)));
+    }
+  }
+
+  /// @brief method to append the current row of a stepped statement
+  /// @param stmt the statement whose current row gets appended
+  /// @note each cell is read as text, keeping all its bytes, including any
+  ///       embedded NUL characters of texts and blobs
+  void appendRow(sqlite3_stmt *stmt) {
+    for (std::size_t i{0U}; i < m_columnsNames.size(); ++i) {
+      auto const *text{reinterpret_cast<char const *>(
+          sqlite3_column_text(stmt, static_cast<int>(i)))};
+      if (text == nullptr) {
+        m_cells.emplace_back();
+        continue;
+      }
+
+      // the size is read after the text, so it counts the bytes of the text
+      m_cells.push_back(store(
+          text, static_cast<std::size_t>(
+                    sqlite3_column_bytes(stmt, static_cast<int>(i)))));
+    }
+  }
+
+private:
+  /// @brief the arena storing the bytes of the cells, allocated on the heap
+  ///        so that views to the cells stay valid once the result is moved
+  std::unique_ptr<std::pmr::monotonic_buffer_resource> m_arena;
+
+  /// @brief views to the names of the columns
+  std::pmr::vector<std::string_view> m_columnsNames;
+
+  /// @brief views to the cells, stored row after row
+  std::pmr::vector<std::string_view> m_cells;
+
+  /// @brief number of bytes stored in the arena
+  std::size_t m_storedBytes{0U};
+
+  /// @brief private method to copy bytes into the arena
+  /// @param data the bytes to copy
+  /// @param size the number of bytes to copy
+  /// @return view to the copied bytes, which is never a null view
+  auto store(char const *data, std::size_t size) -> std::string_view {
+    if (size == 0U) {
+      return std::string_view{""};
+    }
+
+    auto *copy{static_cast<char *>(m_arena->allocate(size, alignof(char)))};
+    std::memcpy(copy, data, size);
+    m_storedBytes += size;
+
+    return std::string_view{copy, size};
+  }
+};
+
+} // namespace sql_with_cpp
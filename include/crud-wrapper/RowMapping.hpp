@@ -0,0 +1,190 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <concepts>
+#include <cstddef>
+#include <optional>
+#include <sqlite3.h>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ColumnReader.hpp"
+
+/// @brief namespace for SQL with c++
+namespace sql_with_cpp {
+
+/// @brief a descriptor mapping a data member of a struct to a column
+/// @tparam Object the struct holding the member
+/// @tparam Member the type of the member, check readColumn
+template <typename Object, typename Member> struct Field {
+  /// @brief the name of the column, compared case-insensitively
+  std::string_view column;
+
+  /// @brief pointer to the member
+  Member Object::*member;
+};
+
+/// @brief primary template of the mapping of a struct to the columns of a
+///        table, which is specialized per struct, e.g.
+///        template <> struct RowMapping<City> {
+///          static constexpr std::string_view kTable{"City"};
+///          static constexpr std::tuple kFields{
+///              Field<City, std::int64_t>{"ID", &City::id},
+///              Field<City, std::string>{"Name", &City::name}};
+///        };
+/// @tparam Row the mapped struct
+/// @note the first field maps the primary key, which updates look rows up by
+template <typename Row> struct RowMapping;
+
+/// @brief a concept satisfied by default initializable structs that have a
+///        RowMapping specialization
+template <typename Row>
+concept MappedRow = std::default_initializable<Row> && requires {
+  {
+    RowMapping<Row>::kTable
+  } -> std::convertible_to<std::string_view>;
+  std::tuple_size<std::remove_cvref_t<decltype(RowMapping<Row>::kFields)>>::
+      value;
+};
+
+/// @brief namespace for the implementation details of row mappings
+namespace detail {
+
+/// @brief function to return the number of fields of a mapped struct
+/// @tparam Row the mapped struct
+/// @return the number of fields
+template <MappedRow Row>
+consteval auto fieldsCountOf() noexcept -> std::size_t {
+  return std::tuple_size_v<
+      std::remove_cvref_t<decltype(RowMapping<Row>::kFields)>>;
+}
+
+/// @brief function to return the names of the mapped columns, in the order
+///        of the fields
+/// @tparam Row the mapped struct
+/// @return the names of the columns, built once per struct
+template <MappedRow Row>
+auto columnsNamesOf() -> std::vector<std::string> const & {
+  static std::vector<std::string> const columnsNames{std::apply(
+      [](auto const &...fields) {
+        return std::vector<std::string>{std::string{fields.column}...};
+      },
+      RowMapping<Row>::kFields)};
+
+  return columnsNames;
+}
+
+/// @brief function to return the UPDATE statement of a mapped struct, which
+///        binds the fields after the first one, and then the key
+/// @tparam Row the mapped struct
+/// @return the UPDATE statement, built once per struct
+template <MappedRow Row> auto updateStatementOf() -> std::string const & {
+  static std::string const statement{[] {
+    auto const &columnsNames{columnsNamesOf<Row>()};
+    std::string built{"UPDATE " + std::string{RowMapping<Row>::kTable} +
+                      " SET "};
+    for (std::size_t i{1U}; i < columnsNames.size(); ++i) {
+      built += (i == 1U ? "" : ", ") + columnsNames[i] + " = ?";
+    }
+    built += " WHERE " + columnsNames.front() + " = ?";
+
+    return built;
+  }()};
+
+  return statement;
+}
+
+/// @brief function to view the fields of an object in the order of its
+///        mapping, as bound by INSERT statements
+/// @tparam Row the mapped struct
+/// @param row the object
+/// @return tuple of references to the fields
+template <MappedRow Row> auto fieldsOf(Row const &row) noexcept {
+  return std::apply(
+      [&row](auto const &...fields) { return std::tie(row.*fields.member...); },
+      RowMapping<Row>::kFields);
+}
+
+/// @brief function to view the fields of an object in the order they are
+///        bound by its UPDATE statement, check updateStatementOf
+/// @tparam Row the mapped struct
+/// @param row the object
+/// @return tuple of references to the fields
+template <MappedRow Row> auto updatedFieldsOf(Row const &row) noexcept {
+  auto const fields{fieldsOf(row)};
+  return [&fields]<std::size_t... Indices>(std::index_sequence<Indices...>) {
+    return std::tie(std::get<Indices + 1U>(fields)..., std::get<0U>(fields));
+  }(std::make_index_sequence<fieldsCountOf<Row>() - 1U>{});
+}
+
+/// @brief function to resolve the columns of a statement that the fields of
+///        a mapped struct are read from, by their names
+/// @tparam Row the mapped struct
+/// @param stmt the prepared statement
+/// @return the index of the column of each field, or std::nullopt if a field
+///         has no column
+template <MappedRow Row>
+auto resolveColumns(sqlite3_stmt *stmt) noexcept
+    -> std::optional<std::array<int, fieldsCountOf<Row>()>> {
+  auto const columnsCount{sqlite3_column_count(stmt)};
+  auto const indexOf{[stmt, columnsCount](std::string_view column) {
+    for (int i{0}; i < columnsCount; ++i) {
+      char const *name{sqlite3_column_name(stmt, i)};
+      if (name != nullptr &&
+          std::ranges::equal(std::string_view{name}, column,
+                             [](unsigned char lhs, unsigned char rhs) {
+                               return std::tolower(lhs) == std::tolower(rhs);
+                             })) {
+        return i;
+      }
+    }
+
+    return -1;
+  }};
+
+  std::array<int, fieldsCountOf<Row>()> columns{};
+  std::size_t i{0U};
+  std::apply(
+      [&](auto const &...fields) {
+        ((columns[i++] = indexOf(fields.column)), ...);
+      },
+      RowMapping<Row>::kFields);
+  if (std::ranges::find(columns, -1) != columns.end()) {
+    return std::nullopt;
+  }
+
+  return columns;
+}
+
+/// @brief function to read the current row of a statement into a mapped
+///        struct, reading each field straight from its column
+/// @tparam Row the mapped struct
+/// @param stmt the statement whose current row is read
+/// @param columns the columns of the fields, check resolveColumns
+/// @return the object read
+template <MappedRow Row>
+auto readMappedRow(
+    sqlite3_stmt *stmt,
+    std::array<int, fieldsCountOf<Row>()> const &columns) noexcept -> Row {
+  Row row{};
+  [&]<std::size_t... Indices>(std::index_sequence<Indices...>) {
+    auto const &fields{RowMapping<Row>::kFields};
+    ((row.*std::get<Indices>(fields).member =
+          readColumn<std::remove_cvref_t<
+              decltype(row.*std::get<Indices>(fields).member)>>(
+              stmt, columns[Indices])),
+     ...);
+  }(std::make_index_sequence<fieldsCountOf<Row>()>{});
+
+  return row;
+}
+
+} // namespace detail
+
+} // namespace sql_with_cpp
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/// @brief namespace for SQL with c++
+namespace sql_with_cpp {
+
+/// @brief metadata of a column of a table, as reported by
+///        PRAGMA table_xinfo
+struct ColumnInfo {
+  /// @brief the name of the column
+  std::string name;
+
+  /// @brief the declared type of the column, which is empty if it has none
+  std::string declaredType;
+
+  /// @brief whether the column has a NOT NULL constraint
+  bool notNull{false};
+
+  /// @brief the SQL text of the default value of the column, if it has one
+  std::optional<std::string> defaultValue;
+
+  /// @brief the one-based position of the column in the primary key, or zero
+  ///        if it is not part of it
+  std::size_t primaryKeyPosition{0U};
+};
+
+/// @brief metadata of an index of a table, as reported by PRAGMA index_list
+///        and PRAGMA index_info
+struct IndexInfo {
+  /// @brief the name of the index
+  std::string name;
+
+  /// @brief whether the index is a UNIQUE index
+  bool unique{false};
+
+  /// @brief how the index was created, which is "c" for CREATE INDEX, "u"
+  ///        for a UNIQUE constraint, and "pk" for a PRIMARY KEY constraint
+  std::string origin;
+
+  /// @brief whether the index is a partial index
+  bool partial{false};
+
+  /// @brief the names of the indexed columns in order, where columns that
+  ///        are expressions have empty names
+  std::vector<std::string> columnsNames;
+};
+
+/// @brief metadata of a table or a view
+struct TableInfo {
+  /// @brief the name of the table, as declared in the schema
+  std::string name;
+
+  /// @brief the type of the table, which is "table", "view", "virtual" or
+  ///        "shadow"
+  std::string type;
+
+  /// @brief whether the table is a WITHOUT ROWID table
+  bool withoutRowid{false};
+
+  /// @brief the columns of the table in their declared order, excluding the
+  ///        hidden columns of virtual tables
+  std::vector<ColumnInfo> columns;
+
+  /// @brief the indexes of the table
+  std::vector<IndexInfo> indexes;
+
+  /// @brief the names of the columns of the table in their declared order,
+  ///        which are the names of the columns read by SELECT *
+  std::vector<std::string> columnsNames;
+
+  /// @brief method to look a column up by its name
+  /// @param columnName the name of the column, compared case-insensitively
+  /// @return pointer to the column, or nullptr if there is no such column
+  [[nodiscard]] auto
+  column(std::string_view columnName) const noexcept -> ColumnInfo const * {
+    auto const it{std::ranges::find_if(
+        columns, [columnName](ColumnInfo const &column) {
+          return std::ranges::equal(column.name, columnName,
+                                    [](unsigned char lhs, unsigned char rhs) {
+                                      return std::tolower(lhs) ==
+                                             std::tolower(rhs);
+                                    });
+        })};
+
+    return it == columns.end() ? nullptr : &*it;
+  }
+
+  /// @brief method to return the names of the primary key columns
+  /// @return the names of the primary key columns in key order, which is empty
+  ///         if the table has no explicit primary key
+  [[nodiscard]] auto primaryKey() const -> std::vector<std::string> {
+    std::vector<ColumnInfo const *> keyColumns;
+    for (auto const &column : columns) {
+      if (column.primaryKeyPosition > 0U) {
+        keyColumns.push_back(&column);
+      }
+    }
+    std::ranges::sort(keyColumns, {}, &ColumnInfo::primaryKeyPosition);
+
+    std::vector<std::string> names;
+    names.reserve(keyColumns.size());
+    for (auto const *column : keyColumns) {
+      names.push_back(column->name);
+    }
+
+    return names;
+  }
+};
+
+/// @brief a cache of the metadata of the tables of a single database
+///        connection, which is loaded once per table, and dropped at once when
+///        the schema version of the database changes
+/// @note the metadata is shared, so it stays valid for its holders even after
+///       the cache drops it
+/// @note this class is not thread safe, just like the connection it serves
+class SchemaCatalog {
+public:
+  /// @brief method to drop all the metadata if the schema changed since it
+  ///        was loaded
+  /// @param schemaVersion the schema version of the main and temp databases
+  ///                      of the connection
+  void synchronize(std::int64_t schemaVersion) noexcept {
+    if (schemaVersion != m_schemaVersion) {
+      m_tables.clear();
+      m_schemaVersion = schemaVersion;
+    }
+  }
+
+  /// @brief method to look the metadata of a table up
+  /// @param tableName the name of the table, compared case-insensitively
+  /// @return the metadata of the table, or nullptr if it was not loaded
+  [[nodiscard]] auto find(std::string_view tableName) const
+      -> std::shared_ptr<const TableInfo> {
+    auto const it{m_tables.find(keyOf(tableName))};
+    return it == m_tables.end() ? nullptr : it->second;
+  }
+
+  /// @brief method to keep the metadata of a table
+  /// @param table the metadata of the table
+  /// @return the kept metadata
+  auto insert(TableInfo table) -> std::shared_ptr<const TableInfo> {
+    auto key{keyOf(table.name)};
+    auto info{std::make_shared<const TableInfo>(std::move(table))};
+    m_tables.insert_or_assign(std::move(key), info);
+
+    return info;
+  }
+
+  /// @brief method to return the number of tables whose metadata is kept
+  /// @return the number of tables
+  [[nodiscard]] auto size() const noexcept -> std::size_t {
+    return m_tables.size();
+  }
+
+private:
+  /// @brief the metadata of the tables, keyed by their lower-case names
+  std::unordered_map<std::string, std::shared_ptr<const TableInfo>> m_tables;
+
+  /// @brief the schema version the metadata was loaded at
+  std::int64_t m_schemaVersion{-1};
+
+  /// @brief private static method to return the key of a table name, since
+  ///        SQLite compares table names case-insensitively
+  /// @param tableName the name of the table
+  /// @return the lower-case name of the table
+  static auto keyOf(std::string_view tableName) -> std::string {
+    std::string key{tableName};
+    std::ranges::transform(key, key.begin(), [](unsigned char c) {
+      return static_cast<char>(std::tolower(c));
+    });
+
+    return key;
+  }
+};
+
+} // namespace sql_with_cpp
@@ -0,0 +1,514 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <fcntl.h>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+/// @brief namespace for SQL with c++
+namespace sql_with_cpp {
+
+/// @brief how far loading an SQL script went
+struct ScriptProgress {
+  /// @brief the number of bytes of the script run so far
+  std::size_t bytesCount{0U};
+
+  /// @brief the size of the script in bytes
+  std::size_t bytesTotal{0U};
+
+  /// @brief the number of statements of the script run so far
+  std::size_t statementsCount{0U};
+};
+
+/// @brief options of loading an SQL script
+struct ScriptOptions {
+  /// @brief number of statements run between two progress reports when none
+  ///        is specified explicitly
+  static constexpr std::size_t kDefaultProgressInterval{1000U};
+
+  /// @brief function called with the progress of the load every
+  ///        progressInterval statements, and once the whole script ran, or
+  ///        empty to report nothing
+  std::function<void(ScriptProgress const &)> onProgress;
+
+  /// @brief the number of statements run between two progress reports, where
+  ///        zero reports the end of the load only
+  std::size_t progressInterval{kDefaultProgressInterval};
+};
+
+/// @brief the outcome of loading an SQL script
+struct ScriptResult {
+  /// @brief whether all the statements of the script ran successfully
+  bool succeeded{false};
+
+  /// @brief the number of statements of the script that ran
+  std::size_t statementsCount{0U};
+
+  /// @brief the number of rows inserted by rebinding a reused INSERT
+  ///        statement instead of preparing the statement of the script
+  std::size_t reboundRowsCount{0U};
+
+  /// @brief the error message of the failed statement, if any
+  std::string errorMessage;
+
+  /// @brief the one-based line of the script where the failed statement
+  ///        starts, or zero if the load did not fail on a statement
+  std::size_t errorLine{0U};
+
+  /// @brief conversion operator to check whether the load succeeded
+  /// @return true if all the statements ran successfully, false otherwise
+  explicit operator bool() const noexcept { return succeeded; }
+};
+
+/// @brief a read-only memory mapping of a whole file, unmapped on destruction
+class MappedFile {
+public:
+  /// @brief parametrized constructor that maps a file
+  /// @param path filesystem path to the file
+  /// @throws std::filesystem::filesystem_error if the file cannot be opened
+  ///         or mapped
+  explicit MappedFile(std::filesystem::path const &path) {
+    int const fd{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+    if (fd < 0) {
+      throw std::filesystem::filesystem_error(
+          "Failed to open file", path,
+          std::error_code{errno, std::generic_category()});
+    }
+
+    struct stat status {};
+    if (::fstat(fd, &status) != 0) {
+      auto const error{errno};
+      ::close(fd);
+      throw std::filesystem::filesystem_error(
+          "Failed to read file size", path,
+          std::error_code{error, std::generic_category()});
+    }
+
+    // mapping zero bytes fails, while an empty file is simply an empty view
+    auto const size{static_cast<std::size_t>(status.st_size)};
+    void *data{size == 0U ? nullptr
+                          : ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd,
+                                   0)};
+    auto const error{errno};
+    ::close(fd);
+    if (data == MAP_FAILED) {
+      throw std::filesystem::filesystem_error(
+          "Failed to map file", path,
+          std::error_code{error, std::generic_category()});
+    }
+
+    if (data != nullptr) {
+      // the file is read once from start to end, so the kernel can read
+      // ahead aggressively and drop pages behind
+      ::madvise(data, size, MADV_SEQUENTIAL);
+      m_data = static_cast<char const *>(data);
+      m_size = size;
+    }
+  }
+
+  /// @brief deleted copy operations, as the mapping has a unique owner
+  MappedFile(MappedFile const &) = delete;
+  auto operator=(MappedFile const &) -> MappedFile & = delete;
+
+  /// @brief move constructor that takes over the mapping of other
+  /// @param other the mapped file to move from
+  MappedFile(MappedFile &&other) noexcept
+      : m_data{std::exchange(other.m_data, nullptr)},
+        m_size{std::exchange(other.m_size, 0U)} {}
+
+  /// @brief deleted move assignment, as no mapping is ever replaced
+  auto operator=(MappedFile &&) -> MappedFile & = delete;
+
+  /// @brief destructor that unmaps the file
+  ~MappedFile() noexcept {
+    if (m_data != nullptr) {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+      ::munmap(const_cast<char *>(m_data), m_size);
+    }
+  }
+
+  /// @brief method to return the contents of the file
+  /// @return view to the mapped bytes of the file
+  [[nodiscard]] auto view() const noexcept -> std::string_view {
+    return m_data == nullptr ? std::string_view{}
+                             : std::string_view{m_data, m_size};
+  }
+
+private:
+  /// @brief the first mapped byte, or nullptr for an empty file
+  char const *m_data{nullptr};
+
+  /// @brief the number of mapped bytes
+  std::size_t m_size{0U};
+};
+
+/// @brief namespace for the implementation details of script loading
+namespace detail {
+
+/// @brief kinds of the literal values of an INSERT statement
+enum class LiteralKind { Integer, Real, Text, EscapedText, Null };
+
+/// @brief a literal value of an INSERT statement
+struct Literal {
+  /// @brief the kind of the literal
+  LiteralKind kind{LiteralKind::Null};
+
+  /// @brief the characters between the quotes of a text literal, where
+  ///        EscapedText literals still hold doubled quotes
+  std::string_view text;
+
+  /// @brief the value of an Integer literal
+  std::int64_t integer{0};
+
+  /// @brief the value of a Real literal
+  double real{0.0};
+};
+
+/// @brief an INSERT statement whose values are all literals, i.e.
+///        INSERT INTO <table> [(<columns>)] VALUES (<literals>)[, ...];
+struct LiteralInsert {
+  /// @brief the table inserted into along with its columns list, if any, as
+  ///        written in the statement (e.g. "City" or "main.City (ID, Name)")
+  std::string_view target;
+
+  /// @brief the number of values of each row
+  std::size_t columnsCount{0U};
+
+  /// @brief the values of all the rows, row after row
+  std::vector<Literal> values;
+
+  /// @brief the number of bytes of the statement, including its semicolon
+  std::size_t length{0U};
+};
+
+/// @brief function to check whether a character can continue a bare
+///        identifier or keyword
+/// @param c the character
+/// @return true if it is a letter, a digit, '_', '$' or a non-ASCII byte
+inline auto isIdentifierChar(char c) noexcept -> bool {
+  auto const byte{static_cast<unsigned char>(c)};
+  return std::isalnum(byte) != 0 || c == '_' || c == '$' || byte >= 0x80U;
+}
+
+/// @brief function to skip the whitespace starting at a position
+/// @param sql the SQL text
+/// @param pos the position, moved past the whitespace
+inline void skipSpaces(std::string_view sql, std::size_t &pos) noexcept {
+  while (pos < sql.size() &&
+         std::isspace(static_cast<unsigned char>(sql[pos])) != 0) {
+    ++pos;
+  }
+}
+
+/// @brief function to skip the whitespace and the comments starting at a
+///        position, i.e. everything between two statements
+/// @param sql the SQL text
+/// @param pos the position to start from
+/// @return the position of the first character that is part of a statement,
+///         or sql.size() if there is none
+inline auto skipBlanks(std::string_view sql,
+                          std::size_t pos) noexcept -> std::size_t {
+  while (true) {
+    skipSpaces(sql, pos);
+    if (sql.substr(pos).starts_with("--")) {
+      pos = std::min(sql.find('\n', pos), sql.size());
+    } else if (sql.substr(pos).starts_with("/*")) {
+      auto const end{sql.find("*/", pos + 2U)};
+      pos = end == std::string_view::npos ? sql.size() : end + 2U;
+    } else {
+      return pos;
+    }
+  }
+}
+
+/// @brief function to consume a keyword starting at a position
+/// @param sql the SQL text
+/// @param pos the position, moved past the keyword and the whitespace after
+///            it if it matched
+/// @param keyword the upper-case keyword
+/// @return true if the keyword matched case-insensitively, false otherwise
+inline auto consumeKeyword(std::string_view sql, std::size_t &pos,
+                              std::string_view keyword) noexcept -> bool {
+  auto const word{sql.substr(pos, keyword.size())};
+  if (!std::ranges::equal(word, keyword, [](char lhs, char rhs) {
+        return std::toupper(static_cast<unsigned char>(lhs)) == rhs;
+      })) {
+    return false;
+  }
+  if (pos + keyword.size() < sql.size() &&
+      isIdentifierChar(sql[pos + keyword.size()])) {
+    return false;
+  }
+
+  pos += keyword.size();
+  skipSpaces(sql, pos);
+  return true;
+}
+
+/// @brief function to consume a bare or quoted identifier starting at a
+///        position
+/// @param sql the SQL text
+/// @param pos the position, moved past the identifier and the whitespace
+///            after it if it matched
+/// @return true if an identifier was consumed, false otherwise
+inline auto consumeIdentifier(std::string_view sql,
+                                 std::size_t &pos) noexcept -> bool {
+  if (pos >= sql.size()) {
+    return false;
+  }
+
+  auto end{pos};
+  if (auto const open{sql[pos]}; open == '"' || open == '`' || open == '[') {
+    auto const close{open == '[' ? ']' : open};
+    do {
+      // a doubled closing quote is an escaped quote inside the identifier
+      end = sql.find(close, end + 1U);
+      if (end == std::string_view::npos) {
+        return false;
+      }
+      ++end;
+    } while (close != ']' && end < sql.size() && sql[end] == close);
+  } else if (std::isdigit(static_cast<unsigned char>(open)) == 0) {
+    while (end < sql.size() && isIdentifierChar(sql[end])) {
+      ++end;
+    }
+  }
+  if (end == pos) {
+    return false;
+  }
+
+  pos = end;
+  skipSpaces(sql, pos);
+  return true;
+}
+
+/// @brief function to consume a literal value starting at a position
+/// @param sql the SQL text
+/// @param pos the position, moved past the literal and the whitespace after
+///            it if it was parsed
+/// @param literal the parsed literal
+/// @return true if a literal that can be bound as is was parsed, false
+///         otherwise (e.g. for expressions, blobs, or integers that SQLite
+///         would read as reals because they overflow)
+inline auto consumeLiteral(std::string_view sql, std::size_t &pos,
+                           Literal &literal) noexcept -> bool {
+  if (pos >= sql.size()) {
+    return false;
+  }
+
+  if (sql[pos] == '\'') {
+    literal.kind = LiteralKind::Text;
+    auto end{pos};
+    while (true) {
+      end = sql.find('\'', end + 1U);
+      if (end == std::string_view::npos) {
+        return false;
+      }
+      if (end + 1U < sql.size() && sql[end + 1U] == '\'') {
+        literal.kind = LiteralKind::EscapedText;
+        ++end;
+        continue;
+      }
+      break;
+    }
+
+    literal.text = sql.substr(pos + 1U, end - pos - 1U);
+    pos = end + 1U;
+    skipSpaces(sql, pos);
+    return true;
+  }
+
+  if (consumeKeyword(sql, pos, "NULL")) {
+    literal.kind = LiteralKind::Null;
+    return true;
+  }
+
+  bool const negative{sql[pos] == '-'};
+  auto const start{sql[pos] == '-' || sql[pos] == '+' ? pos + 1U : pos};
+  auto end{start};
+  bool isReal{false};
+  while (end < sql.size()) {
+    auto const c{sql[end]};
+    if (std::isdigit(static_cast<unsigned char>(c)) != 0) {
+      ++end;
+    } else if (c == '.' || c == 'e' || c == 'E') {
+      isReal = true;
+      ++end;
+    } else if ((c == '-' || c == '+') &&
+               (sql[end - 1U] == 'e' || sql[end - 1U] == 'E')) {
+      ++end;
+    } else {
+      break;
+    }
+  }
+  if (end == start) {
+    return false;
+  }
+
+  auto const *first{sql.data() + start};
+  auto const *last{sql.data() + end};
+  if (isReal) {
+    literal.kind = LiteralKind::Real;
+    auto const [ptr, errc]{std::from_chars(first, last, literal.real)};
+    if (errc != std::errc{} || ptr != last) {
+      return false;
+    }
+    literal.real = negative ? -literal.real : literal.real;
+  } else {
+    literal.kind = LiteralKind::Integer;
+    auto const [ptr, errc]{std::from_chars(first, last, literal.integer)};
+    if (errc != std::errc{} || ptr != last) {
+      return false;
+    }
+    literal.integer = negative ? -literal.integer : literal.integer;
+  }
+
+  pos = end;
+  skipSpaces(sql, pos);
+  return true;
+}
+
+/// @brief function to parse an INSERT statement whose values are all
+///        literals, which can be run by binding its values to a reused
+///        statement with placeholders instead of being prepared on its own
+/// @param sql the SQL text, starting at the statement
+/// @param insert the parsed statement, whose values buffer is reused
+/// @return true if the statement has that shape, false otherwise, in which
+///         case it has to be prepared as is
+inline auto parseLiteralInsert(std::string_view sql,
+                               LiteralInsert &insert) noexcept -> bool {
+  insert.values.clear();
+
+  std::size_t pos{0U};
+  if (!consumeKeyword(sql, pos, "INSERT") ||
+      !consumeKeyword(sql, pos, "INTO")) {
+    return false;
+  }
+
+  auto const targetStart{pos};
+  if (!consumeIdentifier(sql, pos)) {
+    return false;
+  }
+  if (pos < sql.size() && sql[pos] == '.') {
+    ++pos;
+    skipSpaces(sql, pos);
+    if (!consumeIdentifier(sql, pos)) {
+      return false;
+    }
+  }
+
+  std::size_t listedColumnsCount{0U};
+  if (pos < sql.size() && sql[pos] == '(') {
+    do {
+      ++pos;
+      skipSpaces(sql, pos);
+      if (!consumeIdentifier(sql, pos)) {
+        return false;
+      }
+      ++listedColumnsCount;
+    } while (pos < sql.size() && sql[pos] == ',');
+
+    if (pos >= sql.size() || sql[pos] != ')') {
+      return false;
+    }
+    ++pos;
+  }
+
+  auto targetEnd{pos};
+  while (targetEnd > targetStart &&
+         std::isspace(static_cast<unsigned char>(sql[targetEnd - 1U])) != 0) {
+    --targetEnd;
+  }
+  insert.target = sql.substr(targetStart, targetEnd - targetStart);
+  skipSpaces(sql, pos);
+
+  if (!consumeKeyword(sql, pos, "VALUES")) {
+    return false;
+  }
+
+  while (true) {
+    if (pos >= sql.size() || sql[pos] != '(') {
+      return false;
+    }
+
+    auto const rowStart{insert.values.size()};
+    do {
+      ++pos;
+      skipSpaces(sql, pos);
+      if (!consumeLiteral(sql, pos, insert.values.emplace_back())) {
+        return false;
+      }
+    } while (pos < sql.size() && sql[pos] == ',');
+
+    if (pos >= sql.size() || sql[pos] != ')') {
+      return false;
+    }
+    ++pos;
+    skipSpaces(sql, pos);
+
+    auto const rowSize{insert.values.size() - rowStart};
+    if (rowStart == 0U) {
+      insert.columnsCount = rowSize;
+    } else if (rowSize != insert.columnsCount) {
+      return false;
+    }
+
+    if (pos >= sql.size() || sql[pos] != ',') {
+      break;
+    }
+    ++pos;
+    skipSpaces(sql, pos);
+  }
+
+  if (listedColumnsCount != 0U && listedColumnsCount != insert.columnsCount) {
+    return false;
+  }
+
+  // anything else than the end of the statement (e.g. an upsert clause)
+  // makes it a statement to prepare as is
+  if (pos < sql.size()) {
+    if (sql[pos] != ';') {
+      return false;
+    }
+    ++pos;
+  }
+
+  insert.length = pos;
+  return true;
+}
+
+/// @brief function to check whether a statement begins or ends a transaction
+/// @param sql the SQL text, starting at the statement
+/// @return true for BEGIN, COMMIT and END statements, false otherwise
+inline auto isTransactionControl(std::string_view sql) noexcept -> bool {
+  std::size_t pos{0U};
+  return consumeKeyword(sql, pos, "BEGIN") ||
+         consumeKeyword(sql, pos, "COMMIT") || consumeKeyword(sql, pos, "END");
+}
+
+/// @brief function to return the line of a position in a text
+/// @param text the text
+/// @param pos the position
+/// @return the one-based line number of the position
+inline auto lineOf(std::string_view text,
+                      std::size_t pos) noexcept -> std::size_t {
+  return 1U + static_cast<std::size_t>(
+                  std::ranges::count(text.substr(0U, pos), '\n'));
+}
+
+} // namespace detail
+
+} // namespace sql_with_cpp
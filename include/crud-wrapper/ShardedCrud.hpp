@@ -0,0 +1,422 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "CrudWrapper.hpp"
+#include "ThreadPool.hpp"
+
+/// @brief namespace for SQL with c++
+namespace sql_with_cpp {
+
+/// @brief a shard key, which is either an integer or a text
+/// @note integers sort before texts, just like in SQLite
+using ShardKey_type = std::variant<std::int64_t, std::string>;
+
+/// @brief a function from shard keys to shards, spreading keys either by
+///        hash or by ranges
+/// @note hashes are computed with fixed functions (i.e. not std::hash), so
+///       keys are routed to the same shards across runs, platforms and
+///       standard libraries, as required by data persisted in shards
+class ShardRouter {
+public:
+  /// @brief deleted default constructor for allowing only construction
+  ///        through the named constructors
+  ShardRouter() = delete;
+
+  /// @brief named constructor for a router spreading keys evenly by hash
+  /// @param shardsCount the number of shards
+  /// @return the router
+  /// @note throws std::invalid_argument for a zero shards count
+  static auto byHash(std::size_t shardsCount) -> ShardRouter {
+    if (shardsCount == 0U) {
+      throw std::invalid_argument("Router requires at least one shard");
+    }
+
+    return ShardRouter{shardsCount, {}};
+  }
+
+  /// @brief named constructor for a router assigning ranges of keys to
+  ///        shards, where shard i holds the keys less than upperBounds[i],
+  ///        and the last shard holds the keys from the last bound onwards
+  /// @param upperBounds the bounds between successive shards, in strictly
+  ///                    ascending order
+  /// @return the router, routing to upperBounds.size() + 1 shards
+  /// @note throws std::invalid_argument if the bounds are not in strictly
+  ///       ascending order
+  static auto byRange(std::vector<ShardKey_type> upperBounds) -> ShardRouter {
+    if (std::ranges::adjacent_find(upperBounds, std::greater_equal{}) !=
+        upperBounds.end()) {
+      throw std::invalid_argument(
+          "Router bounds must be in strictly ascending order");
+    }
+
+    auto const shardsCount{upperBounds.size() + 1U};
+    return ShardRouter{shardsCount, std::move(upperBounds)};
+  }
+
+  /// @brief method to return the number of shards routed to
+  /// @return the number of shards
+  [[nodiscard]] auto shardsCount() const noexcept -> std::size_t {
+    return m_shardsCount;
+  }
+
+  /// @brief method to return the shard of a key
+  /// @param key the shard key
+  /// @return the index of the shard holding the key
+  [[nodiscard]] auto
+  shardOf(ShardKey_type const &key) const noexcept -> std::size_t {
+    if (!m_upperBounds.empty()) {
+      return static_cast<std::size_t>(
+          std::ranges::upper_bound(m_upperBounds, key) -
+          m_upperBounds.begin());
+    }
+
+    return hashOf(key) % m_shardsCount;
+  }
+
+private:
+  /// @brief the number of shards
+  std::size_t m_shardsCount{1U};
+
+  /// @brief the bounds between successive shards, or empty to route by hash
+  std::vector<ShardKey_type> m_upperBounds;
+
+  /// @brief private parametrized constructor used by the named constructors
+  /// @param shardsCount the number of shards
+  /// @param upperBounds the bounds between successive shards
+  ShardRouter(std::size_t shardsCount,
+              std::vector<ShardKey_type> upperBounds) noexcept
+      : m_shardsCount{shardsCount}, m_upperBounds{std::move(upperBounds)} {}
+
+  /// @brief private static method to hash a shard key
+  /// @param key the shard key
+  /// @return the splitmix64 finalizer of integers, or the 64-bit FNV-1a hash
+  ///         of texts
+  static auto hashOf(ShardKey_type const &key) noexcept -> std::uint64_t {
+    if (auto const *integer{std::get_if<std::int64_t>(&key)}) {
+      auto hash{static_cast<std::uint64_t>(*integer)};
+      hash = (hash ^ (hash >> 30U)) * 0xBF58476D1CE4E5B9U;
+      hash = (hash ^ (hash >> 27U)) * 0x94D049BB133111EBU;
+      return hash ^ (hash >> 31U);
+    }
+
+    std::uint64_t hash{0xCBF29CE484222325U};
+    for (auto const c : std::get<std::string>(key)) {
+      hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001B3U;
+    }
+    return hash;
+  }
+};
+
+/// @brief class for CRUD operations over a dataset split across several
+///        database files (i.e. shards), where rows are routed to shards by a
+///        shard key, and reads fan out to all the shards in parallel
+/// @note each shard is a database of its own, with its own lock, so writes to
+///       different shards do not contend with each other, while statements
+///       run on all the shards are not atomic across them
+/// @note this class is not thread safe, just like CrudWrapper, while the
+///       statements run on all the shards run on a thread per shard
+class ShardedCrud : public ICruddable {
+public:
+  /// @brief deleted default constructor for allowing only construction when
+  ///        passing the paths to the shards
+  ShardedCrud() = delete;
+
+  /// @brief parametrized constructor that opens all the shards
+  /// @param paths filesystem paths to the databases of the shards, in shard
+  ///              order
+  /// @param router the router of shard keys to shards
+  /// @param options options applied to all the shards
+  /// @note throws the same exceptions of the CrudWrapper constructor, or
+  ///       std::invalid_argument if the number of paths does not match the
+  ///       number of shards of the router
+  ShardedCrud(std::vector<std::filesystem::path> const &paths,
+              ShardRouter router, CrudWrapperOptions const &options = {})
+      : m_router{std::move(router)} {
+    if (paths.size() != m_router.shardsCount()) {
+      throw std::invalid_argument(
+          "Number of shards paths does not match the router");
+    }
+
+    m_shards.reserve(paths.size());
+    for (auto const &path : paths) {
+      m_shards.push_back(std::make_unique<CrudWrapper>(path, options));
+    }
+    m_executor = std::make_unique<ThreadPool>(paths.size());
+  }
+
+  /// @brief method to return the number of shards
+  /// @return the number of shards
+  [[nodiscard]] auto shardsCount() const noexcept -> std::size_t {
+    return m_shards.size();
+  }
+
+  /// @brief method to return the router of shard keys to shards
+  /// @return reference to the router
+  [[nodiscard]] auto router() const noexcept -> ShardRouter const & {
+    return m_router;
+  }
+
+  /// @brief method to return a shard, e.g. to run statements on it directly
+  /// @param index the index of the shard
+  /// @return reference to the shard
+  [[nodiscard]] auto shard(std::size_t index) noexcept -> CrudWrapper & {
+    return *m_shards[index];
+  }
+
+  /// @brief const overload of shard method
+  /// @param index the index of the shard
+  /// @return const reference to the shard
+  [[nodiscard]] auto
+  shard(std::size_t index) const noexcept -> CrudWrapper const & {
+    return *m_shards[index];
+  }
+
+  /// @brief method to return the shard holding a shard key
+  /// @param key the shard key
+  /// @return reference to the shard
+  [[nodiscard]] auto shardFor(ShardKey_type const &key) noexcept
+      -> CrudWrapper & {
+    return shard(m_router.shardOf(key));
+  }
+
+  /// @brief implementation for the interface method, reading the columns
+  ///        names from the first shard, as all the shards share the same
+  ///        schema
+  /// @note for further info, check the interface documentation
+  auto peekColumnsNames(std::string const &tableName) const
+      -> std::vector<std::string> override {
+    return m_shards.front()->peekColumnsNames(tableName);
+  }
+
+  /// @brief implementation for the interface method, running the statements
+  ///        on all the shards in parallel (e.g. to create the same schema on
+  ///        all of them)
+  /// @note for further info, check the interface documentation
+  /// @note the statements are not atomic across the shards, so they could
+  ///       have run on some of the shards only when false is returned
+  auto
+  executeStatements(std::string const &statements) noexcept -> bool override {
+    std::vector<char> succeeded(m_shards.size(), 0);
+    try {
+      forEachShard([this, &statements, &succeeded](std::size_t index) {
+        succeeded[index] = m_shards[index]->executeStatements(statements);
+      });
+    } catch (...) {
+      return false;
+    }
+
+    return std::ranges::all_of(succeeded, [](char flag) { return flag != 0; });
+  }
+
+  /// @brief method to run statements on the shard holding a shard key (e.g.
+  ///        to update the rows of that key)
+  /// @param key the shard key
+  /// @param statements the SQL statements to be executed
+  /// @return true if statements were executed successfully, false otherwise
+  auto executeStatements(ShardKey_type const &key,
+                         std::string const &statements) noexcept -> bool {
+    return shardFor(key).executeStatements(statements);
+  }
+
+  /// @brief implementation for the interface method, reading the rows of all
+  ///        the shards in parallel, in shard order
+  /// @note for further info, check the interface documentation
+  auto getRows(std::string const &tableName) const
+      -> std::vector<std::vector<std::string>> override {
+    std::vector<std::vector<std::vector<std::string>>> shardsRows(
+        m_shards.size());
+    forEachShard([this, &tableName, &shardsRows](std::size_t index) {
+      shardsRows[index] = m_shards[index]->getRows(tableName);
+    });
+
+    // the columns names row is kept from the first shard only
+    auto rows{std::move(shardsRows.front())};
+    for (auto &shardRows : shardsRows | std::views::drop(1)) {
+      if (!shardRows.empty()) {
+        rows.insert(rows.end(), std::make_move_iterator(shardRows.begin() + 1),
+                    std::make_move_iterator(shardRows.end()));
+      }
+    }
+
+    return rows;
+  }
+
+  /// @brief method to run a SELECT statement on all the shards in parallel,
+  ///        reading the rows as typed rows in shard order
+  /// @tparam Row the type of the rows, check CrudWrapper::getRowsAs
+  /// @param statement the SELECT statement to run on each shard
+  /// @return the rows of all the shards
+  template <typename Row>
+  auto getRowsAs(std::string const &statement) const -> std::vector<Row> {
+    auto shardsRows{readShards<Row>(statement)};
+
+    std::vector<Row> rows;
+    rows.reserve(std::accumulate(
+        shardsRows.begin(), shardsRows.end(), std::size_t{0U},
+        [](std::size_t sum, auto const &shardRows) {
+          return sum + shardRows.size();
+        }));
+    for (auto &shardRows : shardsRows) {
+      std::ranges::move(shardRows, std::back_inserter(rows));
+    }
+
+    return rows;
+  }
+
+  /// @brief method to run a SELECT statement on all the shards in parallel,
+  ///        merging their ordered rows into the first rows of the whole
+  ///        dataset in the same order
+  /// @tparam Row the type of the rows, check CrudWrapper::getRowsAs
+  /// @param statement the SELECT statement to run on each shard, whose rows
+  ///                  have to be ordered as by comp and proj, where a LIMIT
+  ///                  of limit rows makes each shard read no more rows than
+  ///                  needed
+  /// @param limit the maximum number of rows to return
+  /// @param comp the comparison the rows are ordered by
+  /// @param proj the projection applied to the rows before comparing them
+  /// @return the first limit rows of all the shards, where rows comparing
+  ///         equal are kept in shard order
+  template <typename Row, typename Compare = std::ranges::less,
+            typename Projection = std::identity>
+  auto getMergedRowsAs(std::string const &statement,
+                       std::size_t limit = std::numeric_limits<
+                           std::size_t>::max(),
+                       Compare comp = {}, Projection proj = {}) const
+      -> std::vector<Row> {
+    auto shardsRows{readShards<Row>(statement)};
+
+    // shards are few, so a linear search for the least head row is cheaper
+    // than maintaining a heap
+    std::vector<Row> rows;
+    std::vector<std::size_t> heads(shardsRows.size(), 0U);
+    while (rows.size() < limit) {
+      std::optional<std::size_t> least;
+      for (std::size_t i{0U}; i < shardsRows.size(); ++i) {
+        if (heads[i] < shardsRows[i].size() &&
+            (!least.has_value() ||
+             std::invoke(comp, std::invoke(proj, shardsRows[i][heads[i]]),
+                         std::invoke(proj,
+                                     shardsRows[*least][heads[*least]])))) {
+          least = i;
+        }
+      }
+      if (!least.has_value()) {
+        break;
+      }
+
+      rows.push_back(std::move(shardsRows[*least][heads[*least]++]));
+    }
+
+    return rows;
+  }
+
+  /// @brief method to insert many rows into a table of the shards, routing
+  ///        each row to the shard of its key, and inserting the rows of all
+  ///        the shards in parallel, check CrudWrapper::bulkInsert
+  /// @param tableName the name of the table to insert the rows into
+  /// @param columnsNames the names of the columns to fill, check
+  ///                     CrudWrapper::bulkInsert
+  /// @param rows a range of tuple-like rows
+  /// @param keyOf function returning the shard key of a row
+  /// @param batchSize the number of rows committed per transaction
+  /// @return true if all the rows were inserted, false otherwise
+  /// @note each shard commits its own batches, so on failure the rows of
+  ///       other shards are kept
+  /// @note rows are partitioned by address, so the range has to yield
+  ///       references to rows that outlive the call (e.g. a vector of rows)
+  template <std::ranges::forward_range Rows, typename KeyOf>
+    requires TupleLike<std::ranges::range_value_t<Rows>> &&
+             std::is_lvalue_reference_v<std::ranges::range_reference_t<Rows>> &&
+             std::convertible_to<
+                 std::invoke_result_t<
+                     KeyOf &, std::ranges::range_reference_t<Rows>>,
+                 ShardKey_type>
+  auto bulkInsert(std::string const &tableName,
+                  std::vector<std::string> const &columnsNames, Rows &&rows,
+                  KeyOf keyOf,
+                  std::size_t batchSize =
+                      CrudWrapper::kDefaultBulkInsertBatchSize) -> bool {
+    using Row_type = std::ranges::range_value_t<Rows>;
+
+    // rows are partitioned by reference, so they are not copied
+    std::vector<std::vector<Row_type const *>> shardsRows(m_shards.size());
+    for (auto const &row : rows) {
+      shardsRows[m_router.shardOf(std::invoke(keyOf, row))].push_back(&row);
+    }
+
+    std::vector<char> succeeded(m_shards.size(), 0);
+    forEachShard([&](std::size_t index) {
+      succeeded[index] = m_shards[index]->bulkInsert(
+          tableName, columnsNames,
+          shardsRows[index] |
+              std::views::transform(
+                  [](Row_type const *row) -> Row_type const & {
+                    return *row;
+                  }),
+          batchSize);
+    });
+
+    return std::ranges::all_of(succeeded, [](char flag) { return flag != 0; });
+  }
+
+private:
+  /// @brief the router of shard keys to shards
+  ShardRouter m_router;
+
+  /// @brief the shards, allocated on the heap as CrudWrapper objects are
+  ///        referred to by their prepared statements
+  std::vector<std::unique_ptr<CrudWrapper>> m_shards;
+
+  /// @brief the threads running statements on all the shards, with a thread
+  ///        per shard, allocated on the heap so that const methods can post
+  ///        to it
+  std::unique_ptr<ThreadPool> m_executor;
+
+  /// @brief private method to call a function for each shard in parallel,
+  ///        waiting for all the calls to return
+  /// @param function the function, called with the index of a shard
+  /// @note the first exception thrown by a call is rethrown once all the
+  ///       calls returned
+  template <typename Function>
+  void forEachShard(Function const &function) const {
+    m_executor->forEachIndex(m_shards.size(), function);
+  }
+
+  /// @brief private method to run a SELECT statement on all the shards in
+  ///        parallel
+  /// @tparam Row the type of the rows
+  /// @param statement the SELECT statement to run on each shard
+  /// @return the rows of each shard, in shard order
+  template <typename Row>
+  auto readShards(std::string const &statement) const
+      -> std::vector<std::vector<Row>> {
+    std::vector<std::vector<Row>> shardsRows(m_shards.size());
+    forEachShard([this, &statement, &shardsRows](std::size_t index) {
+      auto const &shard{*m_shards[index]};
+      shardsRows[index] =
+          shard.getRowsAs<Row>(shard.prepareStatement(statement));
+    });
+
+    return shardsRows;
+  }
+};
+
+} // namespace sql_with_cpp
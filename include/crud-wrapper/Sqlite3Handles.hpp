@@ -0,0 +1,25 @@
+#pragma once
+
+#include <memory>
+#include <sqlite3.h>
+
+/// @brief namespace for SQL with c++
+namespace sql_with_cpp {
+
+/// @brief a custom deleter for sqlite3
+struct Sqlite3Closer {
+  void operator()(sqlite3 *p) const { sqlite3_close(p); }
+};
+
+/// @brief a custom deleter for sqlite3_stmt
+struct Sqlite3StmtCloser {
+  void operator()(sqlite3_stmt *p) const { sqlite3_finalize(p); }
+};
+
+/// @brief a type alias for sqlite3 database unique pointer type used
+using Db_Ptr_type = std::unique_ptr<sqlite3, Sqlite3Closer>;
+
+/// @brief a type alias for sqlite3 statement unique pointer type used
+using Stmt_Ptr_type = std::unique_ptr<sqlite3_stmt, Sqlite3StmtCloser>;
+
+} // namespace sql_with_cpp
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+#include "Sqlite3Handles.hpp"
+
+/// @brief namespace for SQL with c++
+namespace sql_with_cpp {
+
+/// @brief a bounded LRU cache of idle prepared statements that belong to a
+///        single database connection, keyed by their SQL text
+/// @note statements are checked out of the cache while being used, and are
+///       handed back once their user is done with them, so the same SQL text
+///       can be in use by more than one owner at the same time
+/// @note this class is not thread safe, just like the connection it serves
+class StatementCache {
+public:
+  /// @brief counters that describe how effective the cache is
+  struct Stats {
+    /// @brief number of lookups that found an idle statement
+    std::size_t hits{0U};
+
+    /// @brief number of lookups that required preparing a new statement
+    std::size_t misses{0U};
+
+    /// @brief number of idle statements finalized to respect the capacity
+    std::size_t evictions{0U};
+
+    /// @brief number of idle statements currently held
+    std::size_t size{0U};
+
+    /// @brief maximum number of idle statements held
+    std::size_t capacity{0U};
+  };
+
+  /// @brief capacity used when none is specified explicitly
+  static constexpr std::size_t kDefaultCapacity{64U};
+
+  /// @brief parametrized constructor for the statement cache
+  /// @param capacity maximum number of idle statements to keep, where zero
+  ///                 disables caching altogether
+  explicit StatementCache(std::size_t capacity = kDefaultCapacity) noexcept
+      : m_capacity{capacity} {}
+
+  /// @brief deleted copy and move operations, as statements checked out of
+  ///        the cache keep referring to it until they are handed back
+  StatementCache(StatementCache const &) = delete;
+  StatementCache(StatementCache &&) = delete;
+  auto operator=(StatementCache const &) -> StatementCache & = delete;
+  auto operator=(StatementCache &&) -> StatementCache & = delete;
+  ~StatementCache() noexcept = default;
+
+  /// @brief method to check out an idle statement prepared for the given SQL
+  /// @param statement the SQL text of the statement to look up
+  /// @return unique pointer to the cached statement, or nullptr if none was
+  ///         idle, in which case the caller is expected to prepare it
+  auto take(std::string_view statement) noexcept -> Stmt_Ptr_type {
+    const auto it{m_index.find(statement)};
+    if (it == m_index.end()) {
+      ++m_stats.misses;
+      return static_cast<Stmt_Ptr_type>(nullptr);
+    }
+
+    ++m_stats.hits;
+    Stmt_Ptr_type stmt{std::move(it->second->stmt)};
+    m_lru.erase(it->second);
+    m_index.erase(it);
+
+    return stmt;
+  }
+
+  /// @brief method to hand a statement back to the cache once its user is
+  ///        done with it, the statement gets reset and its bindings cleared
+  /// @param stmt the statement to hand back
+  /// @param generation the generation returned by generation() at the time
+  ///                   the statement was checked out
+  /// @param lookupKey the SQL text the statement was looked up by, if it
+  ///                  differs from the text it was prepared from (e.g. it has
+  ///                  trailing whitespace, which SQLite drops), so that take
+  ///                  finds it by the same text again
+  /// @note the statement is finalized instead if the cache was cleared
+  ///       meanwhile, or if an idle statement for the same SQL already exists
+  void give(Stmt_Ptr_type stmt, std::uint64_t generation,
+            std::string_view lookupKey = {}) noexcept {
+    if (stmt == nullptr || m_capacity == 0U || generation != m_generation) {
+      return;
+    }
+
+    std::string_view const statement{
+        lookupKey.empty() ? sqlite3_sql(stmt.get()) : lookupKey};
+    if (m_index.contains(statement)) {
+      return;
+    }
+
+    sqlite3_reset(stmt.get());
+    sqlite3_clear_bindings(stmt.get());
+
+    m_lru.push_front(Entry{std::string{statement}, std::move(stmt)});
+    m_index.emplace(m_lru.front().sql, m_lru.begin());
+
+    evictExcessEntries();
+  }
+
+  /// @brief method to finalize all the idle statements, and to make sure that
+  ///        statements currently checked out are not cached once handed back
+  /// @note this is necessary once the database schema changes
+  void clear() noexcept {
+    m_index.clear();
+    m_lru.clear();
+    ++m_generation;
+  }
+
+  /// @brief method to change the maximum number of idle statements kept
+  /// @param capacity the new capacity, where zero disables caching
+  void setCapacity(std::size_t capacity) noexcept {
+    m_capacity = capacity;
+    evictExcessEntries();
+  }
+
+  /// @brief method to return the current generation of the cache, which
+  ///        changes each time the cache gets cleared
+  /// @return the current generation of the cache
+  [[nodiscard]] auto generation() const noexcept -> std::uint64_t {
+    return m_generation;
+  }
+
+  /// @brief method to return a snapshot of the cache counters
+  /// @return the cache counters
+  [[nodiscard]] auto stats() const noexcept -> Stats {
+    Stats stats{m_stats};
+    stats.size = m_lru.size();
+    stats.capacity = m_capacity;
+
+    return stats;
+  }
+
+private:
+  /// @brief an idle statement along with the SQL text it was prepared from
+  struct Entry {
+    std::string sql;
+    Stmt_Ptr_type stmt;
+  };
+
+  /// @brief idle statements ordered from the most to the least recently used
+  std::list<Entry> m_lru;
+
+  /// @brief index into the idle statements, keys refer to Entry::sql which
+  ///        stays valid as long as its list node exists
+  std::unordered_map<std::string_view, std::list<Entry>::iterator> m_index;
+
+  /// @brief maximum number of idle statements kept
+  std::size_t m_capacity{kDefaultCapacity};
+
+  /// @brief generation of the cache, incremented on each clear
+  std::uint64_t m_generation{0U};
+
+  /// @brief cache counters, where size and capacity are filled on demand
+  Stats m_stats;
+
+  /// @brief private method to finalize the least recently used statements
+  ///        until the capacity is respected
+  void evictExcessEntries() noexcept {
+    while (m_lru.size() > m_capacity) {
+      m_index.erase(m_lru.back().sql);
+      m_lru.pop_back();
+      ++m_stats.evictions;
+    }
+  }
+};
+
+} // namespace sql_with_cpp
@@ -0,0 +1,413 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cctype>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <sqlite3.h>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/// @brief namespace for SQL with c++
+namespace sql_with_cpp {
+
+/// @brief counters reported by sqlite3_stmt_status for a statement
+struct StatementCounters {
+  /// @brief number of forward steps taken in full table scans
+  std::int64_t fullScanSteps{0};
+
+  /// @brief number of sort operations
+  std::int64_t sorts{0};
+
+  /// @brief number of rows inserted into automatic indexes
+  std::int64_t autoIndexRows{0};
+
+  /// @brief number of virtual machine steps
+  std::int64_t vmSteps{0};
+
+  /// @brief operator to accumulate the counters of another execution
+  /// @param other the counters to add
+  /// @return reference to this object
+  auto operator+=(StatementCounters const &other) noexcept
+      -> StatementCounters & {
+    fullScanSteps += other.fullScanSteps;
+    sorts += other.sorts;
+    autoIndexRows += other.autoIndexRows;
+    vmSteps += other.vmSteps;
+
+    return *this;
+  }
+
+  /// @brief defaulted equality operator
+  auto operator==(StatementCounters const &) const -> bool = default;
+};
+
+/// @brief function to read the counters of a statement since they were last
+///        read, and to reset them for its next execution
+/// @param stmt the statement to read the counters of
+/// @return the counters of the statement, or zeros for a null statement
+inline auto takeStatementCounters(sqlite3_stmt *stmt) noexcept
+    -> StatementCounters {
+  if (stmt == nullptr) {
+    return {};
+  }
+
+  constexpr int resetCounter{1};
+  return {.fullScanSteps = sqlite3_stmt_status(
+              stmt, SQLITE_STMTSTATUS_FULLSCAN_STEP, resetCounter),
+          .sorts = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_SORT,
+                                       resetCounter),
+          .autoIndexRows = sqlite3_stmt_status(
+              stmt, SQLITE_STMTSTATUS_AUTOINDEX, resetCounter),
+          .vmSteps = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_VM_STEP,
+                                         resetCounter)};
+}
+
+/// @brief function to normalize SQL text so that statements differing only in
+///        their literals or whitespaces are profiled together
+/// @param sql the SQL text to normalize
+/// @return the SQL text with string and numeric literals replaced by '?', and
+///         runs of whitespaces collapsed into a single space
+/// @note e.g. "SELECT *  FROM City WHERE ID = 5" and
+///       "SELECT * FROM City WHERE ID = 7" are both normalized to
+///       "SELECT * FROM City WHERE ID = ?"
+inline auto normalizeSql(std::string_view sql) -> std::string {
+  auto const isIdentifierChar{[](char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) != 0 || c == '_' ||
+           c == '$';
+  }};
+
+  std::string normalized;
+  normalized.reserve(sql.size());
+
+  for (std::size_t i{0U}; i < sql.size();) {
+    auto const c{sql[i]};
+
+    if (std::isspace(static_cast<unsigned char>(c)) != 0) {
+      while (i < sql.size() &&
+             std::isspace(static_cast<unsigned char>(sql[i])) != 0) {
+        ++i;
+      }
+      if (!normalized.empty() && i < sql.size()) {
+        normalized += ' ';
+      }
+    } else if (c == '\'') {
+      // string literal, where quotes are escaped by doubling them
+      for (++i; i < sql.size(); ++i) {
+        if (sql[i] == '\'') {
+          if (i + 1U < sql.size() && sql[i + 1U] == '\'') {
+            ++i;
+          } else {
+            break;
+          }
+        }
+      }
+      ++i;
+      normalized += '?';
+    } else if (std::isdigit(static_cast<unsigned char>(c)) != 0 &&
+               (normalized.empty() || (!isIdentifierChar(normalized.back()) &&
+                                       normalized.back() != '?'))) {
+      // numeric literal, including decimals, exponents and hexadecimals, but
+      // not digits of identifiers or numbered parameters (e.g. ?1)
+      while (i < sql.size() &&
+             (isIdentifierChar(sql[i]) || sql[i] == '.' ||
+              ((sql[i] == '+' || sql[i] == '-') &&
+               (sql[i - 1U] == 'e' || sql[i - 1U] == 'E')))) {
+        ++i;
+      }
+      normalized += '?';
+    } else {
+      normalized += c;
+      ++i;
+    }
+  }
+
+  return normalized;
+}
+
+/// @brief a histogram of latencies with logarithmic buckets, where each power
+///        of two is split into 4 linear sub-buckets, so percentiles are
+///        estimated within 25% of their exact values using constant memory
+class LatencyHistogram {
+public:
+  /// @brief method to record a latency
+  /// @param latency the latency to record
+  void record(std::chrono::nanoseconds latency) noexcept {
+    ++m_buckets[bucketOf(
+        static_cast<std::uint64_t>(std::max(latency.count(), std::int64_t{0})))];
+    ++m_count;
+  }
+
+  /// @brief method to estimate a percentile of the recorded latencies
+  /// @param fraction the percentile as a fraction in [0, 1] (e.g. 0.99)
+  /// @return the upper bound of the bucket the percentile falls in, or zero if
+  ///         nothing was recorded
+  [[nodiscard]] auto
+  percentile(double fraction) const noexcept -> std::chrono::nanoseconds {
+    if (m_count == 0U) {
+      return std::chrono::nanoseconds{0};
+    }
+
+    auto const rank{std::max(
+        std::uint64_t{1},
+        static_cast<std::uint64_t>(
+            std::clamp(fraction, 0.0, 1.0) * static_cast<double>(m_count) +
+            0.5))};
+
+    std::uint64_t seen{0U};
+    for (std::size_t bucket{0U}; bucket < m_buckets.size(); ++bucket) {
+      seen += m_buckets[bucket];
+      if (seen >= rank) {
+        return std::chrono::nanoseconds{
+            static_cast<std::int64_t>(upperBoundOf(bucket))};
+      }
+    }
+
+    return std::chrono::nanoseconds{
+        static_cast<std::int64_t>(upperBoundOf(m_buckets.size() - 1U))};
+  }
+
+  /// @brief method to return the number of recorded latencies
+  /// @return the number of recorded latencies
+  [[nodiscard]] auto count() const noexcept -> std::uint64_t {
+    return m_count;
+  }
+
+private:
+  /// @brief number of linear sub-buckets per power of two, as a power of two
+  static constexpr unsigned kSubBucketsBits{2U};
+
+  /// @brief number of linear sub-buckets per power of two
+  static constexpr std::size_t kSubBuckets{std::size_t{1U} << kSubBucketsBits};
+
+  /// @brief counts of the recorded latencies per bucket, covering the whole
+  ///        range of 64-bit nanoseconds
+  std::array<std::uint64_t, kSubBuckets * 64U> m_buckets{};
+
+  /// @brief number of recorded latencies
+  std::uint64_t m_count{0U};
+
+  /// @brief private static method to return the bucket of a value
+  /// @param value the value in nanoseconds
+  /// @return index of the bucket of the value
+  static constexpr auto bucketOf(std::uint64_t value) noexcept -> std::size_t {
+    if (value < kSubBuckets) {
+      return value;
+    }
+
+    auto const exponent{static_cast<unsigned>(std::bit_width(value)) - 1U};
+    auto const shift{exponent - kSubBucketsBits};
+    auto const subBucket{(value >> shift) - kSubBuckets};
+
+    return (shift + 1U) * kSubBuckets + subBucket;
+  }
+
+  /// @brief private static method to return the largest value of a bucket
+  /// @param bucket index of the bucket
+  /// @return the largest value in nanoseconds that falls in the bucket
+  static constexpr auto
+  upperBoundOf(std::size_t bucket) noexcept -> std::uint64_t {
+    if (bucket < kSubBuckets) {
+      return bucket;
+    }
+
+    auto const shift{static_cast<unsigned>(bucket / kSubBuckets) - 1U};
+    auto const lowerBound{(kSubBuckets + bucket % kSubBuckets) << shift};
+
+    return lowerBound + ((std::uint64_t{1U} << shift) - 1U);
+  }
+};
+
+/// @brief a single execution of a statement, as reported to a StatementSink
+struct StatementSample {
+  /// @brief the normalized SQL text of the statement, check normalizeSql
+  std::string_view sql;
+
+  /// @brief wall time spent executing the statement
+  std::chrono::nanoseconds elapsed{0};
+
+  /// @brief number of rows returned by the statement
+  std::size_t rowsCount{0U};
+
+  /// @brief counters of the statement during this execution
+  StatementCounters counters;
+};
+
+/// @brief interface for receivers of each profiled statement execution, e.g.
+///        to forward slow statements to a log or a metrics system
+class StatementSink {
+public:
+  /// @brief virtual destructor for polymorphic behavior of classes implementing
+  ///        this interface
+  virtual ~StatementSink() noexcept = default;
+
+  /// @brief a method called once per profiled statement execution
+  /// @param sample the profiled execution
+  /// @note it is called from the thread that executed the statement, so it has
+  ///       to be cheap, and thread safe if the profiler is shared
+  virtual void consume(StatementSample const &sample) noexcept = 0;
+};
+
+/// @brief aggregated measurements of all the executions of a normalized
+///        statement
+struct StatementProfile {
+  /// @brief the normalized SQL text of the statement, check normalizeSql
+  std::string sql;
+
+  /// @brief number of executions
+  std::uint64_t calls{0U};
+
+  /// @brief total wall time of the executions
+  std::chrono::nanoseconds totalTime{0};
+
+  /// @brief estimated median wall time of the executions
+  std::chrono::nanoseconds p50Time{0};
+
+  /// @brief estimated 99th percentile wall time of the executions
+  std::chrono::nanoseconds p99Time{0};
+
+  /// @brief maximum wall time of the executions
+  std::chrono::nanoseconds maxTime{0};
+
+  /// @brief total number of rows returned by the executions
+  std::uint64_t rowsCount{0U};
+
+  /// @brief counters of the executions added together
+  StatementCounters counters;
+
+  /// @brief number of times the statement was prepared, i.e. was not found in
+  ///        the statement cache
+  std::uint64_t prepares{0U};
+
+  /// @brief total time spent preparing the statement
+  std::chrono::nanoseconds prepareTime{0};
+};
+
+/// @brief a collector of per statement measurements, which gets attached to
+///        CrudWrapper objects to profile the statements they run
+/// @note this class is thread safe, so the same profiler can be attached to
+///       more than one connection (e.g. the connections of a pool)
+class StatementProfiler {
+public:
+  /// @brief type alias for the clock used to measure statements
+  using Clock_type = std::chrono::steady_clock;
+
+  /// @brief method to record the preparation of a statement
+  /// @param sql the SQL text of the statement
+  /// @param elapsed the time spent preparing the statement
+  void recordPrepare(std::string_view sql,
+                     std::chrono::nanoseconds elapsed) noexcept {
+    auto const normalized{normalizeSql(sql)};
+
+    std::scoped_lock const lock{m_mutex};
+    auto &entry{entryOf(normalized)};
+    ++entry.profile.prepares;
+    entry.profile.prepareTime += elapsed;
+  }
+
+  /// @brief method to record an execution of a statement, and to pass it to
+  ///        the sink if one is set
+  /// @param sql the SQL text of the statement
+  /// @param elapsed the wall time spent executing the statement
+  /// @param rowsCount the number of rows returned by the statement
+  /// @param counters the counters of the statement during the execution
+  void recordExecution(std::string_view sql, std::chrono::nanoseconds elapsed,
+                       std::size_t rowsCount,
+                       StatementCounters const &counters) noexcept {
+    auto const normalized{normalizeSql(sql)};
+
+    std::shared_ptr<StatementSink> sink;
+    {
+      std::scoped_lock const lock{m_mutex};
+      auto &entry{entryOf(normalized)};
+      ++entry.profile.calls;
+      entry.profile.totalTime += elapsed;
+      entry.profile.maxTime = std::max(entry.profile.maxTime, elapsed);
+      entry.profile.rowsCount += rowsCount;
+      entry.profile.counters += counters;
+      entry.latencies.record(elapsed);
+      sink = m_sink;
+    }
+
+    // the sink is called without holding the lock, so it may take snapshots
+    if (sink != nullptr) {
+      sink->consume({.sql = normalized,
+                     .elapsed = elapsed,
+                     .rowsCount = rowsCount,
+                     .counters = counters});
+    }
+  }
+
+  /// @brief method to return the aggregated measurements of each statement
+  /// @return the profiles of the statements, ordered from the highest to the
+  ///         lowest total time
+  [[nodiscard]] auto snapshot() const -> std::vector<StatementProfile> {
+    std::vector<StatementProfile> profiles;
+
+    {
+      std::scoped_lock const lock{m_mutex};
+      profiles.reserve(m_entries.size());
+      for (auto const &[sql, entry] : m_entries) {
+        auto &profile{profiles.emplace_back(entry.profile)};
+        profile.sql = sql;
+        profile.p50Time = entry.latencies.percentile(0.5);
+        profile.p99Time = entry.latencies.percentile(0.99);
+      }
+    }
+
+    std::ranges::sort(profiles, std::ranges::greater{},
+                      &StatementProfile::totalTime);
+    return profiles;
+  }
+
+  /// @brief method to discard all the measurements recorded so far
+  void reset() noexcept {
+    std::scoped_lock const lock{m_mutex};
+    m_entries.clear();
+  }
+
+  /// @brief method to set the sink that receives each execution
+  /// @param sink the sink, or nullptr to stop passing executions on
+  void setSink(std::shared_ptr<StatementSink> sink) noexcept {
+    std::scoped_lock const lock{m_mutex};
+    m_sink = std::move(sink);
+  }
+
+private:
+  /// @brief measurements of a normalized statement
+  struct Entry {
+    /// @brief aggregated measurements, where the SQL and the percentiles are
+    ///        filled on demand
+    StatementProfile profile;
+
+    /// @brief latencies of the executions for estimating percentiles
+    LatencyHistogram latencies;
+  };
+
+  /// @brief mutex guarding the members below
+  mutable std::mutex m_mutex;
+
+  /// @brief measurements per normalized SQL text
+  std::unordered_map<std::string, Entry> m_entries;
+
+  /// @brief sink that receives each execution, if set
+  std::shared_ptr<StatementSink> m_sink;
+
+  /// @brief private method to return the entry of a normalized statement,
+  ///        creating it if necessary
+  /// @param normalizedSql the normalized SQL text
+  /// @return reference to the entry
+  auto entryOf(std::string const &normalizedSql) -> Entry & {
+    return m_entries.try_emplace(normalizedSql).first->second;
+  }
+};
+
+} // namespace sql_with_cpp
@@ -0,0 +1,298 @@
+#pragma once
+
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+/// @brief namespace for SQL with c++
+namespace sql_with_cpp {
+
+/// @brief namespace for implementation details of coroutine types
+namespace detail {
+
+/// @brief awaitable used as final suspension point, which resumes the
+///        coroutine waiting for the finished one, if any
+struct ContinuationAwaiter {
+  /// @brief the finished coroutine is always suspended
+  /// @return false
+  auto await_ready() const noexcept -> bool { return false; }
+
+  /// @brief method to transfer execution to the waiting coroutine
+  /// @tparam Promise the promise type of the finished coroutine
+  /// @param finished the finished coroutine
+  /// @return the waiting coroutine, or a no-op coroutine if none is waiting
+  template <typename Promise>
+  auto await_suspend(std::coroutine_handle<Promise> finished) const noexcept
+      -> std::coroutine_handle<> {
+    auto const continuation{finished.promise().continuation()};
+    return continuation ? continuation : std::noop_coroutine();
+  }
+
+  /// @brief nothing is returned, as the finished coroutine is never resumed
+  void await_resume() const noexcept {}
+};
+
+/// @brief the parts of the promise of Task that do not depend on its result
+class TaskPromiseBase {
+public:
+  /// @brief tasks are lazy, so they start running once awaited
+  /// @return awaitable that always suspends
+  auto initial_suspend() const noexcept -> std::suspend_always { return {}; }
+
+  /// @brief finished tasks resume the coroutine awaiting them
+  /// @return awaitable that transfers execution to the awaiting coroutine
+  auto final_suspend() const noexcept -> ContinuationAwaiter { return {}; }
+
+  /// @brief method to keep the exception escaping the task, so that it gets
+  ///        rethrown to the coroutine awaiting it
+  void unhandled_exception() noexcept { m_exception = std::current_exception(); }
+
+  /// @brief method to set the coroutine awaiting the task
+  /// @param continuation the awaiting coroutine
+  void setContinuation(std::coroutine_handle<> continuation) noexcept {
+    m_continuation = continuation;
+  }
+
+  /// @brief method to return the coroutine awaiting the task
+  /// @return the awaiting coroutine, or a null handle if none is set
+  [[nodiscard]] auto continuation() const noexcept -> std::coroutine_handle<> {
+    return m_continuation;
+  }
+
+protected:
+  /// @brief method to rethrow the exception that escaped the task, if any
+  void rethrowIfFailed() const {
+    if (m_exception) {
+      std::rethrow_exception(m_exception);
+    }
+  }
+
+private:
+  /// @brief the coroutine awaiting the task
+  std::coroutine_handle<> m_continuation;
+
+  /// @brief the exception that escaped the task, if any
+  std::exception_ptr m_exception;
+};
+
+/// @brief the part of the promise of Task that keeps its result
+/// @tparam T the type of the result
+template <typename T> class TaskPromiseResult : public TaskPromiseBase {
+public:
+  /// @brief method to keep the value returned by co_return
+  /// @param value the returned value
+  template <typename U>
+    requires std::convertible_to<U &&, T>
+  void return_value(U &&value) noexcept(
+      std::is_nothrow_constructible_v<T, U &&>) {
+    m_value.emplace(std::forward<U>(value));
+  }
+
+  /// @brief method to take the result of the finished task
+  /// @return the result of the task
+  auto takeResult() -> T {
+    rethrowIfFailed();
+    return std::move(*m_value);
+  }
+
+private:
+  /// @brief the result of the task, once returned
+  std::optional<T> m_value;
+};
+
+/// @brief specialization of the result part of the promise for tasks that
+///        return nothing
+template <> class TaskPromiseResult<void> : public TaskPromiseBase {
+public:
+  /// @brief nothing is kept by co_return
+  void return_void() const noexcept {}
+
+  /// @brief method to check the result of the finished task, i.e. rethrowing
+  ///        the exception that escaped it, if any
+  void takeResult() const { rethrowIfFailed(); }
+};
+
+} // namespace detail
+
+/// @brief a lazily started coroutine producing a single result, which starts
+///        running once awaited, and resumes the awaiting coroutine when done
+/// @tparam T the type of the result, or void
+/// @note the task gets destroyed with this object, so it must be awaited, or
+///       passed to syncWait, before this object is destroyed
+template <typename T = void> class [[nodiscard]] Task {
+public:
+  /// @brief promise type of the coroutine, as required by the language
+  class promise_type : public detail::TaskPromiseResult<T> {
+  public:
+    /// @brief method to create the task object returned to the caller
+    /// @return the task object
+    auto get_return_object() noexcept -> Task {
+      return Task{std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+  };
+
+  /// @brief deleted copy operations, as the coroutine has a unique owner
+  Task(Task const &) = delete;
+  auto operator=(Task const &) -> Task & = delete;
+
+  /// @brief move constructor that takes over the coroutine of other
+  /// @param other the task to move from
+  Task(Task &&other) noexcept
+      : m_handle{std::exchange(other.m_handle, nullptr)} {}
+
+  /// @brief move assignment operator that destroys the currently owned
+  ///        coroutine before taking over other's
+  /// @param other the task to move from
+  /// @return reference to this object
+  auto operator=(Task &&other) noexcept -> Task & {
+    if (this != &other) {
+      destroy();
+      m_handle = std::exchange(other.m_handle, nullptr);
+    }
+
+    return *this;
+  }
+
+  /// @brief destructor that destroys the owned coroutine
+  ~Task() noexcept { destroy(); }
+
+  /// @brief operator to start the task, and to suspend the awaiting coroutine
+  ///        until the task is done, as in co_await std::move(task)
+  /// @return awaitable whose result is the result of the task
+  auto operator co_await() && noexcept {
+    /// @brief awaitable of the task
+    struct Awaiter {
+      /// @brief the awaited coroutine
+      std::coroutine_handle<promise_type> handle;
+
+      /// @brief the awaiting coroutine is suspended unless the task is done
+      /// @return true if the task is done
+      auto await_ready() const noexcept -> bool {
+        return !handle || handle.done();
+      }
+
+      /// @brief method to start the task, resuming the awaiting coroutine
+      ///        once it is done
+      /// @param awaiting the awaiting coroutine
+      /// @return the task to transfer execution to
+      auto await_suspend(std::coroutine_handle<> awaiting) const noexcept
+          -> std::coroutine_handle<> {
+        handle.promise().setContinuation(awaiting);
+        return handle;
+      }
+
+      /// @brief method to return the result of the task
+      /// @return the result of the task
+      auto await_resume() const -> T { return handle.promise().takeResult(); }
+    };
+
+    return Awaiter{m_handle};
+  }
+
+private:
+  /// @brief handle to the owned coroutine
+  std::coroutine_handle<promise_type> m_handle;
+
+  /// @brief private parametrized constructor used by the promise
+  /// @param handle handle to the coroutine
+  explicit Task(std::coroutine_handle<promise_type> handle) noexcept
+      : m_handle{handle} {}
+
+  /// @brief private method to destroy the owned coroutine
+  void destroy() noexcept {
+    if (m_handle) {
+      m_handle.destroy();
+      m_handle = nullptr;
+    }
+  }
+};
+
+/// @brief namespace for implementation details of coroutine types
+namespace detail {
+
+/// @brief the state shared between syncWait and the coroutine it waits for
+/// @tparam T the type of the result of the awaited task
+template <typename T> struct SyncWaitState {
+  /// @brief mutex guarding the done flag
+  std::mutex mutex;
+
+  /// @brief condition signaled once the awaited task is done
+  std::condition_variable doneSignal;
+
+  /// @brief whether the awaited task is done
+  bool done{false};
+
+  /// @brief the result of the awaited task, once done
+  std::optional<std::conditional_t<std::is_void_v<T>, bool, T>> value;
+
+  /// @brief the exception that escaped the awaited task, if any
+  std::exception_ptr exception;
+};
+
+/// @brief an eagerly started coroutine that nobody waits for, and that
+///        destroys itself once done
+struct DetachedCoroutine {
+  /// @brief promise type of the coroutine, as required by the language
+  struct promise_type {
+    auto get_return_object() const noexcept -> DetachedCoroutine { return {}; }
+    auto initial_suspend() const noexcept -> std::suspend_never { return {}; }
+    auto final_suspend() const noexcept -> std::suspend_never { return {}; }
+    void return_void() const noexcept {}
+    void unhandled_exception() const noexcept { std::terminate(); }
+  };
+};
+
+/// @brief function to await a task, and to signal the state once it is done
+/// @tparam T the type of the result of the task
+/// @param task the task to await
+/// @param state the state to store the result into, and to signal
+/// @return detached coroutine object
+template <typename T>
+auto awaitAndSignal(Task<T> task, SyncWaitState<T> &state)
+    -> DetachedCoroutine {
+  try {
+    if constexpr (std::is_void_v<T>) {
+      co_await std::move(task);
+      state.value.emplace(true);
+    } else {
+      state.value.emplace(co_await std::move(task));
+    }
+  } catch (...) {
+    state.exception = std::current_exception();
+  }
+
+  // notifying while holding the lock keeps the state alive until notified
+  std::scoped_lock const lock{state.mutex};
+  state.done = true;
+  state.doneSignal.notify_one();
+}
+
+} // namespace detail
+
+/// @brief function to run a task to completion, blocking the calling thread
+///        until it is done, which bridges synchronous code to coroutines
+/// @tparam T the type of the result of the task
+/// @param task the task to run
+/// @return the result of the task
+/// @note the exception that escaped the task, if any, is rethrown
+template <typename T> auto syncWait(Task<T> task) -> T {
+  detail::SyncWaitState<T> state;
+  detail::awaitAndSignal(std::move(task), state);
+
+  std::unique_lock lock{state.mutex};
+  state.doneSignal.wait(lock, [&state] { return state.done; });
+
+  if (state.exception) {
+    std::rethrow_exception(state.exception);
+  }
+
+  if constexpr (!std::is_void_v<T>) {
+    return std::move(*state.value);
+  }
+}
+
+} // namespace sql_with_cpp
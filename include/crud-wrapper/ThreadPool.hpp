@@ -0,0 +1,183 @@
+#pragma once
+
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <latch>
+#include <mutex>
+#include <stdexcept>
+#include <stop_token>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/// @brief namespace for SQL with c++
+namespace sql_with_cpp {
+
+/// @brief a fixed size pool of worker threads running posted jobs in the order
+///        they were posted, which also serves as an executor for coroutines
+///        through schedule()
+/// @note pending jobs are still run when the pool gets destroyed, so that no
+///       coroutine scheduled on it is left suspended forever
+class ThreadPool {
+public:
+  /// @brief type alias for the jobs run by the pool
+  using Job_type = std::move_only_function<void()>;
+
+  /// @brief awaitable that resumes the awaiting coroutine on a worker thread
+  class ScheduleAwaiter {
+  public:
+    /// @brief parametrized constructor for the awaiter
+    /// @param pool the pool to resume the awaiting coroutine on
+    explicit ScheduleAwaiter(ThreadPool &pool) noexcept : m_pool{&pool} {}
+
+    /// @brief the awaiting coroutine is always suspended
+    /// @return false
+    auto await_ready() const noexcept -> bool { return false; }
+
+    /// @brief method to post the resumption of the awaiting coroutine
+    /// @param awaiting the awaiting coroutine
+    void await_suspend(std::coroutine_handle<> awaiting) {
+      m_pool->post([awaiting] { awaiting.resume(); });
+    }
+
+    /// @brief nothing is returned to the resumed coroutine
+    void await_resume() const noexcept {}
+
+  private:
+    /// @brief the pool to resume the awaiting coroutine on
+    ThreadPool *m_pool{nullptr};
+  };
+
+  /// @brief deleted default constructor for allowing only construction with
+  ///        an explicit number of threads
+  ThreadPool() = delete;
+
+  /// @brief parametrized constructor that starts the worker threads
+  /// @param threadsCount number of worker threads to start
+  /// @note throws std::invalid_argument for a zero threads count
+  explicit ThreadPool(std::size_t threadsCount) {
+    if (threadsCount == 0U) {
+      throw std::invalid_argument("Thread pool requires at least one thread");
+    }
+
+    m_threads.reserve(threadsCount);
+    for (std::size_t i{0U}; i < threadsCount; ++i) {
+      m_threads.emplace_back(
+          [this](std::stop_token stopToken) { runJobs(stopToken); });
+    }
+  }
+
+  /// @brief deleted copy and move operations, as the worker threads refer to
+  ///        the pool
+  ThreadPool(ThreadPool const &) = delete;
+  ThreadPool(ThreadPool &&) = delete;
+  auto operator=(ThreadPool const &) -> ThreadPool & = delete;
+  auto operator=(ThreadPool &&) -> ThreadPool & = delete;
+
+  /// @brief destructor that runs the pending jobs, then joins the threads
+  ~ThreadPool() noexcept {
+    for (auto &thread : m_threads) {
+      thread.request_stop();
+    }
+    m_jobPosted.notify_all();
+  }
+
+  /// @brief method to post a job to be run by one of the worker threads
+  /// @param job the job to run
+  void post(Job_type job) {
+    {
+      std::scoped_lock const lock{m_mutex};
+      m_jobs.push_back(std::move(job));
+    }
+
+    m_jobPosted.notify_one();
+  }
+
+  /// @brief method to call a function with each index in [0, count) on the
+  ///        worker threads, waiting for all the calls to return
+  /// @param count the number of calls
+  /// @param function the function, called with the index of a call
+  /// @note the first exception thrown by a call is rethrown once all the
+  ///       calls returned
+  /// @note it must not be called from a worker thread of this pool, as it
+  ///       blocks until the calls are run by the worker threads
+  template <typename Function>
+  void forEachIndex(std::size_t count, Function const &function) {
+    std::latch done{static_cast<std::ptrdiff_t>(count)};
+    std::mutex exceptionMutex;
+    std::exception_ptr exception;
+
+    for (std::size_t i{0U}; i < count; ++i) {
+      post([&function, &done, &exceptionMutex, &exception, i] {
+        try {
+          function(i);
+        } catch (...) {
+          std::scoped_lock const lock{exceptionMutex};
+          if (exception == nullptr) {
+            exception = std::current_exception();
+          }
+        }
+        done.count_down();
+      });
+    }
+    done.wait();
+
+    if (exception != nullptr) {
+      std::rethrow_exception(exception);
+    }
+  }
+
+  /// @brief method to resume the awaiting coroutine on a worker thread, as in
+  ///        co_await pool.schedule()
+  /// @return awaitable that resumes the awaiting coroutine on the pool
+  [[nodiscard]] auto schedule() noexcept -> ScheduleAwaiter {
+    return ScheduleAwaiter{*this};
+  }
+
+  /// @brief method to return the number of worker threads
+  /// @return the number of worker threads
+  [[nodiscard]] auto threadsCount() const noexcept -> std::size_t {
+    return m_threads.size();
+  }
+
+private:
+  /// @brief mutex guarding the pending jobs
+  std::mutex m_mutex;
+
+  /// @brief condition signaled when a job is posted
+  std::condition_variable_any m_jobPosted;
+
+  /// @brief the pending jobs, in the order they were posted
+  std::deque<Job_type> m_jobs;
+
+  /// @brief the worker threads, declared last so that they are joined before
+  ///        the members they use get destroyed
+  std::vector<std::jthread> m_threads;
+
+  /// @brief private method run by each worker thread, which runs the pending
+  ///        jobs until a stop is requested and no jobs are pending
+  /// @param stopToken the stop token of the worker thread
+  void runJobs(std::stop_token const &stopToken) {
+    while (true) {
+      Job_type job;
+      {
+        std::unique_lock lock{m_mutex};
+        m_jobPosted.wait(lock, stopToken, [this] { return !m_jobs.empty(); });
+        if (m_jobs.empty()) {
+          return;
+        }
+
+        job = std::move(m_jobs.front());
+        m_jobs.pop_front();
+      }
+
+      job();
+    }
+  }
+};
+
+} // namespace sql_with_cpp
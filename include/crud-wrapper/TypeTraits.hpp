@@ -0,0 +1,23 @@
+#pragma once
+
+#include <optional>
+#include <type_traits>
+
+/// @brief namespace for SQL with c++
+namespace sql_with_cpp {
+
+/// @brief a dependent false value, useful for static assertions in branches
+///        of if constexpr chains that must never be instantiated
+template <typename...> inline constexpr bool kAlwaysFalse{false};
+
+/// @brief a trait to detect specializations of std::optional
+template <typename T> struct IsOptional : std::false_type {};
+
+/// @brief specialization of the trait for std::optional
+template <typename T> struct IsOptional<std::optional<T>> : std::true_type {};
+
+/// @brief a concept satisfied by specializations of std::optional
+template <typename T>
+concept OptionalType = IsOptional<std::remove_cvref_t<T>>::value;
+
+} // namespace sql_with_cpp
@@ -0,0 +1,268 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "CrudWrapper.hpp"
+
+/// @brief namespace for SQL with c++
+namespace sql_with_cpp {
+
+/// @brief options bounding the batches committed by a WriteQueue
+struct WriteQueueOptions {
+  /// @brief maximum number of operations per batch when none is specified
+  static constexpr std::size_t kDefaultMaxBatchSize{256U};
+
+  /// @brief maximum number of operations committed in a single transaction
+  std::size_t maxBatchSize{kDefaultMaxBatchSize};
+
+  /// @brief how long the oldest operation of a batch may wait for more
+  ///        operations to join it before the batch is committed anyway,
+  ///        where zero commits whatever is queued as soon as the writer is
+  ///        idle, so batches only form while the previous one commits
+  std::chrono::microseconds maxLatency{0};
+};
+
+/// @brief a write-combining queue in front of a database connection, where
+///        many threads submit write operations, and a single writer thread
+///        commits them in batches, each in a single transaction, turning a
+///        commit (and fsync) per operation into a commit per batch
+/// @note each operation runs in a savepoint nested into the transaction of
+///       its batch, so a failing operation is rolled back alone, and fails
+///       its own future only
+/// @note futures are fulfilled once the batch is committed, so a future
+///       holding true means the operation is durable as far as the
+///       synchronous setting of the connection goes
+class WriteQueue {
+  /// @brief clock used for measuring the latency of operations
+  using Clock_type = std::chrono::steady_clock;
+
+public:
+  /// @brief type alias for the operations run by the writer thread, which
+  ///        return whether they succeeded
+  /// @note operations must not begin or commit transactions by statements
+  ///       (e.g. BEGIN; or COMMIT;), although they can nest their own
+  ///       through CrudWrapper::beginTransaction
+  using Operation_type = std::move_only_function<bool(CrudWrapper &)>;
+
+  /// @brief metrics describing how operations get batched
+  struct Stats {
+    /// @brief number of operations run so far
+    std::size_t operationsCount{0U};
+
+    /// @brief number of operations that failed, including the operations of
+    ///        batches that could not be committed
+    std::size_t failedOperationsCount{0U};
+
+    /// @brief number of batches run so far
+    std::size_t batchesCount{0U};
+
+    /// @brief number of operations of the largest batch
+    std::size_t largestBatchSize{0U};
+  };
+
+  /// @brief deleted default constructor for allowing only construction when
+  ///        passing a path to the database
+  WriteQueue() = delete;
+
+  /// @brief parametrized constructor that opens the connection of the writer
+  ///        thread, and starts it
+  /// @param path filesystem path to the database
+  /// @param options options bounding the batches
+  /// @param connectionOptions options of the connection of the writer thread
+  /// @note throws the same exceptions of the CrudWrapper constructor, or
+  ///       std::invalid_argument for a zero maximum batch size
+  explicit WriteQueue(
+      const std::convertible_to<std::filesystem::path> auto &path,
+      WriteQueueOptions const &options = {},
+      CrudWrapperOptions const &connectionOptions = CrudWrapperOptions{})
+      : m_db{path, connectionOptions}, m_options{options} {
+    if (m_options.maxBatchSize == 0U) {
+      throw std::invalid_argument("Write queue requires non-empty batches");
+    }
+
+    m_writer = std::jthread{
+        [this](std::stop_token stopToken) { runBatches(stopToken); }};
+  }
+
+  /// @brief deleted copy and move operations, as the writer thread refers to
+  ///        this object
+  WriteQueue(WriteQueue const &) = delete;
+  WriteQueue(WriteQueue &&) = delete;
+  auto operator=(WriteQueue const &) -> WriteQueue & = delete;
+  auto operator=(WriteQueue &&) -> WriteQueue & = delete;
+
+  /// @brief destructor that stops the writer thread, which commits the
+  ///        pending operations without waiting for more before it is joined
+  ~WriteQueue() noexcept = default;
+
+  /// @brief method to submit an operation to run by the writer thread
+  /// @param operation the operation, which is called with the connection of
+  ///                  the writer thread
+  /// @return future holding whether the operation succeeded and its batch
+  ///         got committed, or the exception thrown by the operation
+  [[nodiscard]] auto submit(Operation_type operation) -> std::future<bool> {
+    std::promise<bool> promise;
+    auto future{promise.get_future()};
+    {
+      std::scoped_lock const lock{m_mutex};
+      m_pending.push_back({.operation = std::move(operation),
+                           .promise = std::move(promise),
+                           .submittedAt = Clock_type::now()});
+    }
+    m_submitted.notify_one();
+
+    return future;
+  }
+
+  /// @brief method to submit SQL statements to run by the writer thread,
+  ///        check CrudWrapper::executeStatements
+  /// @param statements the SQL statements to run
+  /// @return future holding whether the statements succeeded and their
+  ///         batch got committed
+  [[nodiscard]] auto submit(std::string statements) -> std::future<bool> {
+    return submit([statements = std::move(statements)](CrudWrapper &db) {
+      return db.executeStatements(statements);
+    });
+  }
+
+  /// @brief method to return a snapshot of the queue metrics
+  /// @return the queue metrics
+  [[nodiscard]] auto stats() const -> Stats {
+    std::scoped_lock const lock{m_mutex};
+    return m_stats;
+  }
+
+private:
+  /// @brief an operation waiting for its batch
+  struct Pending {
+    /// @brief the operation to run
+    Operation_type operation;
+
+    /// @brief the promise of the outcome of the operation
+    std::promise<bool> promise;
+
+    /// @brief the time the operation was submitted at
+    Clock_type::time_point submittedAt;
+  };
+
+  /// @brief the connection of the writer thread
+  CrudWrapper m_db;
+
+  /// @brief options bounding the batches
+  WriteQueueOptions m_options;
+
+  /// @brief mutex guarding the pending operations and the metrics
+  mutable std::mutex m_mutex;
+
+  /// @brief condition signaled when an operation is submitted
+  std::condition_variable_any m_submitted;
+
+  /// @brief the pending operations, in the order they were submitted
+  std::deque<Pending> m_pending;
+
+  /// @brief the metrics of the queue
+  Stats m_stats;
+
+  /// @brief the writer thread, declared last so that it is joined before the
+  ///        members it uses get destroyed
+  std::jthread m_writer;
+
+  /// @brief private method run by the writer thread, which commits batches
+  ///        of pending operations until a stop is requested and no
+  ///        operations are pending
+  /// @param stopToken the stop token of the writer thread
+  void runBatches(std::stop_token const &stopToken) {
+    while (true) {
+      std::vector<Pending> batch;
+      {
+        std::unique_lock lock{m_mutex};
+        m_submitted.wait(lock, stopToken,
+                         [this] { return !m_pending.empty(); });
+        if (m_pending.empty()) {
+          return;
+        }
+
+        // the oldest operation bounds how long the batch waits to fill up
+        m_submitted.wait_until(
+            lock, stopToken,
+            m_pending.front().submittedAt + m_options.maxLatency,
+            [this] { return m_pending.size() >= m_options.maxBatchSize; });
+
+        auto const batchSize{
+            std::min(m_pending.size(), m_options.maxBatchSize)};
+        batch.reserve(batchSize);
+        for (std::size_t i{0U}; i < batchSize; ++i) {
+          batch.push_back(std::move(m_pending.front()));
+          m_pending.pop_front();
+        }
+      }
+
+      commitBatch(batch);
+    }
+  }
+
+  /// @brief private method to run a batch of operations in a single
+  ///        transaction, each in its own savepoint, and to fulfil their
+  ///        promises once the transaction ended
+  /// @param batch the operations of the batch
+  void commitBatch(std::vector<Pending> &batch) {
+    std::vector<char> succeeded(batch.size(), 0);
+    std::vector<std::exception_ptr> exceptions(batch.size());
+
+    auto transaction{m_db.beginTransaction(TransactionMode::Immediate)};
+    if (transaction.isActive()) {
+      for (std::size_t i{0U}; i < batch.size(); ++i) {
+        auto savepoint{m_db.beginTransaction()};
+        try {
+          succeeded[i] = savepoint.isActive() && batch[i].operation(m_db) &&
+                         savepoint.commit();
+        } catch (...) {
+          exceptions[i] = std::current_exception();
+        }
+      }
+
+      if (!transaction.commit()) {
+        std::ranges::fill(succeeded, 0);
+      }
+    }
+
+    // the metrics are updated first, so they account for the batch once its
+    // futures are ready
+    auto const failedCount{static_cast<std::size_t>(std::ranges::count(
+        succeeded, static_cast<char>(0)))};
+    {
+      std::scoped_lock const lock{m_mutex};
+      m_stats.operationsCount += batch.size();
+      m_stats.failedOperationsCount += failedCount;
+      ++m_stats.batchesCount;
+      m_stats.largestBatchSize =
+          std::max(m_stats.largestBatchSize, batch.size());
+    }
+
+    for (std::size_t i{0U}; i < batch.size(); ++i) {
+      if (exceptions[i] != nullptr) {
+        batch[i].promise.set_exception(exceptions[i]);
+      } else {
+        batch[i].promise.set_value(succeeded[i] != 0);
+      }
+    }
+  }
+};
+
+} // namespace sql_with_cpp
@@ -0,0 +1,22 @@
+#!/bin/bash
+
+# path to the benchmarks executable
+executable="build/benchmark/crud-wrapper-benchmarks"
+
+# output file of the results, which defaults to a file named after the
+# current commit, so that results of different commits can be compared
+output="${1:-build/benchmark/results-$(git rev-parse --short HEAD).json}"
+
+# optional regex to filter the benchmarks to run
+filter="${2:-.}"
+
+if [ ! -x "$executable" ]; then
+    echo "Benchmarks not found, build with -DBUILD_BENCHMARKS=ON first"
+    exit 1
+fi
+
+echo "Running: $executable with filter: $filter"
+./"$executable" --benchmark_filter="$filter" \
+    --benchmark_out="$output" --benchmark_out_format=json
+
+echo "Results written to: $output"
@@ -0,0 +1,164 @@
+#include "crud-wrapper/AsyncCrudWrapper.hpp"
+#include "TestUtils.hpp"
+
+#include "gtest/gtest.h"
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+
+/// @brief anonymous namespace for needed constants in thus TU
+namespace {
+/// @brief prefix of the databases copied by the tests of this TU
+const std::string ktempPrefix{"async-crud-wrapper-test-"};
+
+/// @brief coroutine returning the id of the thread it resumes on after being
+///        scheduled on the given pool
+auto threadIdAfterScheduling(sql_with_cpp::ThreadPool &pool)
+    -> sql_with_cpp::Task<std::thread::id> {
+  co_await pool.schedule();
+  co_return std::this_thread::get_id();
+}
+
+/// @brief coroutine that fails after being scheduled on the given pool
+auto failAfterScheduling(sql_with_cpp::ThreadPool &pool)
+    -> sql_with_cpp::Task<> {
+  co_await pool.schedule();
+  throw std::runtime_error("failed");
+}
+
+/// @brief coroutine that writes a city, then reads its name back
+auto insertThenReadCity(sql_with_cpp::AsyncCrudWrapper &db)
+    -> sql_with_cpp::Task<std::vector<std::string>> {
+  auto const inserted{co_await db.executeAsync(
+      "INSERT INTO City (ID, Name, CountryCode, District, Population) "
+      "VALUES (5000, 'Coroutine City', 'NLD', 'Async', 42);")};
+  if (!inserted) {
+    co_return std::vector<std::string>{};
+  }
+
+  auto names{co_await db.getRowsAsAsync<std::string>(
+      "SELECT Name FROM City WHERE ID = ? AND Population = ?", 5000, 42)};
+  co_return names;
+}
+
+/// @brief coroutine that consumes a stream of cities, and returns the sizes
+///        of the chunks along with the total population
+auto consumeCitiesStream(sql_with_cpp::AsyncCrudWrapper &db,
+                         std::size_t chunkSize)
+    -> sql_with_cpp::Task<std::pair<std::vector<std::size_t>, std::int64_t>> {
+  std::vector<std::size_t> chunksSizes;
+  std::int64_t totalPopulation{0};
+
+  auto stream{db.streamAsync<std::tuple<std::int64_t, std::int64_t>>(
+      "SELECT ID, Population FROM City WHERE ID > ?", chunkSize, 0)};
+  while (auto chunk{co_await stream.next()}) {
+    chunksSizes.push_back(chunk->size());
+    for (auto const &[id, population] : *chunk) {
+      totalPopulation += population;
+    }
+  }
+
+  co_return std::pair{chunksSizes, totalPopulation};
+}
+
+/// @brief coroutine that reads only the first chunk of a stream, and drops it
+auto readFirstChunkOnly(sql_with_cpp::AsyncCrudWrapper &db)
+    -> sql_with_cpp::Task<std::size_t> {
+  auto stream{db.streamAsync<std::string>("SELECT Name FROM City", 10U)};
+  auto const chunk{co_await stream.next()};
+  co_return chunk.has_value() ? chunk->size() : 0U;
+}
+
+} // namespace
+
+/// @brief namespace for AsyncCrudWrapper tests
+namespace sql_with_cpp_test::asyncCrudWrapper_test {
+using namespace ::sql_with_cpp;
+
+TEST(TestingThreadPool, ScheduledCoroutinesResumeOnWorkers) {
+  EXPECT_THROW({ ThreadPool{0U}; }, std::invalid_argument);
+
+  ThreadPool pool{2U};
+  EXPECT_EQ(pool.threadsCount(), 2U);
+  EXPECT_NE(syncWait(threadIdAfterScheduling(pool)),
+            std::this_thread::get_id());
+
+  EXPECT_THROW({ syncWait(failAfterScheduling(pool)); }, std::runtime_error);
+}
+
+TEST(TestingThreadPool, PendingJobsRunBeforeDestruction) {
+  std::atomic<int> jobsRun{0};
+  {
+    ThreadPool pool{1U};
+    for (auto i{0}; i < 100; ++i) {
+      pool.post([&jobsRun] { ++jobsRun; });
+    }
+  }
+
+  EXPECT_EQ(jobsRun.load(), 100);
+}
+
+TEST(TestingAsyncCrudWrapper, GetRowsAsync) {
+  AsyncCrudWrapper db{copyDatabase("world.db", ktempPrefix), 2U};
+
+  auto task{db.getRowsAsync("City")};
+  auto const rows{syncWait(std::move(task))};
+  ASSERT_EQ(rows.size(), 4080U);
+  EXPECT_EQ(rows.front(),
+            (std::vector<std::string>{"ID", "Name", "CountryCode", "District",
+                                      "Population"}));
+
+  EXPECT_EQ(syncWait(db.getRowsAsync("NonExistingTable")).size(), 1U);
+  EXPECT_EQ(db.pool().stats().readerLeases, 2U);
+}
+
+TEST(TestingAsyncCrudWrapper, ExecuteAsyncThenReadBack) {
+  AsyncCrudWrapper db{copyDatabase("world.db", ktempPrefix), 2U};
+
+  EXPECT_EQ(syncWait(insertThenReadCity(db)),
+            std::vector<std::string>{"Coroutine City"});
+  EXPECT_FALSE(syncWait(db.executeAsync("INSERT INTO NonExistingTable;")));
+  EXPECT_TRUE(syncWait(db.getRowsAsAsync<int>("SELECT", 1)).empty());
+}
+
+TEST(TestingAsyncCrudWrapper, StreamRowsInChunks) {
+  AsyncCrudWrapper db{copyDatabase("world.db", ktempPrefix), 2U};
+
+  auto const expectedPopulation{syncWait(db.getRowsAsAsync<std::int64_t>(
+      "SELECT SUM(Population) FROM City"))};
+  ASSERT_EQ(expectedPopulation.size(), 1U);
+
+  auto const [chunksSizes, totalPopulation]{
+      syncWait(consumeCitiesStream(db, 1000U))};
+  EXPECT_EQ(chunksSizes,
+            (std::vector<std::size_t>{1000U, 1000U, 1000U, 1000U, 79U}));
+  EXPECT_EQ(totalPopulation, expectedPopulation.front());
+
+  // dropping a stream midway returns its reader connection
+  EXPECT_EQ(syncWait(readFirstChunkOnly(db)), 10U);
+  EXPECT_EQ(db.pool().stats().readersInUse, 0U);
+}
+
+TEST(TestingAsyncCrudWrapper, ConcurrentTasksShareThePool) {
+  AsyncCrudWrapper db{copyDatabase("world.db", ktempPrefix), 2U};
+
+  constexpr auto threadsCount{6U};
+  std::vector<std::size_t> rowsCounts(threadsCount, 0U);
+  {
+    std::vector<std::jthread> threads;
+    for (auto i{0U}; i < threadsCount; ++i) {
+      threads.emplace_back([&db, &rowsCounts, i] {
+        rowsCounts[i] = syncWait(db.getRowsAsync("City")).size();
+      });
+    }
+  }
+
+  for (auto const rowsCount : rowsCounts) {
+    EXPECT_EQ(rowsCount, 4080U);
+  }
+  EXPECT_LE(db.pool().stats().peakReadersInUse, 2U);
+}
+
+} // namespace sql_with_cpp_test::asyncCrudWrapper_test
@@ -0,0 +1,184 @@
+#include "crud-wrapper/CrudWrapperPool.hpp"
+#include "TestUtils.hpp"
+
+#include "gtest/gtest.h"
+#include <cstdint>
+#include <mutex>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+/// @brief anonymous namespace for needed constants in thus TU
+namespace {
+/// @brief prefix of the databases copied by the tests of this TU
+const std::string ktempPrefix{"crud-wrapper-pool-test-"};
+
+} // namespace
+
+/// @brief namespace for CrudWrapperPool tests
+namespace sql_with_cpp_test::crudWrapperPool_test {
+using namespace ::sql_with_cpp;
+
+TEST(TestingPoolConstruction, ConstructingCrudWrapperPool) {
+  EXPECT_THROW(
+      { CrudWrapperPool{"/non/existing/path"}; },
+      std::filesystem::filesystem_error);
+
+  auto const dbPath{copyDatabase("world.db", ktempPrefix)};
+  EXPECT_THROW({ CrudWrapperPool(dbPath, 0U); }, std::invalid_argument);
+
+  CrudWrapperPool const pool{dbPath, 3U};
+  auto const stats{pool.stats()};
+  EXPECT_EQ(stats.readersCount, 3U);
+  EXPECT_EQ(stats.readersInUse, 0U);
+  EXPECT_FALSE(stats.writerInUse);
+}
+
+TEST(TestingPoolLeases, ReadersSeeWritesOfTheWriter) {
+  CrudWrapperPool pool{copyDatabase("scratch.db", ktempPrefix), 2U};
+
+  {
+    auto writer{pool.acquireWriter()};
+    EXPECT_TRUE(pool.stats().writerInUse);
+    EXPECT_TRUE(writer->executeStatements(
+        "INSERT INTO item (id, name, description) "
+        "VALUES (5, 'Pool', 'Leased connections');"));
+  }
+
+  auto reader{pool.acquireReader()};
+  EXPECT_EQ(pool.stats().readersInUse, 1U);
+  EXPECT_EQ(reader->getRows("item").size(), 6U);
+  EXPECT_EQ(reader->getRows("item").back(),
+            (std::vector<std::string>{"5", "Pool", "Leased connections"}));
+
+  // readers are opened read-only
+  auto preparedStatement{
+      reader->prepareStatement("DELETE FROM item WHERE id = 5")};
+  EXPECT_EQ(sqlite3_step(preparedStatement.get().get()), SQLITE_READONLY);
+}
+
+TEST(TestingPoolLeases, LeasesAreReturnedOnDestructionAndMove) {
+  CrudWrapperPool pool{copyDatabase("album.db", ktempPrefix), 2U};
+
+  {
+    auto first{pool.acquireReader()};
+    auto second{pool.acquireReader()};
+    EXPECT_EQ(pool.stats().readersInUse, 2U);
+
+    auto moved{std::move(first)};
+    EXPECT_EQ(pool.stats().readersInUse, 2U);
+
+    second = std::move(moved);
+    EXPECT_EQ(pool.stats().readersInUse, 1U);
+  }
+
+  auto const stats{pool.stats()};
+  EXPECT_EQ(stats.readersInUse, 0U);
+  EXPECT_EQ(stats.peakReadersInUse, 2U);
+  EXPECT_EQ(stats.readerLeases, 2U);
+}
+
+TEST(TestingPoolConcurrency, ConcurrentReadersAndWriter) {
+  CrudWrapperPool pool{copyDatabase("world.db", ktempPrefix), 2U};
+  auto const expectedRowsCount{pool.acquireReader()->getRows("City").size()};
+
+  constexpr auto threadsCount{8U};
+  constexpr auto readsPerThread{5U};
+  std::vector<std::size_t> rowsCounts(threadsCount * readsPerThread, 0U);
+
+  {
+    std::vector<std::jthread> threads;
+    for (auto i{0U}; i < threadsCount; ++i) {
+      threads.emplace_back([&pool, &rowsCounts, i] {
+        for (auto j{0U}; j < readsPerThread; ++j) {
+          rowsCounts[i * readsPerThread + j] =
+              pool.acquireReader()->getRows("City").size();
+        }
+      });
+    }
+
+    threads.emplace_back([&pool] {
+      for (auto j{0U}; j < readsPerThread; ++j) {
+        EXPECT_TRUE(pool.acquireWriter()->executeStatements(
+            "UPDATE City SET Population = Population + 1 WHERE ID = 1;"));
+      }
+    });
+  }
+
+  for (auto const rowsCount : rowsCounts) {
+    EXPECT_EQ(rowsCount, expectedRowsCount);
+  }
+
+  auto const stats{pool.stats()};
+  EXPECT_EQ(stats.readerLeases, threadsCount * readsPerThread + 1U);
+  EXPECT_EQ(stats.writerLeases, readsPerThread);
+  EXPECT_LE(stats.peakReadersInUse, 2U);
+  EXPECT_GE(stats.maxReaderWait, std::chrono::nanoseconds{0});
+  EXPECT_GT(stats.readersUtilization, 0.0);
+  EXPECT_LE(stats.readersUtilization, 1.0);
+  auto const reader{pool.acquireReader()};
+  EXPECT_EQ(reader->getRowsAs<int>(reader->prepareStatement(
+                "SELECT Population FROM City WHERE ID = 1")),
+            std::vector<int>{1780005});
+}
+
+TEST(TestingPoolScans, ScanningATableByRowidRanges) {
+  CrudWrapperPool pool{copyDatabase("world.db", ktempPrefix), 3U};
+  EXPECT_THROW({ std::ignore = pool.parallelScan<int>("Empty"); },
+               std::invalid_argument);
+  EXPECT_THROW(
+      { std::ignore = pool.scanChunks("Empty", [](auto, auto const &) {}); },
+      std::invalid_argument);
+
+  using Row_type = std::tuple<std::int64_t, std::string>;
+  auto const reader{pool.acquireReader()};
+  auto const expectedRows{reader->getRowsAs<Row_type>(
+      reader->prepareStatement("SELECT ID, Name FROM City ORDER BY rowid"))};
+
+  // more chunks than readers, and more than the rowids of a tiny table
+  auto const idsAndNames{[&pool](std::size_t chunksCount) {
+    std::vector<Row_type> rows;
+    for (auto const &[id, name, countryCode, district, population] :
+         pool.parallelScan<std::tuple<std::int64_t, std::string, std::string,
+                                      std::string, std::int64_t>>(
+             "City", chunksCount)) {
+      rows.emplace_back(id, name);
+    }
+    return rows;
+  }};
+  EXPECT_EQ(idsAndNames(0U), expectedRows);
+  EXPECT_EQ(idsAndNames(7U), expectedRows);
+  EXPECT_EQ(idsAndNames(100'000U), expectedRows);
+
+  std::mutex chunksMutex;
+  std::vector<std::size_t> chunksRowsCounts(5U, 0U);
+  EXPECT_EQ(pool.scanChunks("City",
+                            [&](std::size_t index, ResultSet const &chunk) {
+                              EXPECT_EQ(chunk.columnsCount(), 5U);
+                              std::scoped_lock const lock{chunksMutex};
+                              chunksRowsCounts[index] = chunk.rowsCount();
+                            },
+                            5U),
+            5U);
+  for (auto const rowsCount : chunksRowsCounts) {
+    EXPECT_GT(rowsCount, 0U);
+  }
+  EXPECT_EQ(std::accumulate(chunksRowsCounts.begin(), chunksRowsCounts.end(),
+                            std::size_t{0U}),
+            expectedRows.size());
+
+  {
+    auto writer{pool.acquireWriter()};
+    EXPECT_TRUE(writer->executeStatements(
+        "CREATE TABLE Edges (Weight INTEGER);"
+        "INSERT INTO Edges (rowid, Weight) "
+        "VALUES (-9223372036854775808, 1), (9223372036854775807, 2);"
+        "CREATE TABLE Empty (Weight INTEGER);"));
+  }
+  EXPECT_EQ(pool.parallelScan<int>("Edges", 3U), (std::vector<int>{1, 2}));
+  EXPECT_EQ(pool.scanChunks("Empty", [](auto, auto const &) {}), 0U);
+}
+
+} // namespace sql_with_cpp_test::crudWrapperPool_test
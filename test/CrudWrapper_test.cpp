@@ -1,12 +1,50 @@
 #include "crud-wrapper/CrudWrapper.hpp"
+#include "crud-wrapper/ColumnKernels.hpp"
+#include "TestUtils.hpp"
 
 #include "gtest/gtest.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <format>
+#include <fstream>
+#include <iterator>
+#include <memory_resource>
+#include <numeric>
+#include <ranges>
+#include <set>
+#include <sstream>
+#include <thread>
 
 /// @brief anonymous namespace for needed constants in thus TU
 namespace {
-/// @brief path to the root of this project
-const std::string kprojectRootPath{PROJECT_ROOT_PATH};
+/// @brief prefix of the databases copied by the tests of this TU
+const std::string ktempPrefix{"crud-wrapper-test-"};
+
+/// @brief function to create an empty database in the temporary directory
+/// @param dbName the name of the database to create
+/// @return path to the created database
+auto makeEmptyDatabase(std::string const &dbName) -> std::filesystem::path {
+  auto const path{std::filesystem::temp_directory_path() /
+                  (ktempPrefix + dbName)};
+  sql_with_cpp_test::removeDatabase(path);
+
+  // CrudWrapper opens existing databases only
+  std::ofstream const file{path};
+  return path;
+}
+
+/// @brief function to write an SQL script into the temporary directory
+/// @param scriptName the name of the script to write
+/// @param statements the text of the script
+/// @return path to the written script
+auto writeScript(std::string const &scriptName,
+                 std::string const &statements) -> std::filesystem::path {
+  auto const path{std::filesystem::temp_directory_path() /
+                  (ktempPrefix + scriptName)};
+  std::ofstream{path} << statements;
+  return path;
+}
 
 } // namespace
 
@@ -346,4 +384,1634 @@ TEST(TestingPreparingStatements, RebindValidStatements) {
   }
 }
 
+TEST(TestingStatementCache, RepeatedReadsReuseCachedStatements) {
+  CrudWrapper const db{kprojectRootPath + "/db/world.db"};
+
+  // columns names are served by the schema catalog, not by a SELECT
+  auto const columnsNames{db.peekColumnsNames("City")};
+  auto const initialStats{db.statementCacheStats()};
+
+  auto const firstRows{db.getRows("City")};
+  auto const secondRows{db.getRows("City")};
+
+  EXPECT_EQ(firstRows, secondRows);
+  EXPECT_EQ(columnsNames, firstRows[0U]);
+
+  auto const stats{db.statementCacheStats()};
+  EXPECT_EQ(stats.misses - initialStats.misses, 1U);
+  EXPECT_EQ(stats.hits - initialStats.hits, 1U);
+}
+
+TEST(TestingStatementCache, CachedStatementsAreHandedBackResetAndCleared) {
+  CrudWrapper const db{kprojectRootPath + "/db/scratch.db"};
+  auto const statement{std::string{"SELECT * FROM sale WHERE price > ? "}};
+
+  {
+    auto preparedStatement{db.prepareStatement(statement)};
+    ASSERT_TRUE(preparedStatement.bindText("2500", 1U));
+    EXPECT_EQ(db.getRows(preparedStatement).size(), 4U);
+  }
+
+  // the statement taken from the cache shall have no bindings left
+  auto preparedStatement{db.prepareStatement(statement)};
+  EXPECT_EQ(db.statementCacheStats().hits, 1U);
+  EXPECT_EQ(sqlite3_bind_parameter_count(preparedStatement.get().get()), 1);
+  EXPECT_EQ(db.getRows(preparedStatement).size(), 1U);
+}
+
+TEST(TestingStatementCache, StatementsWithTrailingTextAreCachedToo) {
+  CrudWrapper const db{kprojectRootPath + "/db/world.db"};
+  // SQLite keeps the text up to the semicolon only
+  auto const statement{std::string{"SELECT count(*) FROM City; \n"}};
+  auto const initialStats{db.statementCacheStats()};
+
+  for (int i{0}; i < 5; ++i) {
+    EXPECT_EQ(db.getRowsAs<std::int64_t>(db.prepareStatement(statement)),
+              std::vector<std::int64_t>{4079});
+  }
+
+  auto const stats{db.statementCacheStats()};
+  EXPECT_EQ(stats.misses - initialStats.misses, 1U);
+  EXPECT_EQ(stats.hits - initialStats.hits, 4U);
+}
+
+TEST(TestingStatementCache, LeastRecentlyUsedStatementsAreEvicted) {
+  CrudWrapper db{kprojectRootPath + "/db/album.db"};
+  db.setStatementCacheCapacity(1U);
+
+  std::ignore = db.getRows("album");
+  std::ignore = db.getRows("track");
+  EXPECT_EQ(db.statementCacheStats().size, 1U);
+  EXPECT_GE(db.statementCacheStats().evictions, 1U);
+
+  auto const hitsBefore{db.statementCacheStats().hits};
+  std::ignore = db.getRows("album");
+  EXPECT_EQ(db.statementCacheStats().hits, hitsBefore);
+
+  std::ignore = db.getRows("album");
+  EXPECT_EQ(db.statementCacheStats().hits, hitsBefore + 1U);
+}
+
+TEST(TestingStatementCache, ZeroCapacityDisablesCaching) {
+  CrudWrapper db{kprojectRootPath + "/db/album.db"};
+  db.setStatementCacheCapacity(0U);
+
+  std::ignore = db.getRows("album");
+  std::ignore = db.getRows("album");
+
+  auto const stats{db.statementCacheStats()};
+  EXPECT_EQ(stats.hits, 0U);
+  EXPECT_EQ(stats.size, 0U);
+  EXPECT_EQ(stats.capacity, 0U);
+}
+
+TEST(TestingStatementCache, SchemaChangesInvalidateCachedStatements) {
+  CrudWrapper db{kprojectRootPath + "/db/album.db"};
+  auto const newTableName{std::string{"cachedTable"}};
+
+  ASSERT_TRUE(db.executeStatements(
+      std::format("DROP TABLE IF EXISTS {};"
+                  "CREATE TABLE {} (column1 TEXT);",
+                  newTableName, newTableName)));
+  EXPECT_EQ(db.peekColumnsNames(newTableName),
+            std::vector<std::string>{"column1"});
+
+  ASSERT_TRUE(db.executeStatements(
+      std::format("DROP TABLE {};"
+                  "CREATE TABLE {} (column1 TEXT, column2 TEXT);",
+                  newTableName, newTableName)));
+  EXPECT_EQ(db.peekColumnsNames(newTableName),
+            (std::vector<std::string>{"column1", "column2"}));
+
+  ASSERT_TRUE(
+      db.executeStatements(std::format("DROP TABLE {};", newTableName)));
+  EXPECT_EQ(db.peekColumnsNames(newTableName), std::vector<std::string>{});
+}
+
+TEST(TestingPreparingStatements, BindTypedValues) {
+  CrudWrapper const db{kprojectRootPath + "/db/album.db"};
+
+  {
+    auto preparedStatement{db.prepareStatement(std::string{
+        "SELECT * FROM track WHERE track_number = ? AND duration > ?"})};
+
+    ASSERT_TRUE(preparedStatement.bind(10, 1U));
+    ASSERT_TRUE(preparedStatement.bind(std::int64_t{140}, 2U));
+
+    const auto queryResult{db.getRows(preparedStatement)};
+    auto const expectedQueryResult{std::vector<std::vector<std::string>>{
+        {"id", "album_id", "title", "track_number", "duration"},
+        {"10", "1", "That's All", "10", "368"},
+        {"31", "12", "I'm Looking Through You", "10", "147"}}};
+
+    EXPECT_EQ(queryResult, expectedQueryResult);
+  }
+
+  {
+    auto preparedStatement{db.prepareStatement(
+        std::string{"SELECT typeof(?), typeof(?), typeof(?), typeof(?), ?"})};
+
+    std::array const bytes{std::byte{'a'}, std::byte{'b'}};
+    std::string_view const text{"viewed text"};
+
+    ASSERT_TRUE(preparedStatement.bind(2.5, 1U));
+    ASSERT_TRUE(preparedStatement.bind(std::span<const std::byte>{bytes}, 2U));
+    ASSERT_TRUE(preparedStatement.bindNull(3U));
+    ASSERT_TRUE(preparedStatement.bindTextView(text, 4U));
+    ASSERT_TRUE(preparedStatement.bindTextView(text, 5U));
+
+    const auto queryResult{db.getRows(preparedStatement)};
+    ASSERT_EQ(queryResult.size(), 2U);
+    EXPECT_EQ(queryResult[1U], (std::vector<std::string>{"real", "blob", "null",
+                                                         "text", "viewed text"}));
+  }
+}
+
+TEST(TestingPreparingStatements, BindAllValuesInOneCall) {
+  CrudWrapper const db{kprojectRootPath + "/db/album.db"};
+
+  auto preparedStatement{
+      db.prepareStatement(std::string{"SELECT * FROM track WHERE title LIKE "
+                                      "? AND duration BETWEEN ? AND ? "})};
+
+  ASSERT_TRUE(preparedStatement.bindAll("%you%", 130, std::int64_t{200}));
+
+  const auto queryResult{db.getRows(preparedStatement)};
+  auto const expectedQueryResult{std::vector<std::vector<std::string>>{
+      {"id", "album_id", "title", "track_number", "duration"},
+      {"26", "12", "Think for Yourself", "5", "139"},
+      {"31", "12", "I'm Looking Through You", "10", "147"},
+      {"35", "12", "Run for Your Life", "14", "138"}}};
+
+  EXPECT_EQ(queryResult, expectedQueryResult);
+
+  auto typesStatement{db.prepareStatement(
+      std::string{"SELECT typeof(?), typeof(?), typeof(?), typeof(?)"})};
+
+  ASSERT_TRUE(typesStatement.bindAll(std::string{"owned"}, std::nullopt,
+                                     std::optional<double>{1.5},
+                                     std::vector<std::byte>{std::byte{1}}));
+  EXPECT_EQ(db.getRows(typesStatement)[1U],
+            (std::vector<std::string>{"text", "null", "real", "blob"}));
+}
+
+TEST(TestingPreparingStatements, BindToInvalidPositions) {
+  CrudWrapper const db{kprojectRootPath + "/db/world.db"};
+
+  auto preparedStatement{
+      db.prepareStatement(std::string{"SELECT * FROM City WHERE ID = ?"})};
+
+  EXPECT_FALSE(preparedStatement.bind(1, 2U));
+  EXPECT_FALSE(preparedStatement.bindNull(0U));
+  EXPECT_FALSE(preparedStatement.bindAll(1, 2));
+  EXPECT_TRUE(preparedStatement.bindAll(1));
+}
+
+TEST(TestingGetRowsAs, GetTypedRowsOfExistingTables) {
+  CrudWrapper const db{kprojectRootPath + "/db/scratch.db"};
+
+  using SaleRow = std::tuple<std::int64_t, std::int64_t, std::int64_t,
+                             std::string, int, double>;
+  const auto saleRows{db.getRowsAs<SaleRow>("sale")};
+
+  ASSERT_EQ(saleRows.size(), 5U);
+  EXPECT_EQ(saleRows[0U], (SaleRow{1, 1, 2, "2009-02-27", 3, 2995.0}));
+  EXPECT_EQ(saleRows[3U], (SaleRow{4, 4, 3, "2009-02-28", 2, 999.0}));
+
+  // a single column type reads the first column
+  EXPECT_EQ(db.getRowsAs<std::int64_t>("sale"),
+            (std::vector<std::int64_t>{1, 2, 3, 4, 5}));
+}
+
+TEST(TestingGetRowsAs, GetTypedRowsOfPreparedStatement) {
+  CrudWrapper const db{kprojectRootPath + "/db/world.db"};
+
+  auto preparedStatement{db.prepareStatement(
+      std::string{"SELECT Name, SurfaceArea, IndepYear, LifeExpectancy "
+                  "FROM Country WHERE Code IN (?, ?) ORDER BY Code"})};
+  ASSERT_TRUE(preparedStatement.bindAll("ATA", "DEU"));
+
+  using CountryRow = std::tuple<std::string, double, std::optional<int>,
+                                std::optional<double>>;
+  const auto countryRows{db.getRowsAs<CountryRow>(preparedStatement)};
+
+  ASSERT_EQ(countryRows.size(), 2U);
+  EXPECT_EQ(std::get<0U>(countryRows[0U]), "Antarctica");
+  EXPECT_DOUBLE_EQ(std::get<1U>(countryRows[0U]), 13120000.0);
+  EXPECT_EQ(std::get<2U>(countryRows[0U]), std::nullopt);
+  EXPECT_EQ(std::get<3U>(countryRows[0U]), std::nullopt);
+
+  EXPECT_EQ(std::get<0U>(countryRows[1U]), "Germany");
+  EXPECT_EQ(std::get<2U>(countryRows[1U]), std::optional<int>{1955});
+  EXPECT_DOUBLE_EQ(std::get<3U>(countryRows[1U]).value_or(0.0), 77.4);
+}
+
+TEST(TestingGetRowsAs, GetTypedRowsWithMismatchingColumns) {
+  CrudWrapper const db{kprojectRootPath + "/db/scratch.db"};
+
+  using TooWideRow = std::tuple<int, std::string, std::string, std::string>;
+  EXPECT_TRUE(db.getRowsAs<TooWideRow>("item").empty());
+  EXPECT_TRUE(db.getRowsAs<int>("nonExistingTable").empty());
+}
+
+TEST(TestingQuery, IterateRowsLazily) {
+  CrudWrapper const db{kprojectRootPath + "/db/world.db"};
+
+  std::size_t rowsCount{0U};
+  std::int64_t totalPopulation{0};
+  for (auto const row : db.query("SELECT ID, Population FROM City")) {
+    ASSERT_EQ(row.columnsCount(), 2U);
+    ++rowsCount;
+    totalPopulation += row.get<std::int64_t>(1U);
+  }
+
+  EXPECT_EQ(rowsCount, db.getRows("City").size() - 1U);
+  EXPECT_EQ(totalPopulation,
+            db.getRowsAs<std::int64_t>(
+                  db.prepareStatement("SELECT SUM(Population) FROM City"))
+                .front());
+}
+
+TEST(TestingQuery, ComposeWithRangesAdaptors) {
+  CrudWrapper const db{kprojectRootPath + "/db/world.db"};
+
+  auto bigDutchCities{
+      db.query("SELECT Name, Population FROM City WHERE CountryCode = ? "
+               "ORDER BY Population DESC",
+               "NLD") |
+      std::views::filter([](sql_with_cpp::RowView const &row) {
+        return row.get<std::int64_t>(1U) > 400000;
+      }) |
+      std::views::transform([](sql_with_cpp::RowView const &row) {
+        return row.get<std::string>(0U);
+      })};
+
+  std::vector<std::string> names;
+  std::ranges::copy(bigDutchCities, std::back_inserter(names));
+
+  EXPECT_EQ(names,
+            (std::vector<std::string>{"Amsterdam", "Rotterdam", "Haag"}));
+}
+
+TEST(TestingQuery, StopEarlyAndReadRowViews) {
+  CrudWrapper const db{kprojectRootPath + "/db/album.db"};
+
+  auto range{db.query(
+      db.prepareStatement("SELECT id, title, label FROM album ORDER BY id"))};
+  auto it{range.begin()};
+  ASSERT_NE(it, range.end());
+
+  auto const row{*it};
+  EXPECT_EQ(row.columnName(1U), "title");
+  EXPECT_EQ(row.text(1U), "Two Men with the Blues");
+  EXPECT_FALSE(row.isNull(2U));
+  EXPECT_EQ((row.as<std::tuple<int, std::string>>()),
+            (std::tuple<int, std::string>{1, "Two Men with the Blues"}));
+
+  ++it;
+  EXPECT_EQ((*it).get<int>(0U), 11);
+  EXPECT_FALSE(range.failed());
+}
+
+TEST(TestingQuery, QueryInvalidStatements) {
+  CrudWrapper const db{kprojectRootPath + "/db/album.db"};
+
+  auto invalidRange{db.query("SELECT * FROM nonExistingTable")};
+  EXPECT_EQ(invalidRange.begin(), invalidRange.end());
+  EXPECT_TRUE(invalidRange.failed());
+
+  auto badBindingRange{db.query("SELECT * FROM album WHERE id = ?", 1, 2)};
+  EXPECT_EQ(badBindingRange.begin(), badBindingRange.end());
+  EXPECT_EQ(badBindingRange.lastResultCode(), SQLITE_RANGE);
+}
+
+TEST(TestingBulkInsert, BulkInsertRowsInBatches) {
+  CrudWrapper db{kprojectRootPath + "/db/scratch.db"};
+  auto const newTableName{std::string{"bulkSale"}};
+
+  ASSERT_TRUE(db.executeStatements(std::format(
+      "DROP TABLE IF EXISTS {};"
+      "CREATE TABLE {} (id INTEGER PRIMARY KEY, item_id INTEGER, "
+      "date TEXT, price REAL);",
+      newTableName, newTableName)));
+
+  using SaleRow = std::tuple<std::int64_t, std::int64_t, std::string, double>;
+  std::vector<SaleRow> rows;
+  for (std::int64_t i{1}; i <= 2500; ++i) {
+    rows.emplace_back(i, i % 7, "2009-02-28", static_cast<double>(i) / 4.0);
+  }
+
+  EXPECT_TRUE(db.bulkInsert(newTableName, {"id", "item_id", "date", "price"},
+                            rows, 1000U));
+  EXPECT_EQ(db.getRowsAs<SaleRow>(newTableName), rows);
+
+  // filling all the columns without naming them
+  EXPECT_TRUE(db.bulkInsert(
+      newTableName, {},
+      std::vector{SaleRow{3000, 1, "2009-03-01", 29.95}}));
+  EXPECT_EQ(db.getRowsAs<SaleRow>(newTableName).back(),
+            (SaleRow{3000, 1, "2009-03-01", 29.95}));
+
+  EXPECT_TRUE(
+      db.executeStatements(std::format("DROP TABLE {};", newTableName)));
+}
+
+TEST(TestingBulkInsert, FailingBatchIsRolledBack) {
+  CrudWrapper db{kprojectRootPath + "/db/scratch.db"};
+  auto const newTableName{std::string{"bulkItem"}};
+
+  ASSERT_TRUE(db.executeStatements(
+      std::format("DROP TABLE IF EXISTS {};"
+                  "CREATE TABLE {} (id INTEGER PRIMARY KEY, name TEXT);",
+                  newTableName, newTableName)));
+
+  // the duplicate id fails the second batch, while the first one is kept
+  using ItemRow = std::pair<int, std::string_view>;
+  auto const rows{std::vector<ItemRow>{
+      {1, "first"}, {2, "second"}, {3, "third"}, {3, "duplicate"}}};
+  EXPECT_FALSE(db.bulkInsert(newTableName, {"id", "name"}, rows, 2U));
+  EXPECT_EQ(db.getRowsAs<int>(newTableName), (std::vector<int>{1, 2}));
+
+  // mismatching columns and rows
+  EXPECT_FALSE(db.bulkInsert(newTableName, {"id"}, rows));
+  EXPECT_FALSE(db.bulkInsert("nonExistingTable", {"id", "name"}, rows));
+
+  // rows inserted in an already open transaction are left to its owner
+  ASSERT_TRUE(db.executeStatements("BEGIN;"));
+  EXPECT_TRUE(db.bulkInsert(newTableName, {"id", "name"},
+                            std::vector<ItemRow>{{10, "tenth"}}, 1U));
+  ASSERT_TRUE(db.executeStatements("ROLLBACK;"));
+  EXPECT_EQ(db.getRowsAs<int>(newTableName), (std::vector<int>{1, 2}));
+
+  EXPECT_TRUE(
+      db.executeStatements(std::format("DROP TABLE {};", newTableName)));
+}
+
+TEST(TestingOptions, DefaultOptionsKeepSqliteDefaults) {
+  CrudWrapper const db{copyDatabase("album.db", ktempPrefix),
+                       CrudWrapperOptions{}};
+  auto const settings{db.effectiveSettings()};
+
+  EXPECT_EQ(settings.journalMode, JournalMode::Delete);
+  EXPECT_EQ(settings.synchronous, SynchronousLevel::Full);
+  EXPECT_EQ(settings.tempStore, TempStore::Default);
+  EXPECT_TRUE(settings.cacheSize.has_value());
+  EXPECT_TRUE(settings.mmapSize.has_value());
+}
+
+TEST(TestingOptions, TuningProfilesAreApplied) {
+  for (auto const profile : {TuningProfile::ReadHeavy, TuningProfile::BulkLoad,
+                             TuningProfile::Durable}) {
+    auto const options{CrudWrapperOptions::forProfile(profile)};
+    CrudWrapper const db{copyDatabase("world.db", ktempPrefix), options};
+    auto const settings{db.effectiveSettings()};
+
+    EXPECT_EQ(settings.journalMode, options.pragmas.journalMode);
+    EXPECT_EQ(settings.synchronous, options.pragmas.synchronous);
+    if (options.pragmas.cacheSize.has_value()) {
+      EXPECT_EQ(settings.cacheSize, options.pragmas.cacheSize);
+    }
+    if (options.pragmas.mmapSize.has_value()) {
+      EXPECT_EQ(settings.mmapSize, options.pragmas.mmapSize);
+    }
+    if (options.pragmas.tempStore.has_value()) {
+      EXPECT_EQ(settings.tempStore, options.pragmas.tempStore);
+    }
+
+    EXPECT_EQ(db.getRows("City").size(), 4080U);
+  }
+}
+
+TEST(TestingOptions, FailingPragmasAreReported) {
+  auto const dbPath{copyDatabase("album.db", ktempPrefix)};
+  auto const options{CrudWrapperOptions::forProfile(TuningProfile::Durable)};
+
+  // the journal mode can't change while another connection holds a lock
+  CrudWrapper locker{dbPath};
+  ASSERT_TRUE(locker.executeStatements("BEGIN EXCLUSIVE;"));
+  EXPECT_THROW(CrudWrapper(dbPath, options), std::runtime_error);
+  ASSERT_TRUE(locker.executeStatements("COMMIT;"));
+
+  CrudWrapper const db{dbPath, options};
+  EXPECT_EQ(db.effectiveSettings().journalMode, JournalMode::Wal);
+  EXPECT_EQ(db.effectiveSettings().synchronous, SynchronousLevel::Full);
+}
+
+TEST(TestingOptions, OpenFlagsAndStatementCacheCapacity) {
+  CrudWrapperOptions options{.openFlags = SQLITE_OPEN_READONLY,
+                             .pragmas = {},
+                             .statementCacheCapacity = 2U,
+                             .mirror = std::nullopt,
+                             .busyPolicy = std::nullopt};
+  CrudWrapper db{kprojectRootPath + "/db/album.db", options};
+
+  EXPECT_EQ(db.statementCacheStats().capacity, 2U);
+  auto const rowsBefore{db.getRows("album")};
+  EXPECT_FALSE(db.executeStatements("DELETE FROM album;"));
+  EXPECT_EQ(db.getRows("album"), rowsBefore);
+}
+
+TEST(TestingOptions, ParseProfilesAndJournalModesNames) {
+  EXPECT_EQ(parseTuningProfile("read-heavy"), TuningProfile::ReadHeavy);
+  EXPECT_EQ(parseTuningProfile("bulk-load"), TuningProfile::BulkLoad);
+  EXPECT_EQ(parseTuningProfile("durable"), TuningProfile::Durable);
+  EXPECT_EQ(parseTuningProfile("unknown"), std::nullopt);
+  EXPECT_EQ(toString(TuningProfile::ReadHeavy), "read-heavy");
+
+  EXPECT_EQ(parseJournalMode("WAL"), JournalMode::Wal);
+  EXPECT_EQ(parseJournalMode("delete"), JournalMode::Delete);
+  EXPECT_EQ(parseJournalMode("walrus"), std::nullopt);
+  EXPECT_EQ(toString(JournalMode::Memory), "memory");
+}
+
+TEST(TestingProfiler, NormalizeStatementsText) {
+  EXPECT_EQ(normalizeSql("SELECT *   FROM City\n WHERE ID = 42 "),
+            "SELECT * FROM City WHERE ID = ?");
+  EXPECT_EQ(normalizeSql("SELECT Name FROM City WHERE Name = 'O''Hara' AND "
+                         "Population > 1.5e+3"),
+            "SELECT Name FROM City WHERE Name = ? AND Population > ?");
+  EXPECT_EQ(normalizeSql("SELECT col2 FROM t2 WHERE x = ?1"),
+            "SELECT col2 FROM t2 WHERE x = ?1");
+}
+
+TEST(TestingProfiler, LatencyPercentilesAreEstimated) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.percentile(0.5), std::chrono::nanoseconds{0});
+
+  for (std::int64_t latency{1}; latency <= 1000; ++latency) {
+    histogram.record(std::chrono::microseconds{latency});
+  }
+
+  EXPECT_EQ(histogram.count(), 1000U);
+  auto const p50{std::chrono::duration<double, std::micro>{
+      histogram.percentile(0.5)}};
+  auto const p99{std::chrono::duration<double, std::micro>{
+      histogram.percentile(0.99)}};
+  EXPECT_GE(p50.count(), 500.0);
+  EXPECT_LE(p50.count(), 500.0 * 1.25);
+  EXPECT_GE(p99.count(), 990.0);
+  EXPECT_LE(p99.count(), 990.0 * 1.25);
+}
+
+TEST(TestingProfiler, ProfileReadsPreparationsAndExecutions) {
+  CrudWrapper db{copyDatabase("world.db", ktempPrefix)};
+  auto const profiler{std::make_shared<StatementProfiler>()};
+  db.setProfiler(profiler);
+  EXPECT_EQ(db.profiler(), profiler);
+
+  EXPECT_EQ(db.getRows("City").size(), 4080U);
+  EXPECT_EQ(db.getRows("City").size(), 4080U);
+  for (auto const id : {1, 2, 3}) {
+    EXPECT_EQ(db.getRowsAs<std::string>(db.prepareStatement(std::format(
+                  "SELECT Name FROM City WHERE ID = {}", id)))
+                  .size(),
+              1U);
+  }
+  EXPECT_TRUE(db.executeStatements(
+      "UPDATE City SET Population = Population + 1 WHERE ID = 1;"));
+
+  auto const profiles{profiler->snapshot()};
+  auto const profileOf{[&profiles](std::string_view sql) {
+    return std::ranges::find(profiles, sql, &StatementProfile::sql);
+  }};
+
+  auto const scan{profileOf("SELECT * FROM City")};
+  ASSERT_NE(scan, profiles.end());
+  EXPECT_EQ(scan->calls, 2U);
+  EXPECT_EQ(scan->rowsCount, 2U * 4079U);
+  EXPECT_EQ(scan->prepares, 1U);
+  EXPECT_GT(scan->counters.fullScanSteps, 0);
+  EXPECT_GT(scan->counters.vmSteps, 0);
+  EXPECT_GT(scan->totalTime, std::chrono::nanoseconds{0});
+  EXPECT_LE(scan->p50Time, scan->p99Time);
+
+  auto const lookup{profileOf("SELECT Name FROM City WHERE ID = ?")};
+  ASSERT_NE(lookup, profiles.end());
+  EXPECT_EQ(lookup->calls, 3U);
+  EXPECT_EQ(lookup->rowsCount, 3U);
+  EXPECT_EQ(lookup->prepares, 3U);
+  EXPECT_EQ(lookup->counters.fullScanSteps, 0);
+
+  auto const update{
+      profileOf("UPDATE City SET Population = Population + ? WHERE ID = ?;")};
+  ASSERT_NE(update, profiles.end());
+  EXPECT_EQ(update->calls, 1U);
+
+  EXPECT_TRUE(std::ranges::is_sorted(profiles, std::ranges::greater{},
+                                     &StatementProfile::totalTime));
+
+  profiler->reset();
+  EXPECT_TRUE(profiler->snapshot().empty());
+
+  db.setProfiler(nullptr);
+  EXPECT_EQ(db.getRows("City").size(), 4080U);
+  EXPECT_TRUE(profiler->snapshot().empty());
+}
+
+TEST(TestingProfiler, SinkReceivesEachExecution) {
+  /// @brief a sink that keeps the received samples
+  struct CollectingSink : StatementSink {
+    void consume(StatementSample const &sample) noexcept override {
+      samples.emplace_back(std::string{sample.sql}, sample.rowsCount);
+    }
+
+    std::vector<std::pair<std::string, std::size_t>> samples;
+  };
+
+  auto const sink{std::make_shared<CollectingSink>()};
+  auto const profiler{std::make_shared<StatementProfiler>()};
+  profiler->setSink(sink);
+
+  CrudWrapper db{kprojectRootPath + "/db/album.db"};
+  db.setProfiler(profiler);
+  auto const rows{db.getRows("album")};
+
+  ASSERT_EQ(sink->samples.size(), 1U);
+  EXPECT_EQ(sink->samples.front(),
+            (std::pair<std::string, std::size_t>{"SELECT * FROM album",
+                                                 rows.size() - 1U}));
+
+  profiler->setSink(nullptr);
+  db.getRows("album");
+  EXPECT_EQ(sink->samples.size(), 1U);
+}
+
+TEST(TestingResultSet, ResultSetMatchesGetRows) {
+  CrudWrapper const db{kprojectRootPath + "/db/world.db"};
+
+  for (auto const *tableName : {"City", "CountryLanguage"}) {
+    auto const rows{db.getRows(tableName)};
+    auto const resultSet{db.getResultSet(tableName)};
+
+    ASSERT_EQ(resultSet.rowsCount(), rows.size() - 1U);
+    ASSERT_EQ(resultSet.columnsCount(), rows.front().size());
+    EXPECT_TRUE(std::ranges::equal(resultSet.columnsNames(), rows.front()));
+
+    std::size_t index{1U};
+    for (auto const row : resultSet.rows()) {
+      EXPECT_TRUE(std::ranges::equal(row, rows[index++]));
+    }
+  }
+
+  auto const resultSet{db.getResultSet("NonExistingTable")};
+  EXPECT_TRUE(resultSet.empty());
+  EXPECT_EQ(resultSet.columnsCount(), 0U);
+}
+
+TEST(TestingResultSet, NullAndEmptyCellsOfPreparedStatement) {
+  CrudWrapper const db{kprojectRootPath + "/db/world.db"};
+
+  auto statement{db.prepareStatement(
+      "SELECT Name, IndepYear, '' FROM Country WHERE Code IN (?, ?) "
+      "ORDER BY Code")};
+  ASSERT_TRUE(statement.bindAll("ABW", "NLD"));
+
+  auto const resultSet{db.getResultSet(statement)};
+  ASSERT_EQ(resultSet.rowsCount(), 2U);
+  EXPECT_EQ(resultSet[0][0], "Aruba");
+  EXPECT_TRUE(resultSet.isNull(0U, 1U));
+  EXPECT_FALSE(resultSet.isNull(0U, 2U));
+  EXPECT_EQ(resultSet[0][2], "");
+  EXPECT_EQ(resultSet[1][0], "Netherlands");
+  EXPECT_EQ(resultSet[1][1], "1581");
+  EXPECT_FALSE(resultSet.isNull(1U, 1U));
+}
+
+TEST(TestingResultSet, CellsKeepEmbeddedNulCharacters) {
+  CrudWrapper const db{kprojectRootPath + "/db/world.db"};
+
+  auto const resultSet{db.getResultSet(
+      db.prepareStatement("SELECT x'610062', 'a' || char(0) || 'b'"))};
+  ASSERT_EQ(resultSet.rowsCount(), 1U);
+  using namespace std::string_view_literals;
+  EXPECT_EQ(resultSet[0][0], "a\0b"sv);
+  EXPECT_EQ(resultSet[0][1], "a\0b"sv);
+}
+
+TEST(TestingResultSet, CellsAreStoredInTheSuppliedResource) {
+  CrudWrapper const db{kprojectRootPath + "/db/world.db"};
+
+  /// @brief a memory resource counting the allocations it forwards upstream
+  struct CountingResource : std::pmr::memory_resource {
+    std::size_t allocations{0U};
+
+    auto do_allocate(std::size_t bytes, std::size_t alignment)
+        -> void * override {
+      ++allocations;
+      return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *ptr, std::size_t bytes,
+                       std::size_t alignment) override {
+      std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+    }
+
+    auto do_is_equal(std::pmr::memory_resource const &other) const noexcept
+        -> bool override {
+      return this == &other;
+    }
+  };
+
+  CountingResource resource;
+  auto resultSet{db.getResultSet("City", &resource)};
+  ASSERT_EQ(resultSet.rowsCount(), 4079U);
+  EXPECT_GT(resultSet.storedBytes(), 4079U * 5U);
+
+  // far fewer allocations than the 4079 * 5 cells
+  EXPECT_GT(resource.allocations, 0U);
+  EXPECT_LT(resource.allocations, 100U);
+
+  // cells stay valid once the result set is moved
+  auto const firstCell{resultSet[0][1]};
+  auto const moved{std::move(resultSet)};
+  EXPECT_EQ(moved[0][1].data(), firstCell.data());
+  EXPECT_EQ(moved[0][1], "Kabul");
+}
+
+TEST(TestingColumns, ColumnTypesFollowDeclaredTypesAffinities) {
+  EXPECT_EQ(columnTypeOfDeclaredType("int(11)"), ColumnType::Integer);
+  EXPECT_EQ(columnTypeOfDeclaredType("BIGINT"), ColumnType::Integer);
+  EXPECT_EQ(columnTypeOfDeclaredType("char(35)"), ColumnType::Text);
+  EXPECT_EQ(columnTypeOfDeclaredType("Text"), ColumnType::Text);
+  EXPECT_EQ(columnTypeOfDeclaredType("float(10,2)"), ColumnType::Real);
+  EXPECT_EQ(columnTypeOfDeclaredType("DECIMAL"), ColumnType::Real);
+  EXPECT_EQ(columnTypeOfDeclaredType("blob"), std::nullopt);
+  EXPECT_EQ(columnTypeOfDeclaredType(""), std::nullopt);
+}
+
+TEST(TestingColumns, GetColumnsOfExistingTables) {
+  CrudWrapper const db{kprojectRootPath + "/db/world.db"};
+
+  auto const batch{db.getColumns(
+      "Country", {"Code", "Population", "LifeExpectancy", "IndepYear"})};
+  ASSERT_EQ(batch.columnsCount(), 4U);
+  ASSERT_EQ(batch.rowsCount(), 239U);
+
+  auto const &codes{batch.column(0U)};
+  EXPECT_EQ(codes.name(), "Code");
+  EXPECT_EQ(codes.type(), ColumnType::Text);
+  EXPECT_EQ(codes.text(0U), "AFG");
+  EXPECT_EQ(codes.offsets().size(), 240U);
+  EXPECT_EQ(codes.characters().size(), 239U * 3U);
+
+  auto const *population{batch.column("Population")};
+  ASSERT_NE(population, nullptr);
+  EXPECT_EQ(population->type(), ColumnType::Integer);
+  EXPECT_EQ(population->integers().size(), 239U);
+  EXPECT_TRUE(population->reals().empty());
+  EXPECT_EQ(std::accumulate(population->integers().begin(),
+                            population->integers().end(), std::int64_t{0}),
+            db.getRowsAs<std::int64_t>(
+                  db.prepareStatement("SELECT SUM(Population) FROM Country"))
+                .front());
+
+  auto const *lifeExpectancy{batch.column("LifeExpectancy")};
+  ASSERT_NE(lifeExpectancy, nullptr);
+  EXPECT_EQ(lifeExpectancy->type(), ColumnType::Real);
+  EXPECT_EQ(lifeExpectancy->nullCount(), 17U);
+  EXPECT_EQ(lifeExpectancy->validity().size(), 4U);
+
+  double sum{0.0};
+  std::size_t validCount{0U};
+  for (std::size_t i{0U}; i < lifeExpectancy->size(); ++i) {
+    if (!lifeExpectancy->isNull(i)) {
+      sum += lifeExpectancy->reals()[i];
+      ++validCount;
+    }
+  }
+  EXPECT_EQ(validCount, 222U);
+  EXPECT_DOUBLE_EQ(
+      sum / static_cast<double>(validCount),
+      db.getRowsAs<double>(
+            db.prepareStatement("SELECT AVG(LifeExpectancy) FROM Country"))
+          .front());
+
+  EXPECT_EQ(batch.column("NonExistingColumn"), nullptr);
+  EXPECT_EQ(db.getColumns("NonExistingTable").columnsCount(), 0U);
+}
+
+TEST(TestingColumns, GetColumnsOfExpressions) {
+  CrudWrapper const db{kprojectRootPath + "/db/world.db"};
+
+  auto const batch{db.getColumns(db.prepareStatement(
+      "SELECT CASE WHEN ID > 1 THEN ID * 2 END, ID / 2.0, NULL, * "
+      "FROM City WHERE ID <= 3 ORDER BY ID"))};
+  ASSERT_EQ(batch.columnsCount(), 8U);
+  ASSERT_EQ(batch.rowsCount(), 3U);
+
+  // leading NULLs are kept once the type is taken from the first value
+  EXPECT_EQ(batch.column(0U).type(), ColumnType::Integer);
+  EXPECT_TRUE(batch.column(0U).isNull(0U));
+  EXPECT_EQ(batch.column(0U).integers()[1], 4);
+  EXPECT_EQ(batch.column(0U).integers().size(), 3U);
+
+  EXPECT_EQ(batch.column(1U).type(), ColumnType::Real);
+  EXPECT_DOUBLE_EQ(batch.column(1U).reals()[2], 1.5);
+
+  EXPECT_EQ(batch.column(2U).type(), ColumnType::Integer);
+  EXPECT_EQ(batch.column(2U).nullCount(), 3U);
+  EXPECT_EQ(batch.column(2U).integers().size(), 3U);
+
+  EXPECT_EQ(batch.column("Name")->text(2U), "Herat");
+}
+
+TEST(TestingColumnKernels, AggregatesMatchSql) {
+  CrudWrapper const db{kprojectRootPath + "/db/world.db"};
+
+  auto const batch{db.getColumns("Country", {"Population", "LifeExpectancy"})};
+  auto const expectedPopulation{
+      db.getRowsAs<std::tuple<std::size_t, std::int64_t, std::int64_t,
+                              std::int64_t>>(db.prepareStatement(
+          "SELECT COUNT(Population), SUM(Population), MIN(Population), "
+          "MAX(Population) FROM Country"))};
+  auto const expectedLifeExpectancy{
+      db.getRowsAs<std::tuple<std::size_t, double, double, double, double>>(
+          db.prepareStatement(
+              "SELECT COUNT(LifeExpectancy), SUM(LifeExpectancy), "
+              "MIN(LifeExpectancy), MAX(LifeExpectancy), AVG(LifeExpectancy) "
+              "FROM Country"))};
+  ASSERT_EQ(expectedPopulation.size(), 1U);
+  ASSERT_EQ(expectedLifeExpectancy.size(), 1U);
+
+  for (auto const isa : {KernelIsa::Scalar, KernelIsa::Avx2}) {
+    auto const population{aggregate<std::int64_t>(batch.column(0U), isa)};
+    auto const [count, sum, min, max]{expectedPopulation.front()};
+    EXPECT_EQ(population.count, count);
+    EXPECT_EQ(population.sum, sum);
+    EXPECT_EQ(population.min, min);
+    EXPECT_EQ(population.max, max);
+
+    // NULL values are skipped, so the minimum is not the zero they hold
+    auto const lifeExpectancy{aggregate<double>(batch.column(1U), isa)};
+    auto const [realsCount, realsSum, realsMin, realsMax, realsMean]{
+        expectedLifeExpectancy.front()};
+    EXPECT_EQ(lifeExpectancy.count, realsCount);
+    EXPECT_NEAR(lifeExpectancy.sum, realsSum, 1e-9 * realsSum);
+    EXPECT_DOUBLE_EQ(lifeExpectancy.min, realsMin);
+    EXPECT_DOUBLE_EQ(lifeExpectancy.max, realsMax);
+    ASSERT_TRUE(lifeExpectancy.mean().has_value());
+    EXPECT_NEAR(*lifeExpectancy.mean(), realsMean, 1e-9 * realsMean);
+
+    // a column of another type has nothing to aggregate
+    EXPECT_EQ(aggregate<double>(batch.column(0U), isa).count, 0U);
+    EXPECT_FALSE(aggregate<double>(batch.column(0U), isa).mean().has_value());
+  }
+}
+
+TEST(TestingColumnKernels, FiltersProduceSelections) {
+  CrudWrapper const db{kprojectRootPath + "/db/world.db"};
+
+  auto const cities{db.getColumns("City", {"Population"})};
+  auto const &population{cities.column(0U)};
+  for (auto const comparison :
+       {Comparison::Equal, Comparison::NotEqual, Comparison::Less,
+        Comparison::LessEqual, Comparison::Greater, Comparison::GreaterEqual}) {
+    EXPECT_EQ(filter<std::int64_t>(population, comparison, 1'000'000,
+                                   KernelIsa::Scalar),
+              filter<std::int64_t>(population, comparison, 1'000'000,
+                                   KernelIsa::Avx2));
+  }
+
+  auto const largeCities{
+      filter<std::int64_t>(population, Comparison::Greater, 1'000'000)};
+  EXPECT_EQ(largeCities.size(),
+            db.getRowsAs<std::size_t>(
+                  db.prepareStatement(
+                      "SELECT COUNT(*) FROM City WHERE Population > 1000000"))
+                .front());
+  EXPECT_TRUE(std::ranges::is_sorted(largeCities));
+  EXPECT_EQ(
+      aggregate<std::int64_t>(population, largeCities).sum,
+      db.getRowsAs<std::int64_t>(
+            db.prepareStatement(
+                "SELECT SUM(Population) FROM City WHERE Population > 1000000"))
+          .front());
+
+  // NULL values never match, as in SQL
+  auto const countries{db.getColumns("Country", {"LifeExpectancy"})};
+  for (auto const isa : {KernelIsa::Scalar, KernelIsa::Avx2}) {
+    EXPECT_EQ(filter(countries.column(0U), Comparison::Less, 50.0, isa).size(),
+              db.getRowsAs<std::size_t>(
+                    db.prepareStatement("SELECT COUNT(*) FROM Country "
+                                        "WHERE LifeExpectancy < 50"))
+                  .front());
+    EXPECT_EQ(filter(countries.column(0U), Comparison::NotEqual, 0.0, isa)
+                  .size(),
+              countries.column(0U).size() - countries.column(0U).nullCount());
+  }
+  EXPECT_TRUE(filter<std::int64_t>(countries.column(0U), Comparison::Less, 50)
+                  .empty());
+}
+
+TEST(TestingColumnKernels, GroupByLowCardinalityKeys) {
+  CrudWrapper const db{kprojectRootPath + "/db/world.db"};
+
+  auto const batch{
+      db.getColumns("Country", {"Continent", "Population", "LifeExpectancy"})};
+  auto const populationGroups{
+      groupBy<std::int64_t>(batch.column(0U), batch.column(1U))};
+  auto const expectedPopulation{
+      db.getRowsAs<std::tuple<std::string, std::size_t, std::int64_t,
+                              std::int64_t>>(db.prepareStatement(
+          "SELECT Continent, COUNT(Population), SUM(Population), "
+          "MAX(Population) FROM Country GROUP BY Continent"))};
+  ASSERT_EQ(populationGroups.size(), expectedPopulation.size());
+
+  for (auto const &[continent, count, sum, max] : expectedPopulation) {
+    auto const group{std::ranges::find(populationGroups, continent,
+                                       &Group<std::int64_t>::key)};
+    ASSERT_NE(group, populationGroups.end());
+    EXPECT_EQ(group->aggregates.count, count);
+    EXPECT_EQ(group->aggregates.sum, sum);
+    if (count > 0U) {
+      EXPECT_EQ(group->aggregates.max, max);
+    }
+  }
+
+  // Antarctica has no life expectancy at all
+  auto const lifeExpectancyGroups{
+      groupBy<double>(batch.column(0U), batch.column(2U))};
+  auto const antarctica{std::ranges::find(lifeExpectancyGroups, "Antarctica",
+                                          &Group<double>::key)};
+  ASSERT_NE(antarctica, lifeExpectancyGroups.end());
+  EXPECT_EQ(antarctica->aggregates.count, 0U);
+  EXPECT_FALSE(antarctica->aggregates.mean().has_value());
+
+  EXPECT_TRUE(groupBy<double>(batch.column(0U), batch.column(1U)).empty());
+  EXPECT_TRUE(
+      groupBy<std::int64_t>(batch.column(1U), batch.column(1U)).empty());
+}
+
+TEST(TestingResultCache, RepeatedReadsHitTheCache) {
+  CrudWrapper db{copyDatabase("world.db", ktempPrefix)};
+  auto const expectedLanguages{db.getRows("CountryLanguage")};
+
+  db.setResultCacheBudget(16U * 1024U * 1024U);
+  EXPECT_EQ(db.getRows("CountryLanguage"), expectedLanguages);
+  EXPECT_EQ(db.getRows("CountryLanguage"), expectedLanguages);
+
+  auto const sharedRows{db.getCachedRows("CountryLanguage")};
+  EXPECT_EQ(sharedRows, db.getCachedRows("CountryLanguage"));
+  EXPECT_EQ(*sharedRows, expectedLanguages);
+
+  auto stats{db.resultCacheStats()};
+  EXPECT_EQ(stats.hits, 3U);
+  EXPECT_EQ(stats.misses, 1U);
+  EXPECT_EQ(stats.size, 1U);
+  EXPECT_GT(stats.bytes, 0U);
+
+  // bound values are part of the key
+  auto statement{db.prepareStatement("SELECT Name FROM City WHERE ID = ?")};
+  ASSERT_TRUE(statement.bind(1, 1U));
+  EXPECT_EQ(db.getRows(statement)[1U], std::vector<std::string>{"Kabul"});
+  ASSERT_TRUE(statement.bind(2, 1U));
+  EXPECT_EQ(db.getRows(statement)[1U], std::vector<std::string>{"Qandahar"});
+  ASSERT_TRUE(statement.bind(1, 1U));
+  EXPECT_EQ(db.getRows(statement)[1U], std::vector<std::string>{"Kabul"});
+
+  stats = db.resultCacheStats();
+  EXPECT_EQ(stats.hits, 4U);
+  EXPECT_EQ(stats.misses, 3U);
+  EXPECT_EQ(stats.size, 3U);
+
+  db.setResultCacheBudget(0U);
+  EXPECT_EQ(db.resultCacheStats().size, 0U);
+  EXPECT_EQ(db.getRows("CountryLanguage"), expectedLanguages);
+  EXPECT_EQ(db.resultCacheStats().hits, 0U);
+}
+
+TEST(TestingResultCache, ChangesInvalidateTheirTablesOnly) {
+  CrudWrapper db{copyDatabase("world.db", ktempPrefix)};
+  db.setResultCacheBudget(16U * 1024U * 1024U);
+
+  auto const languagesCount{db.getRows("CountryLanguage").size()};
+  auto const citiesCount{db.getRows("City").size()};
+  auto const capitals{db.getRows(db.prepareStatement(
+      "SELECT Country.Name, City.Name FROM Country "
+      "JOIN City ON City.ID = Country.Capital"))};
+
+  ASSERT_TRUE(db.executeStatements(
+      "INSERT INTO City (ID, Name, CountryCode, District, Population) "
+      "VALUES (5000, 'Cached City', 'NLD', 'Cache', 1);"));
+  EXPECT_EQ(db.resultCacheStats().size, 1U);
+  EXPECT_EQ(db.resultCacheStats().invalidations, 2U);
+  EXPECT_EQ(db.getRows("City").size(), citiesCount + 1U);
+  EXPECT_EQ(db.getRows("CountryLanguage").size(), languagesCount);
+  EXPECT_EQ(db.resultCacheStats().hits, 1U);
+
+  // changes rolled back are not kept in the cache
+  ASSERT_TRUE(db.executeStatements(
+      "BEGIN; DELETE FROM CountryLanguage WHERE Language = 'Dutch';"));
+  EXPECT_EQ(db.getRows("CountryLanguage").size(), languagesCount - 5U);
+  ASSERT_TRUE(db.executeStatements("ROLLBACK;"));
+  EXPECT_EQ(db.getRows("CountryLanguage").size(), languagesCount);
+
+  // deleting all rows skips the update hook
+  EXPECT_EQ(db.getRows("City").size(), citiesCount + 1U);
+  ASSERT_TRUE(db.executeStatements("DELETE FROM City;"));
+  EXPECT_EQ(db.getRows("City").size(), 1U);
+
+  // schema changes drop everything
+  ASSERT_TRUE(db.executeStatements("DROP TABLE City;"));
+  EXPECT_EQ(db.resultCacheStats().size, 0U);
+  EXPECT_EQ(capitals.size(), 233U);
+}
+
+TEST(TestingResultCache, TempSchemaChangesDropEverything) {
+  CrudWrapper db{makeEmptyDatabase("temp-result-cache.db")};
+  db.setResultCacheBudget(1U << 20U);
+  ASSERT_TRUE(db.executeStatements(
+      "CREATE TABLE t (a); INSERT INTO t VALUES (1), (2);"));
+  ASSERT_EQ(db.getRows("t").size(), 3U);
+  ASSERT_EQ(db.getRows("t").size(), 3U);
+  ASSERT_EQ(db.resultCacheStats().hits, 1U);
+
+  // creating a TEMP table changes no rows, yet shadows the cached table
+  ASSERT_TRUE(db.executeStatements("CREATE TEMP TABLE t (a);"));
+  EXPECT_EQ(db.resultCacheStats().size, 0U);
+  EXPECT_EQ(db.getRows("t").size(), 1U);
+}
+
+TEST(TestingResultCache, ChangesOfOtherConnectionsInvalidateEverything) {
+  auto const path{copyDatabase("world.db", ktempPrefix)};
+  CrudWrapper reader{path};
+  CrudWrapper writer{path};
+  reader.setResultCacheBudget(16U * 1024U * 1024U);
+
+  auto const languagesCount{reader.getRows("CountryLanguage").size()};
+  EXPECT_EQ(reader.getRows("CountryLanguage").size(), languagesCount);
+  ASSERT_TRUE(writer.executeStatements(
+      "DELETE FROM CountryLanguage WHERE Language = 'Dutch';"));
+  EXPECT_EQ(reader.getRows("CountryLanguage").size(), languagesCount - 5U);
+  EXPECT_EQ(reader.resultCacheStats().hits, 1U);
+}
+
+TEST(TestingResultCache, BudgetAndVolatileStatements) {
+  CrudWrapper db{copyDatabase("world.db", ktempPrefix)};
+  db.setResultCacheBudget(16U * 1024U * 1024U);
+
+  db.getRows(db.prepareStatement("SELECT random()"));
+  db.getRows(db.prepareStatement("SELECT datetime('now')"));
+  db.getRows(db.prepareStatement("PRAGMA page_count"));
+  EXPECT_EQ(db.resultCacheStats().size, 0U);
+
+  ASSERT_TRUE(db.executeStatements("CREATE VIEW Dutch AS "
+                                   "SELECT Name FROM City "
+                                   "WHERE CountryCode = 'NLD';"));
+  auto const dutchCount{db.getRows("Dutch").size()};
+  EXPECT_EQ(db.resultCacheStats().size, 1U);
+  ASSERT_TRUE(db.executeStatements(
+      "UPDATE City SET CountryCode = 'BEL' WHERE Name = 'Amsterdam';"));
+  EXPECT_EQ(db.resultCacheStats().size, 0U);
+  EXPECT_EQ(db.getRows("Dutch").size(), dutchCount - 1U);
+
+  // rows larger than the whole budget are not cached
+  db.setResultCacheBudget(0U);
+  db.setResultCacheBudget(16U * 1024U * 1024U);
+  db.getRows(db.prepareStatement("SELECT Name FROM City"));
+  db.setResultCacheBudget(db.resultCacheStats().bytes);
+  EXPECT_EQ(db.resultCacheStats().size, 1U);
+  db.getRows("City");
+  EXPECT_EQ(db.resultCacheStats().size, 1U);
+  EXPECT_EQ(db.resultCacheStats().evictions, 0U);
+  db.getRows(db.prepareStatement("SELECT Code FROM Country"));
+  EXPECT_EQ(db.resultCacheStats().size, 1U);
+  EXPECT_EQ(db.resultCacheStats().evictions, 1U);
+}
+
+TEST(TestingSchemaCatalog, TableInfoOfExistingTables) {
+  CrudWrapper const db{kprojectRootPath + "/db/world.db"};
+
+  auto const city{db.tableInfo("city")};
+  ASSERT_NE(city, nullptr);
+  EXPECT_EQ(city->name, "City");
+  EXPECT_EQ(city->type, "table");
+  EXPECT_FALSE(city->withoutRowid);
+  EXPECT_EQ(city->columnsNames,
+            (std::vector<std::string>{"ID", "Name", "CountryCode", "District",
+                                      "Population"}));
+  EXPECT_EQ(city->primaryKey(), std::vector<std::string>{"ID"});
+  EXPECT_TRUE(city->indexes.empty());
+
+  auto const *population{city->column("population")};
+  ASSERT_NE(population, nullptr);
+  EXPECT_EQ(population->declaredType, "INTEGER");
+  EXPECT_TRUE(population->notNull);
+  EXPECT_EQ(population->defaultValue, "'0'");
+  EXPECT_EQ(population->primaryKeyPosition, 0U);
+  EXPECT_EQ(city->column("NonExistingColumn"), nullptr);
+
+  auto const languages{db.tableInfo("CountryLanguage")};
+  ASSERT_NE(languages, nullptr);
+  EXPECT_EQ(languages->primaryKey(),
+            (std::vector<std::string>{"CountryCode", "Language"}));
+  ASSERT_EQ(languages->indexes.size(), 1U);
+  EXPECT_TRUE(languages->indexes.front().unique);
+  EXPECT_EQ(languages->indexes.front().origin, "pk");
+  EXPECT_EQ(languages->indexes.front().columnsNames,
+            (std::vector<std::string>{"CountryCode", "Language"}));
+
+  auto const country{db.tableInfo("Country")};
+  ASSERT_NE(country, nullptr);
+  EXPECT_EQ(country->column("LifeExpectancy")->defaultValue, "NULL");
+  EXPECT_FALSE(country->column("LifeExpectancy")->notNull);
+
+  EXPECT_EQ(db.tableInfo("NonExistingTable"), nullptr);
+}
+
+TEST(TestingSchemaCatalog, MetadataIsLoadedOncePerSchemaVersion) {
+  auto const path{copyDatabase("world.db", ktempPrefix)};
+  CrudWrapper db{path};
+
+  auto const city{db.tableInfo("City")};
+  EXPECT_EQ(db.tableInfo("City"), city);
+  EXPECT_EQ(db.peekColumnsNames("City"), city->columnsNames);
+
+  // qualified names are not tables, so they are peeked through a SELECT
+  EXPECT_EQ(db.peekColumnsNames("main.City"), city->columnsNames);
+
+  ASSERT_TRUE(db.executeStatements(
+      "CREATE INDEX CityByCountry ON City (CountryCode, lower(Name));"
+      "ALTER TABLE City ADD COLUMN Mayor TEXT;"));
+  auto const alteredCity{db.tableInfo("City")};
+  ASSERT_NE(alteredCity, city);
+  EXPECT_EQ(alteredCity->columnsNames.back(), "Mayor");
+  ASSERT_EQ(alteredCity->indexes.size(), 1U);
+  EXPECT_EQ(alteredCity->indexes.front().origin, "c");
+  EXPECT_EQ(alteredCity->indexes.front().columnsNames,
+            (std::vector<std::string>{"CountryCode", ""}));
+
+  // metadata held before the change stays valid
+  EXPECT_EQ(city->columnsNames.size(), 5U);
+
+  // schema changes of other connections are noticed too
+  CrudWrapper other{path};
+  ASSERT_TRUE(other.executeStatements(
+      "CREATE VIEW Capitals AS SELECT Country.Name AS Country, City.Name "
+      "FROM Country JOIN City ON City.ID = Country.Capital;"));
+  auto const capitals{db.tableInfo("Capitals")};
+  ASSERT_NE(capitals, nullptr);
+  EXPECT_EQ(capitals->type, "view");
+  EXPECT_EQ(db.peekColumnsNames("Capitals"),
+            (std::vector<std::string>{"Country", "Name"}));
+
+  // TEMP tables shadow tables of the same name
+  ASSERT_TRUE(db.executeStatements("CREATE TEMP TABLE City (Shadow INT);"));
+  EXPECT_EQ(db.peekColumnsNames("City"), std::vector<std::string>{"Shadow"});
+}
+
+TEST(TestingSchemaCatalog, TempSchemaChangesAreNoticed) {
+  CrudWrapper db{makeEmptyDatabase("temp-schema.db")};
+  ASSERT_TRUE(db.executeStatements("CREATE TABLE t (a, b);"));
+  EXPECT_EQ(db.peekColumnsNames("t"), (std::vector<std::string>{"a", "b"}));
+
+  // TEMP tables shadow main tables without changing the main schema
+  ASSERT_TRUE(db.executeStatements("CREATE TEMP TABLE t (x, y, z);"));
+  EXPECT_EQ(db.peekColumnsNames("t"),
+            (std::vector<std::string>{"x", "y", "z"}));
+  EXPECT_EQ(db.getRows("t").front().size(), 3U);
+
+  ASSERT_TRUE(db.executeStatements("DROP TABLE temp.t;"));
+  EXPECT_EQ(db.peekColumnsNames("t"), (std::vector<std::string>{"a", "b"}));
+  EXPECT_EQ(db.getRows("t").front().size(), 2U);
+}
+
+TEST(TestingScriptLoader, SeedScriptsLoadLikeThroughExecuteStatements) {
+  using Count_type = std::int64_t;
+
+  for (std::string const dbName : {"world", "album", "scratch"}) {
+    auto const scriptPath{kprojectRootPath + "/sql/" + dbName +
+                          "-sqlite3.sql"};
+    CrudWrapper loaded{makeEmptyDatabase(dbName + "-loaded.db")};
+    auto const result{loaded.executeScript(scriptPath)};
+    ASSERT_TRUE(result) << dbName << ": " << result.errorMessage;
+    EXPECT_GT(result.reboundRowsCount, 0U);
+
+    std::stringstream script;
+    script << std::ifstream{scriptPath}.rdbuf();
+    auto const executedPath{makeEmptyDatabase(dbName + "-executed.db")};
+    ASSERT_TRUE(CrudWrapper{executedPath}.executeStatements(script.str()));
+
+    ASSERT_TRUE(loaded.executeStatements("ATTACH '" + executedPath.string() +
+                                         "' AS executed;"));
+    auto const tablesNames{loaded.getRowsAs<std::string>(
+        loaded.prepareStatement("SELECT name FROM main.sqlite_schema "
+                                "WHERE type = 'table' ORDER BY name"))};
+    EXPECT_EQ(tablesNames,
+              loaded.getRowsAs<std::string>(loaded.prepareStatement(
+                  "SELECT name FROM executed.sqlite_schema "
+                  "WHERE type = 'table' ORDER BY name")));
+
+    for (auto const &tableName : tablesNames) {
+      auto const countMissing{[&tableName](std::string_view from,
+                                           std::string_view in) {
+        return std::format("SELECT count(*) FROM (SELECT * FROM {}.{} "
+                           "EXCEPT SELECT * FROM {}.{})",
+                           from, tableName, in, tableName);
+      }};
+      auto const differences{loaded.getRowsAs<Count_type>(
+          loaded.prepareStatement(countMissing("main", "executed") +
+                                  " UNION ALL " +
+                                  countMissing("executed", "main")))};
+      EXPECT_EQ(differences, (std::vector<Count_type>{0, 0}))
+          << dbName << '.' << tableName;
+    }
+  }
+
+  CrudWrapper world{kprojectRootPath + "/db/world.db"};
+  CrudWrapper loadedWorld{std::filesystem::temp_directory_path() /
+                          "crud-wrapper-test-world-loaded.db"};
+  for (auto const *tableName : {"City", "Country", "CountryLanguage"}) {
+    auto const countStatement{std::format("SELECT count(*) FROM {}",
+                                          tableName)};
+    EXPECT_EQ(
+        loadedWorld.getRowsAs<Count_type>(
+            loadedWorld.prepareStatement(countStatement)),
+        world.getRowsAs<Count_type>(world.prepareStatement(countStatement)));
+  }
+}
+
+TEST(TestingScriptLoader, LiteralsAreBoundAsSqliteReadsThem) {
+  auto const scriptPath{writeScript("literals.sql", R"sql(
+    /* a table of every kind of literal */
+    CREATE TABLE Literal (Id INTEGER PRIMARY KEY, Value);
+    BEGIN;
+    INSERT INTO Literal VALUES (1, 42), (2, -7), (3, +3);
+    insert into "Literal" (Value, Id) values ('it''s', 4);
+    INSERT INTO main.Literal VALUES (5, 1.5e3), (6, -.25), (7, NULL);
+    INSERT INTO Literal VALUES (8, 'semicolon; and -- dashes');
+    INSERT INTO Literal VALUES (9, 9223372036854775807);
+    INSERT INTO Literal VALUES (10, 1 + 1);
+    INSERT INTO Literal VALUES (11, 0x10);
+    INSERT INTO Literal VALUES (12, 99999999999999999999);
+    CREATE TRIGGER Doubled AFTER INSERT ON Literal WHEN new.Id = 13
+    BEGIN
+      INSERT INTO Literal VALUES (14, new.Value * 2);
+    END;
+    -- the last statement needs no semicolon
+    INSERT INTO Literal VALUES (13, 21)
+  )sql")};
+
+  CrudWrapper db{makeEmptyDatabase("literals.db")};
+  std::vector<ScriptProgress> reports;
+  auto const result{db.executeScript(
+      scriptPath,
+      ScriptOptions{.onProgress =
+                        [&reports](ScriptProgress const &progress) {
+                          reports.push_back(progress);
+                        },
+                    .progressInterval = 4U})};
+  ASSERT_TRUE(result) << result.errorMessage;
+  EXPECT_EQ(result.statementsCount, 11U);
+  EXPECT_EQ(result.reboundRowsCount, 10U);
+
+  // every 4 statements, and once at the end
+  ASSERT_EQ(reports.size(), 3U);
+  EXPECT_EQ(reports[0].statementsCount, 4U);
+  EXPECT_EQ(reports[1].statementsCount, 8U);
+  EXPECT_LT(reports[1].bytesCount, reports[1].bytesTotal);
+  EXPECT_EQ(reports[2].statementsCount, 11U);
+  EXPECT_EQ(reports[2].bytesCount, reports[2].bytesTotal);
+  EXPECT_EQ(reports[2].bytesTotal, std::filesystem::file_size(scriptPath));
+
+  using Literal_type = std::tuple<std::int64_t, std::string, std::string>;
+  EXPECT_EQ(db.getRowsAs<Literal_type>(db.prepareStatement(
+                "SELECT Id, typeof(Value), coalesce(Value, 'NULL') "
+                "FROM Literal ORDER BY Id")),
+            (std::vector<Literal_type>{
+                {1, "integer", "42"},
+                {2, "integer", "-7"},
+                {3, "integer", "3"},
+                {4, "text", "it's"},
+                {5, "real", "1500.0"},
+                {6, "real", "-0.25"},
+                {7, "null", "NULL"},
+                {8, "text", "semicolon; and -- dashes"},
+                {9, "integer", "9223372036854775807"},
+                {10, "integer", "2"},
+                {11, "integer", "16"},
+                {12, "real", "1.0e+20"},
+                {13, "integer", "21"},
+                {14, "integer", "42"},
+            }));
+}
+
+TEST(TestingScriptLoader, FailuresRollTheWholeScriptBack) {
+  auto const scriptPath{writeScript("failing.sql",
+                                    "CREATE TABLE Once (Value UNIQUE);\n"
+                                    "INSERT INTO Once VALUES (1);\n"
+                                    "\n"
+                                    "INSERT INTO Once VALUES (1);\n")};
+  auto const path{makeEmptyDatabase("failing.db")};
+  CrudWrapper db{path};
+
+  auto const result{db.executeScript(scriptPath)};
+  EXPECT_FALSE(result);
+  EXPECT_EQ(result.statementsCount, 2U);
+  EXPECT_EQ(result.errorLine, 4U);
+  EXPECT_NE(result.errorMessage.find("UNIQUE"), std::string::npos);
+  EXPECT_EQ(db.tableInfo("Once"), nullptr);
+
+  // scripts run as part of the transaction of their caller, if any
+  ASSERT_TRUE(db.executeStatements("BEGIN;"));
+  ASSERT_TRUE(db.executeScript(
+      writeScript("passing.sql", "CREATE TABLE Passing (Value);")));
+  ASSERT_TRUE(db.executeStatements("ROLLBACK;"));
+  EXPECT_EQ(db.tableInfo("Passing"), nullptr);
+
+  auto const syntaxError{db.executeScript(writeScript(
+      "syntax.sql", "CREATE TABLE Valid (Value);\nCREATE TABLE (;"))};
+  EXPECT_FALSE(syntaxError);
+  EXPECT_EQ(syntaxError.errorLine, 2U);
+  EXPECT_EQ(db.tableInfo("Valid"), nullptr);
+
+  EXPECT_THROW(db.executeScript("/non/existing/script.sql"),
+               std::filesystem::filesystem_error);
+}
+
+
+TEST(TestingPagination, PagesCoverTablesInRowidOrder) {
+  CrudWrapper const db{kprojectRootPath + "/db/world.db"};
+  auto const allCities{db.getResultSet("City")};
+
+  std::vector<std::string> pagedIds;
+  std::size_t pagesCount{0U};
+  std::string token;
+  do {
+    auto const page{db.getPage("City", 1000U, token)};
+    ASSERT_EQ(page.rows.columnsNames().size(), 5U);
+    EXPECT_EQ(page.isLast(), page.rows.rowsCount() < 1000U);
+    for (auto const row : page.rows.rows()) {
+      pagedIds.emplace_back(row[0]);
+    }
+    token = page.continuationToken;
+    ++pagesCount;
+  } while (!token.empty());
+
+  EXPECT_EQ(pagesCount, 5U);
+  ASSERT_EQ(pagedIds.size(), allCities.rowsCount());
+  for (std::size_t i{0U}; i < pagedIds.size(); ++i) {
+    EXPECT_EQ(pagedIds[i], allCities[i][0]);
+  }
+
+  // pages filling the rest of the table exactly are known to be the last
+  auto const firstHalf{db.getPage("CountryLanguage", 492U)};
+  EXPECT_FALSE(firstHalf.isLast());
+  auto const secondHalf{
+      db.getPage("CountryLanguage", 492U, firstHalf.continuationToken)};
+  EXPECT_EQ(secondHalf.rows.rowsCount(), 492U);
+  EXPECT_TRUE(secondHalf.isLast());
+}
+
+TEST(TestingPagination, OrderingKeysWithTiesAndTypes) {
+  CrudWrapper db{copyDatabase("world.db", ktempPrefix)};
+
+  // percentages are shared by many languages, and the rowid breaks the ties
+  std::set<std::pair<std::string, std::string>> languages;
+  double lastPercentage{0.0};
+  std::string token;
+  do {
+    auto const page{
+        db.getPage("CountryLanguage", 100U, token, {"Percentage"})};
+    for (auto const row : page.rows.rows()) {
+      EXPECT_TRUE(languages.emplace(row[0], row[1]).second);
+      auto const percentage{std::stod(std::string{row[3]})};
+      EXPECT_LE(lastPercentage, percentage);
+      lastPercentage = percentage;
+    }
+    token = page.continuationToken;
+  } while (!token.empty());
+  EXPECT_EQ(languages.size(), 984U);
+
+  // texts keys are kept byte for byte, whatever characters they hold
+  ASSERT_TRUE(db.executeStatements(
+      "CREATE TABLE Tag (Name TEXT PRIMARY KEY, Weight REAL) WITHOUT ROWID;"
+      "INSERT INTO Tag VALUES ('a:b', 0.1), ('a;b', 0.2), ('b', 0.1), "
+      "('é', 1e-300), ('', 0.30000000000000004), ('c', 0.3);"
+      "CREATE VIEW Heavy AS SELECT Name FROM Tag WHERE Weight > 0.15;"));
+  auto const readAll{[&db](std::string const &tableName,
+                           std::vector<std::string> const &orderingKey) {
+    std::vector<std::string> names;
+    std::string pageToken;
+    do {
+      auto const page{db.getPage(tableName, 1U, pageToken, orderingKey)};
+      for (auto const row : page.rows.rows()) {
+        names.emplace_back(row[0]);
+      }
+      pageToken = page.continuationToken;
+    } while (!pageToken.empty());
+    return names;
+  }};
+  EXPECT_EQ(readAll("Tag", {}),
+            (std::vector<std::string>{"", "a:b", "a;b", "b", "c", "é"}));
+  EXPECT_EQ(readAll("Tag", {"Weight"}),
+            (std::vector<std::string>{"é", "a:b", "b", "a;b", "c", ""}));
+  EXPECT_EQ(readAll("Heavy", {"Name"}),
+            (std::vector<std::string>{"", "a;b", "c"}));
+
+  // views have no rowid to order by
+  EXPECT_EQ(db.getPage("Heavy", 2U).rows.rowsCount(), 0U);
+  EXPECT_EQ(db.getPage("NonExistingTable", 2U).rows.rowsCount(), 0U);
+  EXPECT_EQ(db.getPage("Tag", 0U).rows.rowsCount(), 0U);
+
+  // malformed tokens, or tokens of another ordering key, read nothing
+  auto const weightToken{
+      db.getPage("Tag", 2U, {}, {"Weight"}).continuationToken};
+  ASSERT_FALSE(weightToken.empty());
+  for (auto const &invalidToken :
+       {std::string{"0"}, std::string{"zz"}, std::string{"74393a61"},
+        weightToken.substr(2U), db.getPage("Tag", 2U).continuationToken}) {
+    auto const page{db.getPage("Tag", 2U, invalidToken, {"Weight"})};
+    EXPECT_EQ(page.rows.rowsCount(), 0U) << invalidToken;
+    EXPECT_TRUE(page.isLast());
+  }
+}
+
+TEST(TestingPagination, OrderingKeysWithNulls) {
+  CrudWrapper const db{kprojectRootPath + "/db/world.db"};
+  auto const independentCountries{db.getResultSet(db.prepareStatement(
+      "SELECT Code FROM Country WHERE IndepYear IS NOT NULL"))};
+  ASSERT_GT(independentCountries.rowsCount(), 10U);
+
+  // countries without an independence year are left out of every page
+  std::set<std::string> codes;
+  std::size_t pagesCount{0U};
+  std::string token;
+  do {
+    auto const page{db.getPage("Country", 10U, token, {"IndepYear"})};
+    for (auto const row : page.rows.rows()) {
+      EXPECT_TRUE(codes.emplace(row[0]).second);
+    }
+    token = page.continuationToken;
+    ++pagesCount;
+  } while (!token.empty());
+
+  EXPECT_EQ(codes.size(), independentCountries.rowsCount());
+  EXPECT_EQ(pagesCount, (codes.size() + 9U) / 10U);
+}
+
+TEST(TestingInMemoryMirror, ReadsAreServedFromMemory) {
+  auto const dbPath{copyDatabase("world.db", ktempPrefix)};
+  auto const citiesCount{[](CrudWrapper const &db) {
+    return db.getRowsAs<std::int64_t>(
+        db.prepareStatement("SELECT COUNT(*) FROM City"));
+  }};
+
+  {
+    CrudWrapper db{
+        dbPath, CrudWrapperOptions{.openFlags = CrudWrapper::kDefaultOpenFlags,
+                                   .pragmas = {},
+                                   .statementCacheCapacity = 8U,
+                                   .mirror = MirrorOptions{},
+                                   .busyPolicy = std::nullopt}};
+    auto const stats{db.mirrorStats()};
+    ASSERT_TRUE(stats.has_value());
+    EXPECT_GT(stats->loadTime.count(), 0);
+    EXPECT_GT(stats->pagesCount, 0U);
+    EXPECT_FALSE(stats->dirty);
+    EXPECT_EQ(db.effectiveSettings().journalMode, JournalMode::Memory);
+    EXPECT_EQ(db.getRows("City"),
+              CrudWrapper{kprojectRootPath + "/db/world.db"}.getRows("City"));
+
+    // changes stay in memory, and are dropped on close
+    EXPECT_TRUE(db.executeStatements("DELETE FROM City;"));
+    EXPECT_EQ(citiesCount(db), std::vector<std::int64_t>{0});
+    EXPECT_TRUE(db.mirrorStats()->dirty);
+  }
+  EXPECT_EQ(citiesCount(CrudWrapper{dbPath}),
+            std::vector<std::int64_t>{4079});
+  EXPECT_FALSE(CrudWrapper{dbPath}.mirrorStats().has_value());
+  EXPECT_FALSE(CrudWrapper{dbPath}.syncMirror());
+
+  // read-only mirrors can't be written, nor write back to the file
+  auto readOnly{CrudWrapperOptions{.openFlags = SQLITE_OPEN_READONLY,
+                                   .pragmas = {},
+                                   .statementCacheCapacity = 8U,
+                                   .mirror = MirrorOptions{},
+                                   .busyPolicy = std::nullopt}};
+  CrudWrapper readOnlyDb{dbPath, readOnly};
+  EXPECT_FALSE(readOnlyDb.executeStatements("DELETE FROM City;"));
+  readOnly.mirror->sync = MirrorSync::OnCommit;
+  EXPECT_THROW({ CrudWrapper(dbPath, readOnly); }, std::invalid_argument);
+}
+
+TEST(TestingInMemoryMirror, ChangesAreWrittenBackToTheFile) {
+  auto const dbPath{copyDatabase("world.db", ktempPrefix)};
+  auto const population{[&dbPath] {
+    CrudWrapper const file{dbPath};
+    return file.getRowsAs<std::int64_t>(
+        file.prepareStatement("SELECT Population FROM City WHERE ID = 1"));
+  }};
+  auto const mirrored{[](MirrorSync sync,
+                         std::chrono::milliseconds syncInterval) {
+    return CrudWrapperOptions{.openFlags = CrudWrapper::kDefaultOpenFlags,
+                              .pragmas = {},
+                              .statementCacheCapacity = 8U,
+                              .mirror = MirrorOptions{
+                                  .sync = sync, .syncInterval = syncInterval},
+                              .busyPolicy = std::nullopt};
+  }};
+
+  {
+    CrudWrapper db{dbPath, mirrored(MirrorSync::OnCommit, {})};
+    EXPECT_TRUE(db.executeStatements(
+        "UPDATE City SET Population = 1 WHERE ID = 1;"));
+    EXPECT_EQ(population(), std::vector<std::int64_t>{1});
+
+    // open transactions are written back once committed
+    EXPECT_TRUE(db.executeStatements(
+        "BEGIN; UPDATE City SET Population = 2 WHERE ID = 1;"));
+    EXPECT_TRUE(db.syncMirror());
+    EXPECT_EQ(population(), std::vector<std::int64_t>{1});
+    EXPECT_TRUE(db.executeStatements("COMMIT;"));
+    EXPECT_EQ(population(), std::vector<std::int64_t>{2});
+
+    EXPECT_TRUE(db.bulkInsert(
+        "City", {"ID", "Name", "CountryCode", "District", "Population"},
+        std::vector{std::tuple{5000, "Mirror", "NLD", "Memory", 3}}));
+    EXPECT_EQ(db.mirrorStats()->syncsCount, 3U);
+    EXPECT_FALSE(db.mirrorStats()->dirty);
+  }
+
+  {
+    CrudWrapper db{dbPath,
+                   mirrored(MirrorSync::Periodic, std::chrono::hours{1})};
+    EXPECT_TRUE(db.executeStatements(
+        "UPDATE City SET Population = 4 WHERE ID = 1;"));
+    EXPECT_EQ(population(), std::vector<std::int64_t>{2});
+    EXPECT_TRUE(db.syncMirror());
+    EXPECT_EQ(population(), std::vector<std::int64_t>{4});
+
+    // pending changes are written back on close
+    EXPECT_TRUE(db.executeStatements(
+        "UPDATE City SET Population = 5 WHERE ID = 1;"));
+    EXPECT_EQ(population(), std::vector<std::int64_t>{4});
+  }
+  EXPECT_EQ(population(), std::vector<std::int64_t>{5});
+
+  CrudWrapper const file{dbPath};
+  EXPECT_EQ(file.getRowsAs<std::string>(
+                file.prepareStatement("SELECT Name FROM City WHERE ID = 5000")),
+            std::vector<std::string>{"Mirror"});
+}
+
+TEST(TestingTransactions, TransactionsEndOnCommitOrDestruction) {
+  CrudWrapper db{copyDatabase("scratch.db", ktempPrefix)};
+  auto const itemsIds{[&db] { return db.getRowsAs<int>("item"); }};
+  auto const initialIds{itemsIds()};
+
+  {
+    auto transaction{db.beginTransaction(TransactionMode::Immediate)};
+    EXPECT_TRUE(transaction.isActive());
+    EXPECT_FALSE(transaction.isNested());
+    EXPECT_TRUE(db.executeStatements(
+        "INSERT INTO item (id, name) VALUES (10, 'committed');"));
+    EXPECT_TRUE(transaction.commit());
+    EXPECT_FALSE(transaction.isActive());
+    EXPECT_FALSE(transaction.commit());
+    EXPECT_FALSE(transaction.rollback());
+  }
+  auto expectedIds{initialIds};
+  expectedIds.push_back(10);
+  EXPECT_EQ(itemsIds(), expectedIds);
+
+  // early exits roll back whatever was written
+  auto const throwingWrite{[&db] {
+    auto transaction{db.beginTransaction(TransactionMode::Exclusive)};
+    EXPECT_TRUE(db.executeStatements(
+        "INSERT INTO item (id, name) VALUES (11, 'thrown away');"));
+    throw std::runtime_error("early exit");
+  }};
+  EXPECT_THROW(throwingWrite(), std::runtime_error);
+  {
+    auto transaction{db.beginTransaction()};
+    EXPECT_TRUE(db.executeStatements(
+        "CREATE TABLE Dropped (id INTEGER);"
+        "INSERT INTO item (id, name) VALUES (12, 'dropped');"));
+    auto moved{std::move(transaction)};
+    EXPECT_FALSE(transaction.isActive());
+    EXPECT_TRUE(moved.isActive());
+  }
+  EXPECT_EQ(itemsIds(), expectedIds);
+  EXPECT_EQ(db.tableInfo("Dropped"), nullptr);
+}
+
+TEST(TestingTransactions, NestedTransactionsAreSavepoints) {
+  CrudWrapper db{copyDatabase("scratch.db", ktempPrefix)};
+  auto const itemsIds{[&db] { return db.getRowsAs<int>("item"); }};
+  auto expectedIds{itemsIds()};
+
+  {
+    auto outer{db.beginTransaction()};
+    EXPECT_TRUE(db.executeStatements(
+        "INSERT INTO item (id, name) VALUES (20, 'outer');"));
+    {
+      auto inner{db.beginTransaction(TransactionMode::Immediate)};
+      EXPECT_TRUE(inner.isNested());
+      EXPECT_TRUE(db.executeStatements(
+          "INSERT INTO item (id, name) VALUES (21, 'rolled back');"));
+      {
+        auto innermost{db.beginTransaction()};
+        EXPECT_TRUE(db.executeStatements(
+            "INSERT INTO item (id, name) VALUES (22, 'released');"));
+        EXPECT_TRUE(innermost.commit());
+      }
+      EXPECT_TRUE(inner.rollback());
+    }
+    {
+      auto inner{db.beginTransaction()};
+      EXPECT_TRUE(db.executeStatements(
+          "INSERT INTO item (id, name) VALUES (23, 'released');"));
+      EXPECT_TRUE(inner.commit());
+    }
+    EXPECT_TRUE(outer.commit());
+  }
+  expectedIds.insert(expectedIds.end(), {20, 23});
+  EXPECT_EQ(itemsIds(), expectedIds);
+
+  // transactions opened by statements get savepoints nested into them too
+  ASSERT_TRUE(db.executeStatements("BEGIN;"));
+  {
+    auto nested{db.beginTransaction()};
+    EXPECT_TRUE(nested.isNested());
+    EXPECT_TRUE(db.executeStatements(
+        "INSERT INTO item (id, name) VALUES (24, 'kept');"));
+    EXPECT_TRUE(nested.commit());
+  }
+  ASSERT_TRUE(db.executeStatements("COMMIT;"));
+  expectedIds.push_back(24);
+  EXPECT_EQ(itemsIds(), expectedIds);
+
+  // a failing batch of a bulk insert is rolled back to its savepoint, while
+  // earlier batches stay in the open transaction
+  using ItemRow = std::pair<int, std::string_view>;
+  auto const rows{std::vector<ItemRow>{
+      {30, "first"}, {31, "second"}, {32, "third"}, {32, "duplicate"}}};
+  {
+    auto transaction{db.beginTransaction()};
+    EXPECT_FALSE(db.bulkInsert("item", {"id", "name"}, rows, 2U));
+    EXPECT_TRUE(transaction.commit());
+  }
+  expectedIds.insert(expectedIds.end(), {30, 31});
+  EXPECT_EQ(itemsIds(), expectedIds);
+}
+
+TEST(TestingBusyPolicy, LocksAreWaitedForWithinTheMaximumWait) {
+  using namespace std::chrono_literals;
+  auto const dbPath{copyDatabase("world.db", ktempPrefix)};
+  auto const waitingFor{[](std::chrono::milliseconds maxWait) {
+    return CrudWrapperOptions{.openFlags = CrudWrapper::kDefaultOpenFlags,
+                              .pragmas = {},
+                              .statementCacheCapacity = 8U,
+                              .mirror = std::nullopt,
+                              .busyPolicy = BusyPolicy{.initialBackoff = 1ms,
+                                                       .maxBackoff = 10ms,
+                                                       .maxWait = maxWait,
+                                                       .readRetries = 3U}};
+  }};
+  auto const citiesCount{[](CrudWrapper const &db) {
+    return db.getRowsAs<std::int64_t>(
+        db.prepareStatement("SELECT COUNT(*) FROM City"));
+  }};
+
+  CrudWrapper writer{dbPath};
+  CrudWrapper impatientReader{dbPath, waitingFor(100ms)};
+  CrudWrapper patientReader{dbPath, waitingFor(10s)};
+  EXPECT_FALSE(writer.busyStats().has_value());
+  EXPECT_EQ(impatientReader.busyStats()->busyCount, 0U);
+
+  auto lazyCities{impatientReader.prepareStatement("SELECT Name FROM City")};
+
+  // an exclusive lock keeps readers out in rollback journal modes
+  ASSERT_TRUE(writer.executeStatements(
+      "PRAGMA journal_mode=DELETE; BEGIN EXCLUSIVE;"));
+  auto const startTime{std::chrono::steady_clock::now()};
+  EXPECT_TRUE(citiesCount(impatientReader).empty());
+  auto const elapsed{std::chrono::steady_clock::now() - startTime};
+  EXPECT_GE(elapsed, 100ms);
+  EXPECT_LT(elapsed, 1s);
+
+  auto const stats{*impatientReader.busyStats()};
+  EXPECT_GT(stats.busyCount, 1U);
+  EXPECT_EQ(stats.timeoutsCount, 1U);
+  EXPECT_EQ(stats.readRetriesCount, 0U);
+  EXPECT_GE(stats.totalWait, 90ms);
+
+  // lazy reads wait within the same policy
+  auto cities{impatientReader.query(std::move(lazyCities))};
+  EXPECT_TRUE(cities.begin() == cities.end());
+  EXPECT_EQ(cities.lastResultCode() & 0xFF, SQLITE_BUSY);
+  EXPECT_EQ(impatientReader.busyStats()->timeoutsCount, 2U);
+
+  // readers get in as soon as the lock is released
+  std::jthread releaser{[&writer] {
+    std::this_thread::sleep_for(50ms);
+    EXPECT_TRUE(writer.executeStatements("COMMIT;"));
+  }};
+  EXPECT_EQ(citiesCount(patientReader), std::vector<std::int64_t>{4079});
+  EXPECT_GT(patientReader.busyStats()->busyCount, 0U);
+  EXPECT_EQ(patientReader.busyStats()->timeoutsCount, 0U);
+  EXPECT_LT(patientReader.busyStats()->totalWait, 10s);
+}
+
 } // namespace sql_with_cpp_test::crudWrapper_test
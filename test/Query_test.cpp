@@ -0,0 +1,114 @@
+#include "crud-wrapper/CrudWrapper.hpp"
+#include "TestUtils.hpp"
+
+#include "gtest/gtest.h"
+#include <concepts>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+/// @brief anonymous namespace for needed constants in thus TU
+namespace {
+/// @brief prefix of the databases copied by the tests of this TU
+const std::string ktempPrefix{"crud-wrapper-query-test-"};
+
+} // namespace
+
+/// @brief namespace for Query tests
+namespace sql_with_cpp_test::query_test {
+using namespace ::sql_with_cpp;
+
+// placeholders are counted at compile time, skipping quotes and comments
+static_assert(detail::countPlaceholders("SELECT 1") == 0U);
+static_assert(detail::countPlaceholders("SELECT ?, ? FROM t WHERE a = ?") ==
+              3U);
+static_assert(detail::countPlaceholders(
+                  "SELECT '?', \"?\", [?], `?` FROM t WHERE a = ?") == 1U);
+static_assert(detail::countPlaceholders("SELECT 'it''s?' -- ?\n, ?") == 1U);
+static_assert(detail::countPlaceholders("SELECT /* ? */ ? /* ?") == 1U);
+static_assert(detail::countPlaceholders("SELECT a$b, 'x:y' FROM t") == 0U);
+static_assert(!detail::countPlaceholders("SELECT ?1").has_value());
+static_assert(!detail::countPlaceholders("SELECT :name").has_value());
+static_assert(!detail::countPlaceholders("SELECT @name, $name").has_value());
+static_assert(!detail::countPlaceholders("SELECT 'unterminated").has_value());
+
+TEST(TestingQueries, RunningTypedQueries) {
+  constexpr Query<"SELECT Name, Population FROM City WHERE ID = ?",
+                  Result<std::string, std::int64_t>, Params<std::int64_t>>
+      cityById;
+  constexpr Query<"SELECT Name FROM City WHERE CountryCode = ? AND "
+                  "Population > ? ORDER BY ID",
+                  Result<std::string>, Params<std::string_view, double>>
+      citiesOf;
+  static_assert(cityById.kParamsCount == 1U && cityById.kColumnsCount == 2U);
+  static_assert(std::same_as<decltype(cityById)::Row_type,
+                             std::tuple<std::string, std::int64_t>>);
+  static_assert(std::same_as<decltype(citiesOf)::Row_type, std::string>);
+
+  CrudWrapper const db{kprojectRootPath + "/db/world.db"};
+  using CityRow = std::tuple<std::string, std::int64_t>;
+  EXPECT_EQ(db.run(cityById, 1), (std::vector<CityRow>{{"Kabul", 1780000}}));
+  EXPECT_EQ(db.run(cityById, 5),
+            (std::vector<CityRow>{{"Amsterdam", 731200}}));
+  EXPECT_TRUE(db.run(cityById, -1).empty());
+  EXPECT_EQ(db.run(citiesOf, "NLD", 500000.0),
+            (std::vector<std::string>{"Amsterdam", "Rotterdam"}));
+
+  // the statement is prepared once, and then taken from the cache
+  auto const misses{db.statementCacheStats().misses};
+  db.run(cityById, 6);
+  EXPECT_EQ(db.statementCacheStats().misses, misses);
+
+  // result columns the statement doesn't have read no rows
+  constexpr Query<"SELECT Name FROM City WHERE ID = ?",
+                  Result<std::string, std::int64_t>, Params<std::int64_t>>
+      missingColumn;
+  EXPECT_TRUE(db.run(missingColumn, 1).empty());
+}
+
+TEST(TestingQueries, RunningTypedWrites) {
+  constexpr Query<"UPDATE City SET Population = ? WHERE ID = ?", Result<>,
+                  Params<std::optional<std::int64_t>, std::int64_t>>
+      setPopulation;
+  constexpr Query<"SELECT Population FROM City WHERE ID = ?",
+                  Result<std::optional<std::int64_t>>, Params<std::int64_t>>
+      populationOf;
+  constexpr Query<"INSERT INTO City (ID, Name) VALUES (?, ?)", Result<>,
+                  Params<std::int64_t, std::string>>
+      insertCity;
+
+  CrudWrapper db{copyDatabase("world.db", ktempPrefix)};
+  EXPECT_TRUE(db.run(setPopulation, 42, 1));
+  EXPECT_EQ(db.run(populationOf, 1),
+            std::vector<std::optional<std::int64_t>>{42});
+  EXPECT_TRUE(db.run(insertCity, 5000, "Typed"));
+  EXPECT_EQ(db.run(populationOf, 5000),
+            std::vector<std::optional<std::int64_t>>{0});
+
+  // constraint violations fail the write
+  EXPECT_FALSE(db.run(setPopulation, std::nullopt, 1));
+  EXPECT_FALSE(db.run(insertCity, 1, "Duplicate"));
+  EXPECT_EQ(db.run(populationOf, 1),
+            std::vector<std::optional<std::int64_t>>{42});
+}
+
+TEST(TestingQueries, TypedSchemaChangesDropCachedResults) {
+  constexpr Query<"ALTER TABLE City ADD COLUMN Extra INTEGER NOT NULL "
+                  "DEFAULT 0">
+      addColumn;
+
+  CrudWrapper db{copyDatabase("world.db", ktempPrefix)};
+  db.setResultCacheBudget(16U * 1024U * 1024U);
+  ASSERT_EQ(db.getRows("City").front().size(), 5U);
+  ASSERT_EQ(db.resultCacheStats().size, 1U);
+
+  EXPECT_TRUE(db.run(addColumn));
+  EXPECT_EQ(db.resultCacheStats().size, 0U);
+  EXPECT_EQ(db.getRows("City").front().size(), 6U);
+}
+
+} // namespace sql_with_cpp_test::query_test
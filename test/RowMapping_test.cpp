@@ -0,0 +1,122 @@
+#include "crud-wrapper/CrudWrapper.hpp"
+#include "TestUtils.hpp"
+
+#include "gtest/gtest.h"
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+/// @brief anonymous namespace for needed constants in thus TU
+namespace {
+/// @brief prefix of the databases copied by the tests of this TU
+const std::string ktempPrefix{"crud-wrapper-row-mapping-test-"};
+
+/// @brief a city of the world database
+struct City {
+  std::int64_t id{0};
+  std::string name;
+  std::string countryCode;
+  std::int64_t population{0};
+
+  auto operator==(City const &) const -> bool = default;
+};
+
+/// @brief a track of the album database, whose columns may be NULL
+struct Track {
+  std::int64_t id{0};
+  std::int64_t albumId{0};
+  std::optional<std::string> title;
+  std::optional<std::int64_t> duration;
+
+  auto operator==(Track const &) const -> bool = default;
+};
+
+} // namespace
+
+/// @brief mapping of cities to the City table, leaving District out
+template <> struct sql_with_cpp::RowMapping<City> {
+  static constexpr std::string_view kTable{"City"};
+  static constexpr std::tuple kFields{
+      Field<City, std::int64_t>{"ID", &City::id},
+      Field<City, std::string>{"Name", &City::name},
+      Field<City, std::string>{"CountryCode", &City::countryCode},
+      Field<City, std::int64_t>{"Population", &City::population}};
+};
+
+/// @brief mapping of tracks to the track table, whose columns names differ
+///        from the members names
+template <> struct sql_with_cpp::RowMapping<Track> {
+  static constexpr std::string_view kTable{"track"};
+  static constexpr std::tuple kFields{
+      Field<Track, std::int64_t>{"id", &Track::id},
+      Field<Track, std::int64_t>{"album_id", &Track::albumId},
+      Field<Track, std::optional<std::string>>{"title", &Track::title},
+      Field<Track, std::optional<std::int64_t>>{"duration", &Track::duration}};
+};
+
+/// @brief namespace for RowMapping tests
+namespace sql_with_cpp_test::rowMapping_test {
+using namespace ::sql_with_cpp;
+
+static_assert(MappedRow<City> && MappedRow<Track>);
+static_assert(!MappedRow<std::tuple<std::int64_t>>);
+
+TEST(TestingRowMapping, ReadingMappedStructs) {
+  CrudWrapper const db{kprojectRootPath + "/db/world.db"};
+  auto const cities{db.getRowsAs<City>()};
+  ASSERT_EQ(cities.size(), 4079U);
+  EXPECT_EQ(cities.front(), (City{1, "Kabul", "AFG", 1780000}));
+
+  // columns are resolved by name, whatever their order in the statement
+  auto statement{db.prepareStatement(
+      "SELECT Population, CountryCode, name, id FROM City WHERE ID = ?")};
+  statement.bind(5, 1U);
+  EXPECT_EQ(db.getRowsAs<City>(statement),
+            (std::vector<City>{{5, "Amsterdam", "NLD", 731200}}));
+
+  // statements missing a mapped column read no rows
+  EXPECT_TRUE(db.getRowsAs<City>(db.prepareStatement("SELECT ID, Name FROM "
+                                                     "City"))
+                  .empty());
+
+  CrudWrapper const albums{kprojectRootPath + "/db/album.db"};
+  auto const tracks{albums.getRowsAs<Track>()};
+  ASSERT_EQ(tracks.size(), 63U);
+  EXPECT_EQ(tracks.front(), (Track{1, 1, "Bright Lights Big City", 320}));
+}
+
+TEST(TestingRowMapping, WritingMappedStructs) {
+  CrudWrapper db{copyDatabase("album.db", ktempPrefix)};
+  auto const trackById{[&db](std::int64_t id) {
+    auto statement{db.prepareStatement("SELECT * FROM track WHERE id = ?")};
+    statement.bind(id, 1U);
+    return db.getRowsAs<Track>(statement);
+  }};
+
+  std::vector<Track> const inserted{{100, 1, "Inserted", std::nullopt},
+                                    {101, 1, std::nullopt, 42}};
+  EXPECT_TRUE(db.insertRows(inserted));
+  EXPECT_EQ(trackById(100), std::vector<Track>{inserted[0]});
+  EXPECT_EQ(trackById(101), std::vector<Track>{inserted[1]});
+
+  std::vector<Track> updated{inserted};
+  updated[0].title = "Updated";
+  updated[1].duration = std::nullopt;
+  EXPECT_TRUE(db.updateRows(updated));
+  EXPECT_EQ(trackById(100), std::vector<Track>{updated[0]});
+  EXPECT_EQ(trackById(101), std::vector<Track>{updated[1]});
+
+  // a missing row fails the whole update, which is rolled back
+  std::vector<Track> const partlyMissing{{100, 2, "Rolled back", 1},
+                                         {999, 2, "Missing", 1}};
+  EXPECT_FALSE(db.updateRows(partlyMissing));
+  EXPECT_EQ(trackById(100), std::vector<Track>{updated[0]});
+
+  // duplicate keys fail the insert
+  EXPECT_FALSE(db.insertRows(inserted));
+}
+
+} // namespace sql_with_cpp_test::rowMapping_test
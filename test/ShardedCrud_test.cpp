@@ -0,0 +1,179 @@
+#include "crud-wrapper/ShardedCrud.hpp"
+#include "TestUtils.hpp"
+
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <tuple>
+
+/// @brief anonymous namespace for needed constants in thus TU
+namespace {
+/// @brief a typed row of the City table
+using CityRow = std::tuple<std::int64_t, std::string, std::string,
+                           std::string, std::int64_t>;
+
+/// @brief statement creating the City table, as in world.db
+const std::string kcreateCityTable{
+    "CREATE TABLE City (ID INTEGER PRIMARY KEY, Name TEXT NOT NULL, "
+    "CountryCode TEXT NOT NULL, District TEXT NOT NULL, "
+    "Population INTEGER NOT NULL);"};
+
+/// @brief function to create empty databases in the temporary directory, to
+///        be used as shards
+/// @param shardsCount the number of databases to create
+/// @return paths to the created databases
+auto makeEmptyShards(std::size_t shardsCount)
+    -> std::vector<std::filesystem::path> {
+  std::vector<std::filesystem::path> paths;
+  for (std::size_t i{0U}; i < shardsCount; ++i) {
+    auto const path{std::filesystem::temp_directory_path() /
+                    ("sharded-crud-test-" + std::to_string(i) + ".db")};
+    sql_with_cpp_test::removeDatabase(path);
+
+    // CrudWrapper opens existing databases only
+    std::ofstream const file{path};
+    paths.push_back(path);
+  }
+
+  return paths;
+}
+
+/// @brief function to read all the rows of the City table of world.db
+/// @return the rows of the City table
+auto readWorldCities() -> std::vector<CityRow> {
+  sql_with_cpp::CrudWrapper const world{sql_with_cpp_test::kprojectRootPath +
+                                        "/db/world.db"};
+  return world.getRowsAs<CityRow>("City");
+}
+
+} // namespace
+
+/// @brief namespace for ShardedCrud tests
+namespace sql_with_cpp_test::shardedCrud_test {
+using namespace ::sql_with_cpp;
+
+TEST(TestingShardRouter, RoutingByHashAndByRange) {
+  EXPECT_THROW({ std::ignore = ShardRouter::byHash(0U); },
+               std::invalid_argument);
+  EXPECT_THROW(
+      {
+        std::ignore =
+            ShardRouter::byRange({std::int64_t{2}, std::int64_t{1}});
+      },
+      std::invalid_argument);
+
+  // hashes are fixed, so keys keep their shards across runs
+  auto const byHash{ShardRouter::byHash(4U)};
+  EXPECT_EQ(byHash.shardsCount(), 4U);
+  EXPECT_EQ(byHash.shardOf(std::int64_t{1}), 1U);
+  EXPECT_EQ(byHash.shardOf(std::string{"NLD"}), 1U);
+
+  std::vector<std::size_t> keysPerShard(4U, 0U);
+  for (std::int64_t key{0}; key < 4000; ++key) {
+    ++keysPerShard[byHash.shardOf(key)];
+  }
+  for (auto const keysCount : keysPerShard) {
+    EXPECT_GT(keysCount, 900U);
+  }
+
+  auto const byRange{ShardRouter::byRange(
+      {std::int64_t{100}, std::int64_t{200}, std::string{"M"}})};
+  EXPECT_EQ(byRange.shardsCount(), 4U);
+  EXPECT_EQ(byRange.shardOf(std::int64_t{-5}), 0U);
+  EXPECT_EQ(byRange.shardOf(std::int64_t{100}), 1U);
+  EXPECT_EQ(byRange.shardOf(std::int64_t{1'000'000}), 2U);
+  EXPECT_EQ(byRange.shardOf(std::string{"A"}), 2U);
+  EXPECT_EQ(byRange.shardOf(std::string{"M"}), 3U);
+}
+
+TEST(TestingShardedCrud, ConstructingShardedCrud) {
+  EXPECT_THROW(
+      { ShardedCrud(makeEmptyShards(2U), ShardRouter::byHash(3U)); },
+      std::invalid_argument);
+  EXPECT_THROW(
+      {
+        ShardedCrud({"/non/existing/path"}, ShardRouter::byHash(1U));
+      },
+      std::filesystem::filesystem_error);
+}
+
+TEST(TestingShardedCrud, RowsAreRoutedByKeyAndReadFromAllShards) {
+  auto const cities{readWorldCities()};
+  ShardedCrud sharded{makeEmptyShards(3U), ShardRouter::byHash(3U)};
+  ASSERT_TRUE(sharded.executeStatements(kcreateCityTable));
+  EXPECT_EQ(sharded.peekColumnsNames("City"),
+            (std::vector<std::string>{"ID", "Name", "CountryCode", "District",
+                                      "Population"}));
+
+  // cities of the same country share a shard
+  ASSERT_TRUE(sharded.bulkInsert("City", {}, cities, [](CityRow const &city) {
+    return std::get<2>(city);
+  }));
+  std::size_t rowsCount{0U};
+  for (std::size_t i{0U}; i < sharded.shardsCount(); ++i) {
+    auto const countries{sharded.shard(i).getRowsAs<std::string>(
+        sharded.shard(i).prepareStatement(
+            "SELECT DISTINCT CountryCode FROM City"))};
+    EXPECT_FALSE(countries.empty());
+    for (auto const &country : countries) {
+      EXPECT_EQ(sharded.router().shardOf(country), i) << country;
+    }
+    rowsCount += sharded.shard(i).getRowsAs<CityRow>("City").size();
+  }
+  EXPECT_EQ(rowsCount, cities.size());
+
+  auto const rows{sharded.getRows("City")};
+  ASSERT_EQ(rows.size(), cities.size() + 1U);
+  EXPECT_EQ(rows.front(), sharded.peekColumnsNames("City"));
+
+  auto allCities{sharded.getRowsAs<CityRow>("SELECT * FROM City")};
+  std::ranges::sort(allCities);
+  EXPECT_EQ(allCities, cities);
+
+  // routed writes touch the shard of their key only
+  ASSERT_TRUE(sharded.executeStatements(
+      ShardKey_type{"NLD"},
+      "UPDATE City SET Population = 0 WHERE CountryCode = 'NLD';"));
+  std::vector<std::int64_t> expectedCounts(sharded.shardsCount(), 0);
+  expectedCounts[sharded.router().shardOf(std::string{"NLD"})] = 28;
+  EXPECT_EQ(sharded.getRowsAs<std::int64_t>(
+                "SELECT COUNT(*) FROM City WHERE Population = 0"),
+            expectedCounts);
+}
+
+TEST(TestingShardedCrud, MergedReadsKeepTheOrderOfTheWholeDataset) {
+  auto const cities{readWorldCities()};
+  ShardedCrud sharded{
+      makeEmptyShards(3U),
+      ShardRouter::byRange({std::int64_t{1000}, std::int64_t{3000}})};
+  ASSERT_TRUE(sharded.executeStatements(kcreateCityTable));
+  ASSERT_TRUE(sharded.bulkInsert("City", {}, cities, [](CityRow const &city) {
+    return std::get<0>(city);
+  }));
+
+  EXPECT_EQ(sharded.getRowsAs<std::int64_t>("SELECT COUNT(*) FROM City"),
+            (std::vector<std::int64_t>{999, 2000, 1080}));
+
+  // each shard reads its own first rows, which get merged into the first
+  // rows of the whole dataset
+  auto const mostPopulated{sharded.getMergedRowsAs<CityRow>(
+      "SELECT * FROM City ORDER BY Population DESC LIMIT 10", 10U,
+      std::ranges::greater{}, [](CityRow const &city) {
+        return std::get<4>(city);
+      })};
+  auto expected{cities};
+  std::ranges::sort(expected, std::ranges::greater{},
+                    [](CityRow const &city) { return std::get<4>(city); });
+  expected.resize(10U);
+  EXPECT_EQ(mostPopulated, expected);
+
+  // without a limit, all the rows are merged
+  auto const names{sharded.getMergedRowsAs<std::string>(
+      "SELECT Name FROM City ORDER BY Name")};
+  EXPECT_EQ(names.size(), cities.size());
+  EXPECT_TRUE(std::ranges::is_sorted(names));
+}
+
+} // namespace sql_with_cpp_test::shardedCrud_test
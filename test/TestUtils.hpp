@@ -0,0 +1,37 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+/// @brief namespace for the tests of SQL with c++
+namespace sql_with_cpp_test {
+
+/// @brief path to the root of this project
+inline const std::string kprojectRootPath{PROJECT_ROOT_PATH};
+
+/// @brief function to remove a database from the temporary directory, along
+///        with its WAL, shared memory and rollback journal files
+/// @param path path to the database
+inline void removeDatabase(std::filesystem::path const &path) {
+  for (auto const *suffix : {"", "-wal", "-shm", "-journal"}) {
+    std::filesystem::remove(path.string() + suffix);
+  }
+}
+
+/// @brief function to copy a database of the project into the temporary
+///        directory, for tests that write to it or change its settings
+/// @param dbName the name of the database to copy
+/// @param prefix prefix of the name of the copy, which keeps the copies of
+///               different test files apart
+/// @return path to the copied database
+inline auto copyDatabase(std::string const &dbName,
+                         std::string const &prefix) -> std::filesystem::path {
+  auto const copyPath{std::filesystem::temp_directory_path() /
+                      (prefix + dbName)};
+  removeDatabase(copyPath);
+
+  std::filesystem::copy_file(kprojectRootPath + "/db/" + dbName, copyPath);
+  return copyPath;
+}
+
+} // namespace sql_with_cpp_test
@@ -0,0 +1,170 @@
+#include "crud-wrapper/WriteQueue.hpp"
+#include "TestUtils.hpp"
+
+#include "gtest/gtest.h"
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// @brief anonymous namespace for needed constants in thus TU
+namespace {
+/// @brief function to create a database in the temporary directory, holding
+///        an empty table of events
+/// @param dbName the name of the database to create
+/// @return path to the created database
+auto makeEventsDatabase(std::string const &dbName) -> std::filesystem::path {
+  auto const path{std::filesystem::temp_directory_path() /
+                  ("crud-wrapper-write-queue-test-" + dbName)};
+  sql_with_cpp_test::removeDatabase(path);
+
+  // CrudWrapper opens existing databases only
+  std::ofstream const file{path};
+  sql_with_cpp::CrudWrapper db{path};
+  db.executeStatements(
+      "CREATE TABLE Event (ID INTEGER PRIMARY KEY, Source INTEGER);");
+
+  return path;
+}
+
+/// @brief function to count the events of a database
+/// @param path path to the database
+/// @return the number of events
+auto eventsCount(std::filesystem::path const &path) -> std::int64_t {
+  sql_with_cpp::CrudWrapper const db{path};
+  auto const counts{db.getRowsAs<std::int64_t>(
+      db.prepareStatement("SELECT COUNT(*) FROM Event"))};
+  return counts.empty() ? -1 : counts.front();
+}
+
+} // namespace
+
+/// @brief namespace for WriteQueue tests
+namespace sql_with_cpp_test::writeQueue_test {
+using namespace ::sql_with_cpp;
+
+TEST(TestingWriteQueue, ConstructingWriteQueue) {
+  EXPECT_THROW(
+      { WriteQueue{"/non/existing/path"}; },
+      std::filesystem::filesystem_error);
+  EXPECT_THROW(
+      {
+        WriteQueue(makeEventsDatabase("construct.db"),
+                   WriteQueueOptions{.maxBatchSize = 0U,
+                                     .maxLatency = std::chrono::hours{0}});
+      },
+      std::invalid_argument);
+}
+
+TEST(TestingWriteQueue, OperationsAreCommittedInBatches) {
+  auto const dbPath{makeEventsDatabase("batches.db")};
+
+  // batches are closed by their size long before their deadline
+  {
+    WriteQueue queue{dbPath,
+                     WriteQueueOptions{.maxBatchSize = 50U,
+                                       .maxLatency = std::chrono::hours{1}}};
+    std::vector<std::future<bool>> outcomes;
+    for (auto i{0}; i < 100; ++i) {
+      outcomes.push_back(queue.submit(
+          "INSERT INTO Event (Source) VALUES (" + std::to_string(i) + ");"));
+    }
+    for (auto &outcome : outcomes) {
+      EXPECT_TRUE(outcome.get());
+    }
+
+    auto const stats{queue.stats()};
+    EXPECT_EQ(stats.operationsCount, 100U);
+    EXPECT_EQ(stats.batchesCount, 2U);
+    EXPECT_EQ(stats.largestBatchSize, 50U);
+    EXPECT_EQ(stats.failedOperationsCount, 0U);
+  }
+  EXPECT_EQ(eventsCount(dbPath), 100);
+
+  // a lonely operation is committed once its deadline passes
+  {
+    WriteQueue queue{
+        dbPath, WriteQueueOptions{.maxBatchSize = 50U,
+                                  .maxLatency = std::chrono::milliseconds{1}}};
+    EXPECT_TRUE(queue.submit("INSERT INTO Event (Source) VALUES (100);").get());
+    EXPECT_EQ(queue.stats().batchesCount, 1U);
+  }
+
+  // pending operations are committed on destruction without waiting
+  std::future<bool> pending;
+  {
+    WriteQueue queue{dbPath,
+                     WriteQueueOptions{.maxBatchSize = 50U,
+                                       .maxLatency = std::chrono::hours{1}}};
+    pending = queue.submit("INSERT INTO Event (Source) VALUES (101);");
+  }
+  EXPECT_TRUE(pending.get());
+  EXPECT_EQ(eventsCount(dbPath), 102);
+}
+
+TEST(TestingWriteQueue, FailuresAreAttributedToTheirOperations) {
+  auto const dbPath{makeEventsDatabase("failures.db")};
+
+  {
+    WriteQueue queue{dbPath,
+                     WriteQueueOptions{.maxBatchSize = 4U,
+                                       .maxLatency = std::chrono::hours{1}}};
+    auto first{queue.submit("INSERT INTO Event VALUES (1, 0);")};
+    // the first statement of a failing operation is rolled back as well
+    auto duplicate{queue.submit("INSERT INTO Event VALUES (2, 0);"
+                                "INSERT INTO Event VALUES (1, 0);")};
+    auto throwing{queue.submit([](CrudWrapper &db) -> bool {
+      db.executeStatements("INSERT INTO Event VALUES (3, 0);");
+      throw std::runtime_error("failing operation");
+    })};
+    auto last{queue.submit([](CrudWrapper &db) {
+      return db.executeStatements("INSERT INTO Event VALUES (4, 0);");
+    })};
+
+    EXPECT_TRUE(first.get());
+    EXPECT_FALSE(duplicate.get());
+    EXPECT_THROW(throwing.get(), std::runtime_error);
+    EXPECT_TRUE(last.get());
+
+    auto const stats{queue.stats()};
+    EXPECT_EQ(stats.batchesCount, 1U);
+    EXPECT_EQ(stats.failedOperationsCount, 2U);
+  }
+
+  CrudWrapper const db{dbPath};
+  EXPECT_EQ(db.getRowsAs<int>(db.prepareStatement("SELECT ID FROM Event")),
+            (std::vector<int>{1, 4}));
+}
+
+TEST(TestingWriteQueue, ConcurrentWritersShareCommits) {
+  auto const dbPath{makeEventsDatabase("concurrent.db")};
+  constexpr auto threadsCount{8};
+  constexpr auto writesPerThread{50};
+
+  {
+    WriteQueue queue{dbPath};
+    std::vector<std::jthread> threads;
+    for (auto i{0}; i < threadsCount; ++i) {
+      threads.emplace_back([&queue, i] {
+        for (auto j{0}; j < writesPerThread; ++j) {
+          EXPECT_TRUE(queue
+                          .submit("INSERT INTO Event (Source) VALUES (" +
+                                  std::to_string(i) + ");")
+                          .get());
+        }
+      });
+    }
+    threads.clear();
+
+    auto const stats{queue.stats()};
+    EXPECT_EQ(stats.operationsCount, threadsCount * writesPerThread);
+    EXPECT_LE(stats.batchesCount, stats.operationsCount);
+  }
+  EXPECT_EQ(eventsCount(dbPath), threadsCount * writesPerThread);
+}
+
+} // namespace sql_with_cpp_test::writeQueue_test